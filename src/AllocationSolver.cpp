@@ -0,0 +1,170 @@
+#include "AllocationSolver.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include "GameConstants.h"
+#include "JobSystem.h"
+
+AllocationSolver::AllocationSolver(float inputFactor)
+    : m_inputFactor(inputFactor)
+{
+}
+
+void AllocationSolver::Reserve(size_t count)
+{
+    m_production.reserve(count);
+    m_priority.reserve(count);
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        m_inputRate[r].reserve(count);
+        m_outputRate[r].reserve(count);
+    }
+}
+
+void AllocationSolver::Request(const Building &building, float production)
+{
+    m_production.push_back(0.0f);
+    m_priority.push_back(0);
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        m_inputRate[r].push_back(0.0f);
+        m_outputRate[r].push_back(0.0f);
+    }
+    Set(m_production.size() - 1, building, production);
+}
+
+void AllocationSolver::Resize(size_t count)
+{
+    m_production.assign(count, 0.0f);
+    m_priority.assign(count, 0);
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        m_inputRate[r].assign(count, 0.0f);
+        m_outputRate[r].assign(count, 0.0f);
+    }
+}
+
+void AllocationSolver::Set(size_t request, const Building &building, float production)
+{
+    m_production[request] = std::max(production, 0.0f);
+    m_priority[request] = building.GetPriority();
+    for (auto const &req : building.GetInputResources())
+        m_inputRate[static_cast<size_t>(req.GetType())][request] += req.GetProductionRate() * m_inputFactor;
+    for (auto const &out : building.GetOutputResources())
+        m_outputRate[static_cast<size_t>(out.GetType())][request] += out.GetProductionRate();
+}
+
+void AllocationSolver::Resolve(ResourceLedger &ledger)
+{
+    const size_t count = m_production.size();
+    m_granted.assign(count, 0.0f);
+    if (count == 0)
+        return;
+
+    using Totals = std::array<float, RESOURCE_TYPE_COUNT>;
+    const size_t grain = GameConstants::BUILDING_CHUNK_SIZE;
+    const size_t chunks = (count + grain - 1) / grain;
+    std::vector<Totals> partial(chunks);
+    JobSystem &jobs = JobSystem::GetDefault();
+
+    // Sums each chunk's totals in chunk order
+    auto reduce = [&partial]()
+    {
+        Totals total{};
+        for (const auto &chunk : partial)
+        {
+            for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                total[r] += chunk[r];
+        }
+        return total;
+    };
+
+    Totals supply;
+    Totals consumed{};
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        supply[r] = ledger.Get(static_cast<ResourceType>(r));
+
+    // Priority tiers, highest first; equal priority shares proportionally
+    std::vector<int> tiers;
+    for (int priority : m_priority)
+    {
+        if (std::find(tiers.begin(), tiers.end(), priority) == tiers.end())
+            tiers.push_back(priority);
+    }
+    std::sort(tiers.begin(), tiers.end(), std::greater<int>());
+
+    // Totals are dot products over one resource row within a chunk
+    auto dot = [](const std::vector<float> &a, const std::vector<float> &b, size_t first, size_t last)
+    {
+        return std::inner_product(a.begin() + first, a.begin() + last, b.begin() + first, 0.0f);
+    };
+
+    std::vector<float> want(count);
+    std::vector<float> share(count);
+    for (int tier : tiers)
+    {
+        // Demand of this tier per resource
+        jobs.ParallelFor(count, grain, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                want[i] = m_priority[i] == tier ? m_production[i] : 0.0f;
+            Totals &demand = partial[begin / grain];
+            for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                demand[r] = dot(want, m_inputRate[r], begin, end);
+        });
+        Totals demand = reduce();
+
+        // Fraction of this tier's demand the remaining supply can cover
+        Totals fill;
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            fill[r] = demand[r] > 0.0f ? std::min(supply[r] / demand[r], 1.0f) : 1.0f;
+
+        // A building runs at the share of its scarcest input
+        jobs.ParallelFor(count, grain, [&](size_t begin, size_t end)
+        {
+            std::fill(share.begin() + begin, share.begin() + end, 1.0f);
+            for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            {
+                if (demand[r] <= 0.0f)
+                    continue;
+                const auto &rate = m_inputRate[r];
+                for (size_t i = begin; i < end; ++i)
+                    share[i] = rate[i] > 0.0f ? std::min(share[i], fill[r]) : share[i];
+            }
+            for (size_t i = begin; i < end; ++i)
+            {
+                want[i] *= share[i];
+                m_granted[i] += want[i];
+            }
+            Totals &used = partial[begin / grain];
+            for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                used[r] = dot(want, m_inputRate[r], begin, end);
+        });
+        Totals used = reduce();
+
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            used[r] = std::min(used[r], supply[r]);
+            supply[r] -= used[r];
+            consumed[r] += used[r];
+        }
+    }
+
+    jobs.ParallelFor(count, grain, [&](size_t begin, size_t end)
+    {
+        Totals &produced = partial[begin / grain];
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            produced[r] = dot(m_granted, m_outputRate[r], begin, end);
+    });
+    Totals produced = reduce();
+
+    // Apply every input draw and output deposit for the stage at once
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        auto type = static_cast<ResourceType>(r);
+        if (consumed[r] > 0.0f)
+            ledger.ConsumeUpTo(type, consumed[r]);
+        if (produced[r] > 0.0f)
+            ledger.Add(type, produced[r]);
+    }
+}
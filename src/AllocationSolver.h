@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "Building.h"
+#include "ResourceLedger.h"
+
+// Shares contended inputs between the buildings of one production stage.
+// Every building first requests the production it could reach this tick;
+// Resolve() then sums the demand per resource, grants each priority tier
+// (highest first) a proportional share of what is left, and applies all
+// consumption and outputs to the pool in a single sweep. No building is
+// starved just because it sits later in the building list.
+//
+// Large stages are resolved in fixed chunks of requests on the job system;
+// per-chunk totals are summed in chunk order, so the outcome does not
+// depend on how many threads took part.
+class AllocationSolver
+{
+public:
+    // inputFactor scales input draw relative to production
+    // (Building::FUEL_CONSUMPTION_FACTOR for the per-frame fuel burn)
+    explicit AllocationSolver(float inputFactor = 1.0f);
+
+    void Reserve(size_t count);
+    void Request(const Building &building, float production);
+
+    // Sizes the solver for `count` requests to be filled in with Set(), each
+    // exactly once; distinct requests may be set from different threads
+    void Resize(size_t count);
+    void Set(size_t request, const Building &building, float production);
+
+    void Resolve(ResourceLedger &ledger);
+
+    size_t GetRequestCount() const { return m_production.size(); }
+
+    // Production actually granted to a request after Resolve()
+    float GetGranted(size_t request) const { return m_granted[request]; }
+
+private:
+    float m_inputFactor;
+    std::vector<float> m_production;
+    std::vector<float> m_granted;
+    std::vector<int> m_priority;
+
+    // Per-resource rows with one column per request (zero where unused),
+    // so demand and output totals are plain dot products
+    std::array<std::vector<float>, RESOURCE_TYPE_COUNT> m_inputRate;
+    std::array<std::vector<float>, RESOURCE_TYPE_COUNT> m_outputRate;
+};
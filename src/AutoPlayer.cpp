@@ -0,0 +1,828 @@
+#include "AutoPlayer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include "ProductionBonus.h"
+#include "ProductionGraph.h"
+#include "ProductionRng.h"
+
+namespace
+{
+    // Fuel kept on hand per owned building that pays for it
+    constexpr float FUEL_RESERVE_SECONDS = 120.0f;
+    // Holdings are sold once they exceed the reserve by half, and topped
+    // up once they fall below half of it
+    constexpr float SELL_ABOVE = 1.5f;
+    constexpr float BUY_BELOW = 0.5f;
+    // Share of the money fuel purchases may take
+    constexpr float FUEL_BUDGET = 0.5f;
+    // Trades worth less than this are not worth an order
+    constexpr float MIN_TRADE_VALUE = 5.0f;
+    // Never sells quite everything: the fill comes after a tick of burning
+    constexpr float MAX_SELL_SHARE = 0.99f;
+
+    // Greedy saves up for a better action it can afford within this many
+    // decisions instead of taking the best one it can afford now
+    constexpr float SAVING_DECISIONS = 4.0f;
+
+    // Search: UCB1 exploration weight on values scaled to [0, 1], and the
+    // share of random actions in playouts (the rest follow greedy)
+    constexpr double EXPLORATION_WEIGHT = 0.7;
+    constexpr float PLAYOUT_RANDOMNESS = 0.25f;
+
+    constexpr size_t MONEY = static_cast<size_t>(ResourceType::MONEY);
+}
+
+PlanState PlanModel::Observe(const Player &player, const MarketState &market)
+{
+    PlanState state;
+    m_buildings.clear();
+    m_productions = {};
+    std::vector<const Building *> observed;
+    for (const auto &building : player.buildings)
+        if (building && m_buildings.size() < PlanState::MAX_BUILDINGS)
+        {
+            ObserveBuilding(*building, state);
+            observed.push_back(building.get());
+        }
+    ObserveStages(observed);
+    for (const auto &production : player.productions)
+        if (production)
+            ObserveProduction(*production);
+
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        state.amounts[r] = player.ledger.Get(static_cast<ResourceType>(r));
+    state.reputation = player.reputation;
+    state.market = market;
+
+    // Running jobs come first within each type
+    player.jobs.ForEachJob([&](const ProductionQueue::Job &job, float elapsed)
+    {
+        PlanState::JobLane &lane = state.jobs[static_cast<size_t>(job.type)];
+        if (lane.running < player.jobs.GetRunningCount(job.type) && lane.running < PlanState::MAX_RUNNING_JOBS)
+            lane.remaining[lane.running++] = std::max(job.duration - elapsed, 0.0f);
+        else
+            ++lane.queued;
+    });
+    return state;
+}
+
+PlanState PlanModel::Observe(const GameSnapshot &snapshot)
+{
+    PlanState state;
+    m_buildings.clear();
+    m_productions = {};
+    std::vector<const Building *> observed;
+    for (const auto &building : snapshot.buildings)
+        if (m_buildings.size() < PlanState::MAX_BUILDINGS)
+        {
+            ObserveBuilding(building, state);
+            observed.push_back(&building);
+        }
+    ObserveStages(observed);
+    for (const auto &production : snapshot.productions)
+        ObserveProduction(production);
+
+    state.time = snapshot.gameTime;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        state.amounts[r] = snapshot.ledger.Get(static_cast<ResourceType>(r));
+    state.reputation = snapshot.reputation;
+    state.market = snapshot.market;
+
+    // The snapshot only has the progress of the leading job; the others
+    // started later and are taken as just started
+    for (size_t p = 0; p < PRODUCTION_TYPE_COUNT; ++p)
+    {
+        const GameSnapshot::JobSummary &summary = snapshot.jobs[p];
+        PlanState::JobLane &lane = state.jobs[p];
+        const float duration = m_productions[p].duration;
+        lane.running = static_cast<uint32_t>(std::min(summary.running, PlanState::MAX_RUNNING_JOBS));
+        for (uint32_t i = 0; i < lane.running; ++i)
+            lane.remaining[i] = i == 0 ? (1.0f - summary.progress) * duration : duration;
+        lane.queued = static_cast<uint32_t>(summary.queued);
+    }
+    return state;
+}
+
+void PlanModel::ObserveBuilding(const Building &building, PlanState &state)
+{
+    if (m_buildings.size() == PlanState::MAX_BUILDINGS)
+        return;
+
+    BuildingDefinition definition;
+    definition.type = building.GetType();
+    definition.buildable = std::none_of(m_buildings.begin(), m_buildings.end(),
+                                        [&](const BuildingDefinition &other)
+                                        { return other.type == definition.type; });
+    definition.cost = building.GetCost();
+    definition.requiredReputation = building.GetRequiredReputation();
+    definition.partialStarvation = building.GetPartialStarvationFactor();
+    definition.fullStarvation = building.GetFullStarvationFactor();
+    for (const auto &in : building.GetInputResources())
+        definition.inputs.push_back(in.GetType());
+    for (const auto &out : building.GetOutputResources())
+        definition.outputs.push_back(out.GetType());
+    m_buildings.push_back(std::move(definition));
+
+    PlanState::Slot &slot = state.buildings[state.buildingCount++];
+    slot.owned = building.IsOwned() && building.IsOperational();
+    slot.level = building.GetLevel();
+    slot.efficiency = building.GetEfficiency();
+    slot.rate = building.GetBaseProductionRate();
+    slot.maintenance = building.GetMaintenanceCost();
+    slot.upgradeCost = building.GetUpgradeCost();
+}
+
+void PlanModel::ObserveStages(const std::vector<const Building *> &buildings)
+{
+    // The game's own graph, over every slot as if owned: a plan may build
+    // any of them, and unowned ones are skipped when the stage runs
+    std::vector<std::unique_ptr<Building>> all;
+    all.reserve(buildings.size());
+    for (const Building *building : buildings)
+    {
+        all.push_back(std::make_unique<Building>(*building));
+        all.back()->SetOwned(true);
+        all.back()->SetOperational(true);
+    }
+    ProductionGraph graph;
+    graph.Rebuild(all);
+
+    m_stages.clear();
+    for (const ProductionGraph::Subgraph &subgraph : graph.GetSubgraphs())
+        for (const ProductionGraph::Stage &stage : subgraph)
+            m_stages.push_back(stage);
+}
+
+void PlanModel::ObserveProduction(const Production &production)
+{
+    ProductionDefinition &definition = m_productions[static_cast<size_t>(production.GetType())];
+    definition.available = true;
+    definition.cost = production.GetCost();
+    definition.duration = production.GetCompletionTime();
+    definition.payout = production.GetCompletionAmount();
+    definition.requiredReputation = production.GetRequiredReputation();
+    for (const auto &in : production.GetInputs())
+        definition.inputs.emplace_back(in.type, in.quantity);
+    for (const auto &out : production.GetOutputs())
+        if (out.type != ResourceType::MONEY && out.quantity > 0.0f)
+            definition.outputs.emplace_back(out.type, out.quantity);
+}
+
+bool PlanModel::IsAllowed(const PlanState &state, PlanAction action) const
+{
+    const float money = state.amounts[MONEY];
+    switch (action.type)
+    {
+    case PlanAction::Type::WAIT:
+        return true;
+    case PlanAction::Type::BUILD:
+    {
+        if (action.target < 0 || static_cast<size_t>(action.target) >= m_buildings.size())
+            return false;
+        const BuildingDefinition &definition = m_buildings[action.target];
+        return definition.buildable && !state.buildings[action.target].owned &&
+               money >= definition.cost && state.reputation >= definition.requiredReputation;
+    }
+    case PlanAction::Type::UPGRADE:
+    {
+        if (action.target < 0 || static_cast<size_t>(action.target) >= m_buildings.size())
+            return false;
+        const PlanState::Slot &slot = state.buildings[action.target];
+        return slot.owned && slot.level < Building::MAX_LEVEL && money >= slot.upgradeCost;
+    }
+    case PlanAction::Type::BEGIN_PRODUCTION:
+    {
+        if (action.target < 0 || static_cast<size_t>(action.target) >= PRODUCTION_TYPE_COUNT)
+            return false;
+        const ProductionDefinition &definition = m_productions[action.target];
+        if (!definition.available || money < definition.cost || state.reputation < definition.requiredReputation)
+            return false;
+        for (const auto &[type, amount] : definition.inputs)
+            if (state.amounts[static_cast<size_t>(type)] < amount)
+                return false;
+        return true;
+    }
+    }
+    return false;
+}
+
+void PlanModel::ListActions(const PlanState &state, std::vector<PlanAction> &actions) const
+{
+    actions.clear();
+    actions.push_back({});
+    for (size_t slot = 0; slot < m_buildings.size(); ++slot)
+    {
+        PlanAction build{PlanAction::Type::BUILD, static_cast<int>(slot)};
+        if (IsAllowed(state, build))
+            actions.push_back(build);
+        PlanAction upgrade{PlanAction::Type::UPGRADE, static_cast<int>(slot)};
+        if (IsAllowed(state, upgrade))
+            actions.push_back(upgrade);
+    }
+    for (size_t p = 0; p < PRODUCTION_TYPE_COUNT; ++p)
+    {
+        PlanAction begin{PlanAction::Type::BEGIN_PRODUCTION, static_cast<int>(p)};
+        if (IsAllowed(state, begin))
+            actions.push_back(begin);
+    }
+}
+
+bool PlanModel::Apply(PlanState &state, PlanAction action) const
+{
+    if (!IsAllowed(state, action))
+        return false;
+
+    float &money = state.amounts[MONEY];
+    switch (action.type)
+    {
+    case PlanAction::Type::WAIT:
+        break;
+    case PlanAction::Type::BUILD:
+    {
+        // Same starter fuel as Player::BuildStructure
+        constexpr float STARTER_FUEL = 20.0f;
+        const BuildingDefinition &definition = m_buildings[action.target];
+        money -= definition.cost;
+        state.buildings[action.target].owned = true;
+        for (ResourceType in : definition.inputs)
+            state.amounts[static_cast<size_t>(in)] += STARTER_FUEL;
+        break;
+    }
+    case PlanAction::Type::UPGRADE:
+    {
+        constexpr float UPGRADE_MULTIPLIER = 1.5f; // as Building::Upgrade
+        PlanState::Slot &slot = state.buildings[action.target];
+        money -= slot.upgradeCost;
+        slot.level++;
+        slot.rate *= UPGRADE_MULTIPLIER;
+        slot.maintenance *= UPGRADE_MULTIPLIER;
+        slot.upgradeCost *= UPGRADE_MULTIPLIER;
+        break;
+    }
+    case PlanAction::Type::BEGIN_PRODUCTION:
+    {
+        const ProductionDefinition &definition = m_productions[action.target];
+        money -= definition.cost;
+        for (const auto &[type, amount] : definition.inputs)
+            state.amounts[static_cast<size_t>(type)] -= amount;
+        PlanState::JobLane &lane = state.jobs[action.target];
+        if (lane.running < PlanState::MAX_RUNNING_JOBS)
+            lane.remaining[lane.running++] = definition.duration;
+        else
+            ++lane.queued;
+        break;
+    }
+    }
+    return true;
+}
+
+float PlanModel::GetMultiplier(const PlanState &state) const
+{
+    float multiplier = GameConstants::BASE_PRODUCTION_MULTIPLIER + state.reputation * GameConstants::REPUTATION_BONUS_MULTIPLIER;
+    for (size_t slot = 0; slot < m_buildings.size(); ++slot)
+        if (state.buildings[slot].owned && m_buildings[slot].type == BuildingType::RESEARCH_LAB)
+            multiplier += GameConstants::RESEARCH_LAB_BONUS_MULTIPLIER * state.buildings[slot].level;
+    return std::max(multiplier, GameConstants::BASE_PRODUCTION_MULTIPLIER);
+}
+
+// Units of each input a building draws per second at full efficiency: the
+// per-frame fuel burn (none without outputs) plus the periodic resource draw
+float PlanModel::GetFuelRate(const PlanState &state, size_t slot, float multiplier) const
+{
+    const BuildingDefinition &definition = m_buildings[slot];
+    const PlanState::Slot &building = state.buildings[slot];
+    float burn = definition.outputs.empty()
+                     ? 0.0f
+                     : GetExpectedProductionBonus(definition.type, building.level) * Building::FUEL_CONSUMPTION_FACTOR;
+    return building.rate * (burn + multiplier);
+}
+
+float PlanModel::GetMargin(const PlanState &state, size_t slot, float multiplier) const
+{
+    const BuildingDefinition &definition = m_buildings[slot];
+    const PlanState::Slot &building = state.buildings[slot];
+
+    float margin = 0.0f;
+    if (!definition.outputs.empty())
+    {
+        float perUnit = building.rate * (GetExpectedProductionBonus(definition.type, building.level) + multiplier);
+        for (ResourceType out : definition.outputs)
+            margin += perUnit * state.market.GetQuotedPrice(out);
+    }
+    const float fuel = GetFuelRate(state, slot, multiplier);
+    for (ResourceType in : definition.inputs)
+        margin -= fuel * state.market.GetQuotedPrice(in);
+    return margin - building.maintenance / GameConstants::MAINTENANCE_UPDATE_INTERVAL;
+}
+
+float PlanModel::GetProductionProfit(const PlanState &state, ProductionType type) const
+{
+    const ProductionDefinition &definition = m_productions[static_cast<size_t>(type)];
+    if (!definition.available)
+        return 0.0f;
+    float profit = definition.payout - definition.cost;
+    for (const auto &[resource, amount] : definition.inputs)
+        profit -= amount * state.market.GetQuotedPrice(resource);
+    for (const auto &[resource, amount] : definition.outputs)
+        profit += amount * state.market.GetQuotedPrice(resource);
+    return profit;
+}
+
+void PlanModel::Rebalance(PlanState &state, std::vector<MarketOrder> &orders) const
+{
+    const float multiplier = GetMultiplier(state);
+    std::array<float, RESOURCE_TYPE_COUNT> reserve{};
+    for (size_t slot = 0; slot < m_buildings.size(); ++slot)
+    {
+        if (!state.buildings[slot].owned)
+            continue;
+        // The Research Lab earns through everyone else's multiplier
+        if (!m_buildings[slot].outputs.empty() && GetMargin(state, slot, multiplier) <= 0.0f)
+            continue;
+        const float fuel = GetFuelRate(state, slot, multiplier) * FUEL_RESERVE_SECONDS;
+        for (ResourceType in : m_buildings[slot].inputs)
+            reserve[static_cast<size_t>(in)] += fuel;
+    }
+    for (size_t p = 0; p < PRODUCTION_TYPE_COUNT; ++p)
+    {
+        const ProductionDefinition &definition = m_productions[p];
+        if (!definition.available || state.reputation < definition.requiredReputation ||
+            GetProductionProfit(state, static_cast<ProductionType>(p)) <= 0.0f)
+            continue;
+        for (const auto &[type, amount] : definition.inputs)
+            reserve[static_cast<size_t>(type)] += amount;
+    }
+
+    float &money = state.amounts[MONEY];
+    float budget = money * FUEL_BUDGET;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        if (r == MONEY)
+            continue;
+        const ResourceType type = static_cast<ResourceType>(r);
+        float &amount = state.amounts[r];
+        if (amount > reserve[r] * SELL_ABOVE)
+        {
+            float quantity = std::min(amount - reserve[r], amount * MAX_SELL_SHARE);
+            float proceeds = state.market.QuoteSell(type, quantity);
+            if (proceeds < MIN_TRADE_VALUE)
+                continue;
+            orders.push_back({type, quantity, OrderSide::SELL});
+            state.market.ApplySell(type, quantity);
+            amount -= quantity;
+            money += proceeds;
+        }
+        else if (amount < reserve[r] * BUY_BELOW)
+        {
+            float quantity = reserve[r] - amount;
+            float cost = state.market.QuoteBuy(type, quantity);
+            if (cost < MIN_TRADE_VALUE || cost > budget)
+                continue;
+            orders.push_back({type, quantity, OrderSide::BUY});
+            state.market.ApplyBuy(type, quantity);
+            amount += quantity;
+            money -= cost;
+            budget -= cost;
+        }
+    }
+}
+
+void PlanModel::Advance(PlanState &state, float seconds) const
+{
+    constexpr float STEP = 1.0f;
+    const size_t count = m_buildings.size();
+    std::array<float, PlanState::MAX_BUILDINGS> activity{};
+    std::array<float, PlanState::MAX_BUILDINGS> fuel{};
+
+    // One stage's draw of `fuelPerUnit` input and `outputPerUnit` output per
+    // unit of activity. Scarce inputs are shared in proportion to demand and
+    // a building runs at the share of its scarcest input.
+    auto produce = [&](const std::vector<size_t> &stage, const std::array<float, PlanState::MAX_BUILDINGS> &fuelPerUnit,
+                       const std::array<float, PlanState::MAX_BUILDINGS> &outputPerUnit)
+    {
+        std::array<float, RESOURCE_TYPE_COUNT> demand{};
+        for (size_t slot : stage)
+        {
+            fuel[slot] = fuelPerUnit[slot] * activity[slot];
+            for (ResourceType in : m_buildings[slot].inputs)
+                demand[static_cast<size_t>(in)] += fuel[slot];
+        }
+
+        std::array<float, RESOURCE_TYPE_COUNT> share{};
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            share[r] = demand[r] > state.amounts[r] ? std::max(state.amounts[r], 0.0f) / demand[r] : 1.0f;
+
+        for (size_t slot : stage)
+        {
+            if (activity[slot] <= 0.0f)
+                continue;
+            const BuildingDefinition &definition = m_buildings[slot];
+            float granted = 1.0f;
+            for (ResourceType in : definition.inputs)
+                granted = std::min(granted, share[static_cast<size_t>(in)]);
+            for (ResourceType in : definition.inputs)
+            {
+                float &amount = state.amounts[static_cast<size_t>(in)];
+                amount = std::max(amount - fuel[slot] * granted, 0.0f);
+            }
+            for (ResourceType out : definition.outputs)
+                state.amounts[static_cast<size_t>(out)] += outputPerUnit[slot] * activity[slot] * granted;
+        }
+    };
+
+    std::array<float, PlanState::MAX_BUILDINGS> frameFuel{}, frameOutput{}, resourceFuel{}, resourceOutput{};
+    for (float done = 0.0f; done < seconds; done += STEP)
+    {
+        const float dt = std::min(STEP, seconds - done);
+        const float multiplier = GetMultiplier(state);
+
+        // Two draws, stage by stage like the game, so a consumer runs on
+        // what its producers made this step instead of starving on the
+        // stock they left behind. Every frame a building burns a fraction
+        // of its rate as fuel for the rolled output (Player::UpdateBuildings);
+        // every resource interval it draws its full rate for the multiplied
+        // output (Player::UpdateResources). Each draw is rationed on its own.
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            const PlanState::Slot &building = state.buildings[slot];
+            const BuildingDefinition &definition = m_buildings[slot];
+            const float bonus = definition.outputs.empty() ? 0.0f : GetExpectedProductionBonus(definition.type, building.level);
+            frameOutput[slot] = building.rate * bonus;
+            frameFuel[slot] = frameOutput[slot] * Building::FUEL_CONSUMPTION_FACTOR;
+            resourceOutput[slot] = building.rate * multiplier;
+            resourceFuel[slot] = resourceOutput[slot];
+        }
+
+        for (const std::vector<size_t> &stage : m_stages)
+        {
+            // Efficiency from the fuel at the start of the stage. While an
+            // input is empty the starvation penalty applies every frame,
+            // which within a frame or two settles at raw * penalty.
+            for (size_t slot : stage)
+            {
+                PlanState::Slot &building = state.buildings[slot];
+                activity[slot] = 0.0f;
+                if (!building.owned)
+                    continue;
+
+                const BuildingDefinition &definition = m_buildings[slot];
+                float raw = 1.0f;
+                size_t empty = 0;
+                if (!definition.inputs.empty())
+                {
+                    float total = 0.0f;
+                    const float need = building.rate * Building::FUEL_CONSUMPTION_FACTOR;
+                    for (ResourceType in : definition.inputs)
+                    {
+                        float available = state.amounts[static_cast<size_t>(in)];
+                        total += need > 0.0f ? std::min(available / need, 1.0f) : 1.0f;
+                        empty += available <= 0.0f ? 1 : 0;
+                    }
+                    raw = total / definition.inputs.size();
+                }
+                if (empty > 0)
+                    building.efficiency = raw * (empty == definition.inputs.size() ? definition.fullStarvation : definition.partialStarvation);
+                else
+                    building.efficiency = std::max(raw, building.efficiency - Building::EFFICIENCY_DECAY_RATE * dt);
+                activity[slot] = building.efficiency * dt;
+            }
+            produce(stage, frameFuel, frameOutput);
+        }
+        for (const std::vector<size_t> &stage : m_stages)
+            produce(stage, resourceFuel, resourceOutput);
+
+        float maintenance = 0.0f;
+        for (size_t slot = 0; slot < count; ++slot)
+            if (state.buildings[slot].owned)
+                maintenance += state.buildings[slot].maintenance;
+        state.amounts[MONEY] = std::max(state.amounts[MONEY] - maintenance * dt / GameConstants::MAINTENANCE_UPDATE_INTERVAL, 0.0f);
+
+        state.reputationTimer += dt;
+        if (state.reputationTimer >= GameConstants::REPUTATION_UPDATE_INTERVAL)
+        {
+            state.reputationTimer -= GameConstants::REPUTATION_UPDATE_INTERVAL;
+            int gain = 0;
+            for (size_t slot = 0; slot < count; ++slot)
+                if (state.buildings[slot].owned)
+                    gain += state.buildings[slot].efficiency > 0.8f ? 2 : 1;
+            if (gain > 0)
+                state.reputation += static_cast<int>(gain * (100.0f / (100.0f + state.reputation)));
+        }
+
+        for (size_t p = 0; p < PRODUCTION_TYPE_COUNT; ++p)
+        {
+            PlanState::JobLane &lane = state.jobs[p];
+            const ProductionDefinition &definition = m_productions[p];
+            uint32_t kept = 0;
+            for (uint32_t i = 0; i < lane.running; ++i)
+            {
+                float remaining = lane.remaining[i] - dt;
+                if (remaining > 0.0f)
+                {
+                    lane.remaining[kept++] = remaining;
+                    continue;
+                }
+                state.amounts[MONEY] += definition.payout;
+                for (const auto &[type, amount] : definition.outputs)
+                    state.amounts[static_cast<size_t>(type)] += amount;
+            }
+            lane.running = kept;
+            while (lane.running < PlanState::MAX_RUNNING_JOBS && lane.queued > 0)
+            {
+                lane.remaining[lane.running++] = definition.duration;
+                --lane.queued;
+            }
+        }
+
+        state.market.RecoverImpact(GameConstants::MARKET_IMPACT_RECOVERY * dt / GameConstants::ECONOMY_UPDATE_INTERVAL);
+        state.time += dt;
+    }
+}
+
+float PlanModel::GetIncomeRate(const PlanState &state) const
+{
+    const float multiplier = GetMultiplier(state);
+    float income = 0.0f;
+    for (size_t slot = 0; slot < m_buildings.size(); ++slot)
+        if (state.buildings[slot].owned)
+            income += GetMargin(state, slot, multiplier);
+    return income;
+}
+
+float PlanModel::GetNetWorth(const PlanState &state) const
+{
+    float worth = state.amounts[MONEY];
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        if (r != MONEY && state.amounts[r] > 0.0f)
+            worth += state.market.QuoteSell(static_cast<ResourceType>(r), state.amounts[r]);
+
+    // Player::SellStructure refunds half the building cost
+    for (size_t slot = 0; slot < m_buildings.size(); ++slot)
+        if (state.buildings[slot].owned)
+            worth += m_buildings[slot].cost * 0.5f;
+
+    for (size_t p = 0; p < PRODUCTION_TYPE_COUNT; ++p)
+    {
+        const PlanState::JobLane &lane = state.jobs[p];
+        const ProductionDefinition &definition = m_productions[p];
+        if (definition.duration <= 0.0f)
+            continue;
+        for (uint32_t i = 0; i < lane.running; ++i)
+            worth += definition.cost + (definition.payout - definition.cost) * (1.0f - lane.remaining[i] / definition.duration);
+        worth += definition.cost * lane.queued;
+    }
+    return worth;
+}
+
+float PlanModel::GetActionCost(const PlanState &state, PlanAction action) const
+{
+    switch (action.type)
+    {
+    case PlanAction::Type::BUILD:
+        return m_buildings[action.target].cost;
+    case PlanAction::Type::UPGRADE:
+        return state.buildings[action.target].upgradeCost;
+    case PlanAction::Type::BEGIN_PRODUCTION:
+    {
+        const ProductionDefinition &definition = m_productions[action.target];
+        float cost = definition.cost;
+        for (const auto &[type, amount] : definition.inputs)
+            cost += amount * state.market.GetQuotedPrice(type);
+        return cost;
+    }
+    default:
+        return 0.0f;
+    }
+}
+
+float PlanModel::GetActionReturn(const PlanState &state, PlanAction action) const
+{
+    switch (action.type)
+    {
+    case PlanAction::Type::BUILD:
+    case PlanAction::Type::UPGRADE:
+    {
+        PlanState after = state;
+        if (!Apply(after, action))
+            return 0.0f;
+        return GetIncomeRate(after) - GetIncomeRate(state);
+    }
+    case PlanAction::Type::BEGIN_PRODUCTION:
+    {
+        // A job that has to queue pays out a whole run later
+        const ProductionDefinition &definition = m_productions[action.target];
+        const PlanState::JobLane &lane = state.jobs[action.target];
+        float runs = 1.0f + static_cast<float>(lane.running + lane.queued) / PlanState::MAX_RUNNING_JOBS;
+        float profit = definition.payout - GetActionCost(state, action);
+        for (const auto &[type, amount] : definition.outputs)
+            profit += amount * state.market.GetQuotedPrice(type);
+        return definition.duration > 0.0f ? profit / (definition.duration * std::floor(runs)) : 0.0f;
+    }
+    default:
+        return 0.0f;
+    }
+}
+
+AutoPlayer::AutoPlayer(const AutoPlayerSettings &settings)
+    : m_settings(settings)
+{
+}
+
+void AutoPlayer::Decide(const Player &player, const MarketState &market, std::vector<GameCommand> &commands)
+{
+    PlanState state = m_model.Observe(player, market);
+    Decide(state, commands);
+}
+
+void AutoPlayer::Decide(const GameSnapshot &snapshot, std::vector<GameCommand> &commands)
+{
+    PlanState state = m_model.Observe(snapshot);
+    Decide(state, commands);
+}
+
+void AutoPlayer::Decide(PlanState &state, std::vector<GameCommand> &commands)
+{
+    ++m_decisions;
+    m_forks = 0;
+    PlanAction action = m_settings.strategy == AutoPlayerStrategy::SEARCH && m_settings.iterations > 0
+                            ? Search(state)
+                            : ChooseGreedy(state);
+
+    // The action goes first: a World fills orders only after the tick, so
+    // the money for it must not depend on this decision's sales
+    if (m_model.Apply(state, action))
+    {
+        switch (action.type)
+        {
+        case PlanAction::Type::BUILD:
+            commands.push_back({CommandType::BUILD, static_cast<int>(m_model.GetBuildingType(action.target)), 0.0f, {}});
+            break;
+        case PlanAction::Type::UPGRADE:
+            commands.push_back({CommandType::UPGRADE_BUILDING, action.target, 0.0f, {}});
+            break;
+        case PlanAction::Type::BEGIN_PRODUCTION:
+            commands.push_back({CommandType::BEGIN_PRODUCTION, action.target, 0.0f, {}});
+            break;
+        default:
+            break;
+        }
+    }
+
+    m_orders.clear();
+    m_model.Rebalance(state, m_orders);
+    if (!m_orders.empty())
+    {
+        commands.push_back({CommandType::EXECUTE_ORDERS, 0, 0.0f, m_orders});
+    }
+}
+
+PlanAction AutoPlayer::ChooseGreedy(const PlanState &state)
+{
+    // Returns do not depend on the money at hand, so every action is scored
+    // as if money were no object; one is worth taking if it pays its cost
+    // back within the horizon
+    PlanState unlimited = state;
+    unlimited.amounts[MONEY] = FLT_MAX;
+    const float minimum = 1.0f / m_settings.horizon;
+    auto pickBest = [&](float &bestScore)
+    {
+        PlanAction best;
+        bestScore = minimum;
+        for (const PlanAction &action : m_actions)
+        {
+            float cost = m_model.GetActionCost(state, action);
+            if (cost <= 0.0f)
+                continue;
+            float score = m_model.GetActionReturn(unlimited, action) / cost;
+            if (score > bestScore)
+            {
+                best = action;
+                bestScore = score;
+            }
+        }
+        return best;
+    };
+
+    float affordableScore, bestScore;
+    m_model.ListActions(state, m_actions);
+    const PlanAction affordable = pickBest(affordableScore);
+    m_model.ListActions(unlimited, m_actions);
+    const PlanAction best = pickBest(bestScore);
+    if (bestScore <= affordableScore)
+        return affordable;
+
+    // Save up for the better one if income covers the gap soon enough
+    const float shortfall = m_model.GetActionCost(state, best) - state.amounts[MONEY];
+    const float income = m_model.GetIncomeRate(state);
+    if (income > 0.0f && shortfall / income <= m_settings.decisionInterval * SAVING_DECISIONS)
+        return {};
+    return affordable;
+}
+
+void AutoPlayer::Step(PlanState &state, PlanAction action)
+{
+    m_model.Apply(state, action);
+    m_orders.clear();
+    m_model.Rebalance(state, m_orders);
+    m_model.Advance(state, m_settings.decisionInterval);
+}
+
+PlanAction AutoPlayer::Search(const PlanState &root)
+{
+    const float end = root.time + m_settings.horizon;
+    const uint64_t seed = m_settings.seed;
+
+    m_nodes.clear();
+    m_nodes.reserve(m_settings.iterations + 1);
+    Node top;
+    top.state = root;
+    m_model.ListActions(root, top.untried);
+    m_nodes.push_back(std::move(top));
+
+    double low = DBL_MAX, high = -DBL_MAX;
+    for (size_t iteration = 0; iteration < m_settings.iterations; ++iteration)
+    {
+        // Select: follow UCB1 down to a node with untried actions
+        size_t node = 0;
+        while (m_nodes[node].untried.empty() && !m_nodes[node].children.empty())
+        {
+            const Node &parent = m_nodes[node];
+            const double range = high > low ? high - low : 1.0;
+            const double logVisits = std::log(static_cast<double>(parent.visits));
+            double bestScore = -DBL_MAX;
+            for (size_t child : parent.children)
+            {
+                const Node &candidate = m_nodes[child];
+                double mean = (candidate.value / candidate.visits - low) / range;
+                double score = mean + EXPLORATION_WEIGHT * std::sqrt(logVisits / candidate.visits);
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    node = child;
+                }
+            }
+        }
+
+        // Expand one untried action, unless the plan is already at the horizon
+        if (!m_nodes[node].untried.empty() && m_nodes[node].state.time < end)
+        {
+            PlanAction action = m_nodes[node].untried.back();
+            m_nodes[node].untried.pop_back();
+            Node child;
+            child.state = m_nodes[node].state;
+            child.action = action;
+            child.parent = node;
+            Step(child.state, action);
+            m_model.ListActions(child.state, child.untried);
+            m_nodes.push_back(std::move(child));
+            m_nodes[node].children.push_back(m_nodes.size() - 1);
+            node = m_nodes.size() - 1;
+            ++m_forks;
+        }
+
+        // Play out to the horizon, mostly greedy
+        PlanState playout = m_nodes[node].state;
+        ++m_forks;
+        uint32_t draw = 0;
+        while (playout.time < end)
+        {
+            PlanAction action;
+            if (ProductionRng::Uniform(seed + m_decisions, iteration, draw++) < PLAYOUT_RANDOMNESS)
+            {
+                m_model.ListActions(playout, m_actions);
+                size_t pick = static_cast<size_t>(ProductionRng::Uniform(seed + m_decisions, iteration, draw++) * m_actions.size());
+                action = m_actions[std::min(pick, m_actions.size() - 1)];
+            }
+            else
+                action = ChooseGreedy(playout);
+            Step(playout, action);
+        }
+
+        const double value = m_model.GetNetWorth(playout);
+        low = std::min(low, value);
+        high = std::max(high, value);
+        for (size_t at = node;; at = m_nodes[at].parent)
+        {
+            m_nodes[at].visits++;
+            m_nodes[at].value += value;
+            if (at == 0)
+                break;
+        }
+    }
+
+    // The most visited first action is the most trusted one
+    const Node &rootNode = m_nodes[0];
+    PlanAction best;
+    uint32_t bestVisits = 0;
+    for (size_t child : rootNode.children)
+    {
+        if (m_nodes[child].visits > bestVisits)
+        {
+            bestVisits = m_nodes[child].visits;
+            best = m_nodes[child].action;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Building.h"
+#include "GameCommand.h"
+#include "GameConstants.h"
+#include "GameSnapshot.h"
+#include "MarketModel.h"
+#include "MarketOrders.h"
+#include "Player.h"
+#include "Production.h"
+#include "Resource.h"
+
+// How the autoplayer picks its next action
+enum class AutoPlayerStrategy
+{
+    GREEDY, // the best payback available right now
+    SEARCH  // Monte-Carlo tree search over forked plans, greedy playouts
+};
+
+struct AutoPlayerSettings
+{
+    AutoPlayerStrategy strategy = AutoPlayerStrategy::GREEDY;
+    float horizon = 900.0f;         // seconds a plan looks ahead
+    float decisionInterval = 30.0f; // seconds between planned actions
+    size_t iterations = 256;        // search playouts per decision
+    uint64_t seed = 1;
+};
+
+// One player's economy as the planner models it, flat and trivially
+// copyable so forking a plan is a plain copy. Buildings are kept by slot,
+// in the order of Player::buildings; what never changes about them (type,
+// recipe, price) lives in the PlanModel.
+struct PlanState
+{
+    // The planner only looks at this many buildings of a player
+    static constexpr size_t MAX_BUILDINGS = 16;
+    static constexpr size_t MAX_RUNNING_JOBS = GameConstants::PRODUCTION_CONCURRENT_JOBS;
+
+    struct Slot
+    {
+        bool owned = false;
+        int level = 1;
+        float efficiency = 1.0f;
+        float rate = 0.0f;        // base production rate at this level
+        float maintenance = 0.0f; // per maintenance interval
+        float upgradeCost = 0.0f;
+    };
+
+    struct JobLane
+    {
+        uint32_t running = 0;
+        uint32_t queued = 0;
+        std::array<float, MAX_RUNNING_JOBS> remaining{}; // seconds left, running jobs only
+    };
+
+    float time = 0.0f;
+    std::array<float, RESOURCE_TYPE_COUNT> amounts{}; // money included
+    int reputation = 0;
+    float reputationTimer = 0.0f;
+    size_t buildingCount = 0;
+    std::array<Slot, MAX_BUILDINGS> buildings{};
+    std::array<JobLane, PRODUCTION_TYPE_COUNT> jobs{};
+    MarketState market;
+};
+
+static_assert(std::is_trivially_copyable_v<PlanState>, "plans are forked by copying");
+
+struct PlanAction
+{
+    enum class Type
+    {
+        WAIT,
+        BUILD,           // target: building slot
+        UPGRADE,         // target: building slot
+        BEGIN_PRODUCTION // target: ProductionType
+    };
+
+    Type type = Type::WAIT;
+    int target = 0;
+};
+
+// The game's rules as the planner runs them: one-second steps, bonus rolls
+// at their expected value and the market holding its prices, though trades
+// still walk the liquidity curve. Production runs in the game's own stages
+// with its per-frame and per-interval fuel draws. Coarse, but a fifteen-
+// minute plan costs microseconds instead of 54000 full ticks, and
+// `tycoon_server --check-plan` keeps it within 1% of a real World.
+class PlanModel
+{
+public:
+    // Takes the definitions from the observed player and returns its state
+    PlanState Observe(const Player &player, const MarketState &market);
+    PlanState Observe(const GameSnapshot &snapshot);
+
+    // Allowed and affordable actions, WAIT first
+    void ListActions(const PlanState &state, std::vector<PlanAction> &actions) const;
+    bool Apply(PlanState &state, PlanAction action) const;
+
+    // Sells what no owned building or profitable production needs and tops
+    // up fuel for the buildings that pay; appends the trades to `orders`
+    void Rebalance(PlanState &state, std::vector<MarketOrder> &orders) const;
+
+    void Advance(PlanState &state, float seconds) const;
+
+    // $ per second the owned buildings earn with full fuel at current prices
+    float GetIncomeRate(const PlanState &state) const;
+
+    // Money, holdings sold into the market, the refund for selling every
+    // owned building and the share of running jobs already done
+    float GetNetWorth(const PlanState &state) const;
+
+    // Money an action takes, and the $ per second it adds
+    float GetActionCost(const PlanState &state, PlanAction action) const;
+    float GetActionReturn(const PlanState &state, PlanAction action) const;
+
+    size_t GetBuildingCount() const { return m_buildings.size(); }
+    BuildingType GetBuildingType(size_t slot) const { return m_buildings[slot].type; }
+
+private:
+    struct BuildingDefinition
+    {
+        BuildingType type;
+        bool buildable;         // the first of its type; BUILD picks that one
+        float cost;
+        int requiredReputation;
+        float partialStarvation;
+        float fullStarvation;
+        std::vector<ResourceType> inputs;
+        std::vector<ResourceType> outputs;
+    };
+
+    struct ProductionDefinition
+    {
+        bool available = false;
+        float cost = 0.0f;
+        float duration = 0.0f;
+        float payout = 0.0f;
+        int requiredReputation = 0;
+        std::vector<std::pair<ResourceType, float>> inputs;
+        std::vector<std::pair<ResourceType, float>> outputs;
+    };
+
+    bool IsAllowed(const PlanState &state, PlanAction action) const;
+    void ObserveBuilding(const Building &building, PlanState &state);
+    void ObserveStages(const std::vector<const Building *> &buildings);
+    void ObserveProduction(const Production &production);
+    float GetMultiplier(const PlanState &state) const;
+    float GetFuelRate(const PlanState &state, size_t slot, float multiplier) const;
+    float GetMargin(const PlanState &state, size_t slot, float multiplier) const;
+    float GetProductionProfit(const PlanState &state, ProductionType type) const;
+
+    std::vector<BuildingDefinition> m_buildings;
+    std::vector<std::vector<size_t>> m_stages; // slots, producers before consumers
+    std::array<ProductionDefinition, PRODUCTION_TYPE_COUNT> m_productions;
+};
+
+// Plays a player: every decision it observes the game, picks at most one
+// action and the trades that go with it, and hands them back as commands
+// for TycoonGame::Post() or World::Apply(). Greedy picks the action that
+// pays back fastest; search plays forked plans to the horizon and picks the
+// first action of the plan that ended richest.
+class AutoPlayer
+{
+public:
+    explicit AutoPlayer(const AutoPlayerSettings &settings = {});
+
+    const AutoPlayerSettings &GetSettings() const { return m_settings; }
+
+    // Appends the commands for this decision; nothing when it waits
+    void Decide(const Player &player, const MarketState &market, std::vector<GameCommand> &commands);
+    void Decide(const GameSnapshot &snapshot, std::vector<GameCommand> &commands);
+
+    // Plans forked by the last search
+    size_t GetLastForkCount() const { return m_forks; }
+
+private:
+    struct Node
+    {
+        PlanState state;
+        PlanAction action;
+        size_t parent = 0;
+        std::vector<size_t> children;
+        std::vector<PlanAction> untried;
+        uint32_t visits = 0;
+        double value = 0.0;
+    };
+
+    void Decide(PlanState &state, std::vector<GameCommand> &commands);
+    PlanAction ChooseGreedy(const PlanState &state);
+    PlanAction Search(const PlanState &root);
+    void Step(PlanState &state, PlanAction action);
+
+    AutoPlayerSettings m_settings;
+    PlanModel m_model;
+    std::vector<Node> m_nodes;
+    std::vector<PlanAction> m_actions;
+    std::vector<MarketOrder> m_orders;
+    uint64_t m_decisions = 0;
+    size_t m_forks = 0;
+};
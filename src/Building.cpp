@@ -1,9 +1,7 @@
 #include "Building.h"
 #include <algorithm>
-#include "ResourceManager.h"
 
 // Constants for building mechanics
-const int MAX_LEVEL = 5;
 const float UPGRADE_MULTIPLIER = 1.5f;
 
 Building::Building(BuildingType type,
@@ -15,38 +13,24 @@ Building::Building(BuildingType type,
                    float maintenanceCost,
                    float upgradeCost,
                    int requiredReputation)
-    : m_type(type), m_name(name), m_cost(cost), m_baseProductionRate(baseProductionRate), m_inputResources(inputResources), m_outputResources(outputResources), m_isOperational(true), m_isOwned(false), m_efficiency(1.0f), m_level(1), m_maintenanceCost(maintenanceCost), m_upgradeCost(upgradeCost), m_requiredReputation(requiredReputation)
+    : m_type(type), m_name(name), m_cost(cost), m_baseProductionRate(baseProductionRate), m_inputResources(inputResources), m_outputResources(outputResources), m_isOperational(true), m_isOwned(false), m_efficiency(1.0f), m_level(1), m_maintenanceCost(maintenanceCost), m_upgradeCost(upgradeCost), m_requiredReputation(requiredReputation), m_priority(0), m_partialStarvationFactor(1.0f), m_fullStarvationFactor(1.0f)
 {
 }
 
-void Building::Update(float deltaTime)
+void Building::CopyState(const Building &from)
 {
-    if (!m_isOperational || !m_isOwned)
-        return;
-
-    // 1) compute & smooth efficiency
-    UpdateEfficiency(deltaTime);
-
-    // 2) produce/consume
-    float production = CalculateProduction(deltaTime);
-
-    // consume fuel
-    for (auto const &req : m_inputResources)
-    {
-        float needed = production * req.GetProductionRate() * FUEL_CONSUMPTION_FACTOR;
-        if (!ResourceManager::Instance().Consume(req.GetType(), needed))
-        {
-            production = 0.0f;
-            break;
-        }
-    }
-
-    // deposit outputs
-    for (auto const &out : m_outputResources)
-    {
-        float amountOut = production * out.GetProductionRate();
-        ResourceManager::Instance().Add(out.GetType(), amountOut);
-    }
+    m_cost = from.m_cost;
+    m_baseProductionRate = from.m_baseProductionRate;
+    m_isOperational = from.m_isOperational;
+    m_isOwned = from.m_isOwned;
+    m_efficiency = from.m_efficiency;
+    m_level = from.m_level;
+    m_maintenanceCost = from.m_maintenanceCost;
+    m_upgradeCost = from.m_upgradeCost;
+    m_requiredReputation = from.m_requiredReputation;
+    m_priority = from.m_priority;
+    m_partialStarvationFactor = from.m_partialStarvationFactor;
+    m_fullStarvationFactor = from.m_fullStarvationFactor;
 }
 
 bool Building::Upgrade()
@@ -61,16 +45,12 @@ bool Building::Upgrade()
     return true;
 }
 
-void Building::UpdateEfficiency(float deltaTime)
+float Building::CalculateRawEfficiency(const ResourceAmounts &holdings) const
 {
     // If no inputs, full efficiency
     if (m_inputResources.empty())
-    {
-        m_efficiency = 1.0f;
-        return;
-    }
+        return 1.0f;
 
-    auto &rm = ResourceManager::Instance();
     float totalEff = 0.0f;
     int realInputs = 0;
 
@@ -82,30 +62,28 @@ void Building::UpdateEfficiency(float deltaTime)
             continue;
 
         float needPerSec = m_baseProductionRate * rate * FUEL_CONSUMPTION_FACTOR;
-        float avail = rm.Get(req.GetType());
+        float avail = holdings[static_cast<size_t>(req.GetType())];
         float eff = std::min(avail / needPerSec, 1.0f);
 
         totalEff += eff;
         realInputs += 1;
     }
 
-    float rawEff = realInputs > 0
-                       ? (totalEff / realInputs)
-                       : 1.0f;
+    return realInputs > 0
+               ? (totalEff / realInputs)
+               : 1.0f;
+}
 
-    // **Smooth**: if rawEff >= current, snap up; if rawEff < current, decay slowly
-    if (rawEff >= m_efficiency)
-    {
-        m_efficiency = rawEff;
-    }
-    else
+float Building::CalculateStarvationFactor(const ResourceAmounts &holdings) const
+{
+    size_t empty = 0;
+    for (auto const &req : m_inputResources)
     {
-        float drop = Building::EFFICIENCY_DECAY_RATE * deltaTime;
-        m_efficiency = std::max(rawEff, m_efficiency - drop);
+        if (holdings[static_cast<size_t>(req.GetType())] <= 0.0f)
+            empty++;
     }
-}
 
-float Building::CalculateProduction(float deltaTime) const
-{
-    return m_baseProductionRate * m_efficiency * deltaTime;
-}
\ No newline at end of file
+    if (empty == 0)
+        return 1.0f;
+    return empty == m_inputResources.size() ? m_fullStarvationFactor : m_partialStarvationFactor;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include "Resource.h"
@@ -14,6 +15,8 @@ enum class BuildingType
     DIAMOND_MINE
 };
 
+constexpr size_t BUILDING_TYPE_COUNT = static_cast<size_t>(BuildingType::DIAMOND_MINE) + 1;
+
 class Building
 {
 public:
@@ -43,6 +46,9 @@ public:
     float GetMaintenanceCost() const { return m_maintenanceCost; }
     float GetUpgradeCost() const { return m_upgradeCost; }
     int GetRequiredReputation() const { return m_requiredReputation; }
+    int GetPriority() const { return m_priority; }
+    float GetPartialStarvationFactor() const { return m_partialStarvationFactor; }
+    float GetFullStarvationFactor() const { return m_fullStarvationFactor; }
 
     // Setters
     void SetOperational(bool operational) { m_isOperational = operational; }
@@ -53,12 +59,21 @@ public:
     void SetUpgradeCost(float cost) { m_upgradeCost = cost; }
     void SetRequiredReputation(int reputation) { m_requiredReputation = reputation; }
     void SetBaseProductionRate(float rate) { m_baseProductionRate = rate; }
+    void SetPriority(int priority) { m_priority = std::clamp(priority, 0, MAX_PRIORITY); }
+
+    // Takes every value of a building of the same type, leaving the name and
+    // recipe, which the type fixes, untouched
+    void CopyState(const Building &from);
 
-    // Virtual methods that can be overridden by specific building types
-    virtual void Update(float deltaTime);
+    // Virtual methods that can be overridden by specific building types.
+    // Production itself runs a stage at a time in Player::UpdateBuildings.
     virtual bool Upgrade();
-    virtual void UpdateEfficiency(float deltaTime);
-    virtual float CalculateProduction(float deltaTime) const;
+
+    // Fuel-limited efficiency target (average over inputs, 1 without inputs)
+    float CalculateRawEfficiency(const ResourceAmounts &holdings) const;
+
+    // Penalty applied while some or all inputs are completely empty
+    float CalculateStarvationFactor(const ResourceAmounts &holdings) const;
 
     // how fast we lose efficiency when fuel == 0 (per second)
     static constexpr float EFFICIENCY_DECAY_RATE = 0.03f; // 3% per second
@@ -66,7 +81,18 @@ public:
     // globally throttle fuel consumption
     static constexpr float FUEL_CONSUMPTION_FACTOR = 0.1f; // use only .1 the resources
 
+    static constexpr int MAX_LEVEL = 5;
+
+    // player-set input priority; higher tiers are served first when inputs run short
+    static constexpr int MAX_PRIORITY = 3;
+
 protected:
+    void SetStarvationFactors(float partial, float full)
+    {
+        m_partialStarvationFactor = partial;
+        m_fullStarvationFactor = full;
+    }
+
     BuildingType m_type;
     std::string m_name;
     float m_cost;
@@ -80,4 +106,7 @@ protected:
     float m_maintenanceCost;
     float m_upgradeCost;
     int m_requiredReputation;
+    int m_priority;
+    float m_partialStarvationFactor;
+    float m_fullStarvationFactor;
 };
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "BuildingKernels.h"
+#include <algorithm>
+#include "ProductionBonus.h"
+#include "ProductionRng.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TYCOON_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang only emit SSE/AVX instructions inside functions that opt in;
+// MSVC accepts the intrinsics anywhere
+#if defined(TYCOON_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TYCOON_TARGET_SSE2 __attribute__((target("sse2")))
+#define TYCOON_TARGET_AVX __attribute__((target("avx")))
+#else
+#define TYCOON_TARGET_SSE2
+#define TYCOON_TARGET_AVX
+#endif
+
+namespace BuildingKernels
+{
+    namespace Scalar
+    {
+        void UpdateEfficiency(float *efficiency, const float *rawEfficiency, const float *starvation, float decay, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                efficiency[i] = std::max(rawEfficiency[i], efficiency[i] - decay) * starvation[i];
+        }
+
+        void CalculateProduction(float *production, const float *baseRate, const float *efficiency, float deltaTime, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                production[i] = baseRate[i] * efficiency[i] * deltaTime;
+        }
+    }
+
+#if defined(TYCOON_X86)
+    namespace
+    {
+        // Vector lanes use exactly the scalar operation order, so every path
+        // produces bit-identical results
+        TYCOON_TARGET_SSE2 void UpdateEfficiencySse2(float *efficiency, const float *rawEfficiency, const float *starvation, float decay, size_t count)
+        {
+            const __m128 d = _mm_set1_ps(decay);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 e = _mm_loadu_ps(efficiency + i);
+                __m128 r = _mm_loadu_ps(rawEfficiency + i);
+                __m128 s = _mm_loadu_ps(starvation + i);
+                _mm_storeu_ps(efficiency + i, _mm_mul_ps(_mm_max_ps(r, _mm_sub_ps(e, d)), s));
+            }
+            Scalar::UpdateEfficiency(efficiency + i, rawEfficiency + i, starvation + i, decay, count - i);
+        }
+
+        TYCOON_TARGET_SSE2 void CalculateProductionSse2(float *production, const float *baseRate, const float *efficiency, float deltaTime, size_t count)
+        {
+            const __m128 dt = _mm_set1_ps(deltaTime);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 rate = _mm_loadu_ps(baseRate + i);
+                __m128 eff = _mm_loadu_ps(efficiency + i);
+                _mm_storeu_ps(production + i, _mm_mul_ps(_mm_mul_ps(rate, eff), dt));
+            }
+            Scalar::CalculateProduction(production + i, baseRate + i, efficiency + i, deltaTime, count - i);
+        }
+
+        TYCOON_TARGET_AVX void UpdateEfficiencyAvx(float *efficiency, const float *rawEfficiency, const float *starvation, float decay, size_t count)
+        {
+            const __m256 d = _mm256_set1_ps(decay);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 e = _mm256_loadu_ps(efficiency + i);
+                __m256 r = _mm256_loadu_ps(rawEfficiency + i);
+                __m256 s = _mm256_loadu_ps(starvation + i);
+                _mm256_storeu_ps(efficiency + i, _mm256_mul_ps(_mm256_max_ps(r, _mm256_sub_ps(e, d)), s));
+            }
+            _mm256_zeroupper();
+            UpdateEfficiencySse2(efficiency + i, rawEfficiency + i, starvation + i, decay, count - i);
+        }
+
+        TYCOON_TARGET_AVX void CalculateProductionAvx(float *production, const float *baseRate, const float *efficiency, float deltaTime, size_t count)
+        {
+            const __m256 dt = _mm256_set1_ps(deltaTime);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 rate = _mm256_loadu_ps(baseRate + i);
+                __m256 eff = _mm256_loadu_ps(efficiency + i);
+                _mm256_storeu_ps(production + i, _mm256_mul_ps(_mm256_mul_ps(rate, eff), dt));
+            }
+            _mm256_zeroupper();
+            CalculateProductionSse2(production + i, baseRate + i, efficiency + i, deltaTime, count - i);
+        }
+
+        bool CpuSupportsSse2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+#endif
+        }
+
+        bool CpuSupportsAvx()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            bool osSavesYmm = (info[2] & (1 << 27)) != 0;
+            bool hasAvx = (info[2] & (1 << 28)) != 0;
+            return osSavesYmm && hasAvx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx");
+#endif
+        }
+    }
+#endif
+
+    namespace
+    {
+        using UpdateEfficiencyFn = void (*)(float *, const float *, const float *, float, size_t);
+        using CalculateProductionFn = void (*)(float *, const float *, const float *, float, size_t);
+
+        struct Dispatch
+        {
+            InstructionSet set = InstructionSet::SCALAR;
+            UpdateEfficiencyFn updateEfficiency = Scalar::UpdateEfficiency;
+            CalculateProductionFn calculateProduction = Scalar::CalculateProduction;
+        };
+
+        Dispatch MakeDispatch(InstructionSet set)
+        {
+            Dispatch dispatch;
+#if defined(TYCOON_X86)
+            if (set == InstructionSet::AVX)
+            {
+                dispatch.set = InstructionSet::AVX;
+                dispatch.updateEfficiency = UpdateEfficiencyAvx;
+                dispatch.calculateProduction = CalculateProductionAvx;
+            }
+            else if (set == InstructionSet::SSE2)
+            {
+                dispatch.set = InstructionSet::SSE2;
+                dispatch.updateEfficiency = UpdateEfficiencySse2;
+                dispatch.calculateProduction = CalculateProductionSse2;
+            }
+#endif
+            return dispatch;
+        }
+
+        Dispatch &ActiveDispatch()
+        {
+            static Dispatch dispatch = MakeDispatch(GetBestSupportedInstructionSet());
+            return dispatch;
+        }
+    }
+
+    InstructionSet GetBestSupportedInstructionSet()
+    {
+#if defined(TYCOON_X86)
+        static const InstructionSet best = CpuSupportsAvx()    ? InstructionSet::AVX
+                                           : CpuSupportsSse2() ? InstructionSet::SSE2
+                                                               : InstructionSet::SCALAR;
+        return best;
+#else
+        return InstructionSet::SCALAR;
+#endif
+    }
+
+    InstructionSet GetInstructionSet()
+    {
+        return ActiveDispatch().set;
+    }
+
+    void SetInstructionSet(InstructionSet set)
+    {
+        ActiveDispatch() = MakeDispatch(std::min(set, GetBestSupportedInstructionSet()));
+    }
+
+    void UpdateEfficiency(float *efficiency, const float *rawEfficiency, const float *starvation, float decay, size_t count)
+    {
+        ActiveDispatch().updateEfficiency(efficiency, rawEfficiency, starvation, decay, count);
+    }
+
+    void CalculateProduction(float *production, const float *baseRate, const float *efficiency, float deltaTime, size_t count)
+    {
+        ActiveDispatch().calculateProduction(production, baseRate, efficiency, deltaTime, count);
+    }
+}
+
+void BuildingBatch::Gather(const std::vector<std::unique_ptr<Building>> &buildings, const std::vector<size_t> &indices,
+                           const ResourceAmounts &holdings)
+{
+    Gather(buildings, indices.data(), indices.size(), holdings);
+}
+
+void BuildingBatch::Gather(const std::vector<std::unique_ptr<Building>> &buildings, const size_t *indices, size_t count,
+                           const ResourceAmounts &holdings)
+{
+    m_buildings.resize(count);
+    m_efficiency.resize(count);
+    m_rawEfficiency.resize(count);
+    m_starvation.resize(count);
+    m_baseRate.resize(count);
+    m_production.resize(count);
+    m_ids.resize(count);
+    m_bonusChance.resize(count);
+    m_bonusMultiplier.resize(count);
+    m_bonus.resize(count);
+    m_expectedBonus.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Building &building = *buildings[indices[i]];
+        m_buildings[i] = &building;
+        m_efficiency[i] = building.GetEfficiency();
+        m_rawEfficiency[i] = building.CalculateRawEfficiency(holdings);
+        m_starvation[i] = building.CalculateStarvationFactor(holdings);
+        // buildings without outputs (Research Lab) burn no fuel per frame
+        m_baseRate[i] = building.GetOutputResources().empty() ? 0.0f : building.GetBaseProductionRate();
+        m_ids[i] = static_cast<uint32_t>(indices[i]);
+        m_bonusChance[i] = GetProductionBonusChance(building.GetType(), building.GetLevel());
+        m_bonusMultiplier[i] = GetProductionBonus(building.GetType()).multiplier;
+        m_expectedBonus[i] = GetExpectedProductionBonus(building.GetType(), building.GetLevel());
+    }
+}
+
+void BuildingBatch::UpdateEfficiency(float deltaTime)
+{
+    BuildingKernels::UpdateEfficiency(m_efficiency.data(), m_rawEfficiency.data(), m_starvation.data(),
+                                      Building::EFFICIENCY_DECAY_RATE * deltaTime, m_efficiency.size());
+    for (size_t i = 0; i < m_buildings.size(); ++i)
+        m_buildings[i]->SetEfficiency(m_efficiency[i]);
+}
+
+void BuildingBatch::CalculateProduction(float deltaTime, uint64_t seed, uint64_t tick)
+{
+    const size_t count = m_production.size();
+    BuildingKernels::CalculateProduction(m_production.data(), m_baseRate.data(), m_efficiency.data(), deltaTime, count);
+    ProductionRng::RollBonuses(seed, tick, m_ids.data(), m_bonusChance.data(), m_bonusMultiplier.data(), m_bonus.data(), count);
+    for (size_t i = 0; i < count; ++i)
+        m_production[i] *= m_bonus[i];
+}
+
+void BuildingBatch::CalculateExpectedProduction(float deltaTime)
+{
+    const size_t count = m_production.size();
+    BuildingKernels::CalculateProduction(m_production.data(), m_baseRate.data(), m_efficiency.data(), deltaTime, count);
+    for (size_t i = 0; i < count; ++i)
+        m_production[i] *= m_expectedBonus[i];
+}
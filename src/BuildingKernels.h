@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Building.h"
+
+// Batched efficiency/production math over structure-of-arrays building data.
+// Each kernel has a scalar reference version plus SSE2 (4 lanes) and AVX
+// (8 lanes) versions; the widest one the CPU supports is picked at runtime.
+namespace BuildingKernels
+{
+    enum class InstructionSet
+    {
+        SCALAR,
+        SSE2,
+        AVX
+    };
+
+    InstructionSet GetInstructionSet();
+    InstructionSet GetBestSupportedInstructionSet();
+
+    // Force a narrower path (e.g. to compare against SCALAR); requests wider
+    // than the CPU supports fall back to the best supported one
+    void SetInstructionSet(InstructionSet set);
+
+    // efficiency[i] = max(raw[i], efficiency[i] - decay) * starvation[i]
+    // i.e. snap up to the fuel-limited target, decay towards it otherwise
+    void UpdateEfficiency(float *efficiency, const float *rawEfficiency, const float *starvation, float decay, size_t count);
+
+    // production[i] = baseRate[i] * efficiency[i] * deltaTime
+    void CalculateProduction(float *production, const float *baseRate, const float *efficiency, float deltaTime, size_t count);
+
+    namespace Scalar
+    {
+        void UpdateEfficiency(float *efficiency, const float *rawEfficiency, const float *starvation, float decay, size_t count);
+        void CalculateProduction(float *production, const float *baseRate, const float *efficiency, float deltaTime, size_t count);
+    }
+}
+
+// Structure-of-arrays copy of one production stage, so the kernels above
+// can process it without a virtual call per building
+class BuildingBatch
+{
+public:
+    // holdings are the player's amounts, read from the ledger once for the
+    // whole stage rather than once per building input
+    void Gather(const std::vector<std::unique_ptr<Building>> &buildings, const std::vector<size_t> &indices,
+                const ResourceAmounts &holdings);
+    void Gather(const std::vector<std::unique_ptr<Building>> &buildings, const size_t *indices, size_t count,
+                const ResourceAmounts &holdings);
+
+    // Smooths efficiency and writes it back to the buildings
+    void UpdateEfficiency(float deltaTime);
+
+    // Base production times this tick's bonus roll; the roll for a building
+    // depends only on (seed, tick, building index), never on thread or order
+    void CalculateProduction(float deltaTime, uint64_t seed, uint64_t tick);
+
+    // Base production times the long-run average bonus, without rolling
+    void CalculateExpectedProduction(float deltaTime);
+
+    size_t GetCount() const { return m_buildings.size(); }
+    Building &GetBuilding(size_t i) const { return *m_buildings[i]; }
+    float GetProduction(size_t i) const { return m_production[i]; }
+
+private:
+    std::vector<Building *> m_buildings;
+    std::vector<float> m_efficiency;
+    std::vector<float> m_rawEfficiency;
+    std::vector<float> m_starvation;
+    std::vector<float> m_baseRate;
+    std::vector<float> m_production;
+    std::vector<uint32_t> m_ids;
+    std::vector<float> m_bonusChance;
+    std::vector<float> m_bonusMultiplier;
+    std::vector<float> m_bonus;
+    std::vector<float> m_expectedBonus;
+};
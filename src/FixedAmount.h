@@ -0,0 +1,78 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Signed 64-bit fixed-point quantity with 24 fractional bits (about 6e-8
+// resolution, range about +-5e11). Unlike a float, a small per-frame
+// increment lands exactly no matter how large the running total is.
+class FixedAmount
+{
+public:
+    static constexpr int FRACTION_BITS = 24;
+    static constexpr double SCALE = static_cast<double>(int64_t(1) << FRACTION_BITS);
+
+    constexpr FixedAmount() = default;
+
+    // Rounds to nearest, halves away from zero, like llround but without
+    // the library call: this runs on every ledger deposit and draw
+    static FixedAmount FromFloat(double value)
+    {
+        const double scaled = value * SCALE;
+        return FromRaw(static_cast<int64_t>(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5));
+    }
+
+    static constexpr FixedAmount FromRaw(int64_t raw)
+    {
+        FixedAmount amount;
+        amount.m_raw = raw;
+        return amount;
+    }
+
+    constexpr int64_t GetRaw() const { return m_raw; }
+
+    double ToDouble() const { return static_cast<double>(m_raw) / SCALE; }
+
+    // Rounds down, so the float never overstates the stored amount and
+    // converting it back always gives something that can be taken out again
+    float ToFloat() const
+    {
+        double exact = ToDouble();
+        float value = static_cast<float>(exact);
+        // One float step down, picked without a branch: every ledger read
+        // comes through here and about half of them round up. Zero steps to
+        // the smallest negative float.
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t down = bits == 0 ? 0x80000001u : (bits >> 31) ? bits + 1 : bits - 1;
+        const uint32_t roundedUp = 0u - static_cast<uint32_t>(value > exact);
+        bits = (down & roundedUp) | (bits & ~roundedUp);
+        std::memcpy(&value, &bits, sizeof(bits));
+        return value;
+    }
+
+    FixedAmount &operator+=(FixedAmount other)
+    {
+        m_raw += other.m_raw;
+        return *this;
+    }
+    FixedAmount &operator-=(FixedAmount other)
+    {
+        m_raw -= other.m_raw;
+        return *this;
+    }
+    FixedAmount &operator+=(float value) { return *this += FromFloat(value); }
+    FixedAmount &operator-=(float value) { return *this -= FromFloat(value); }
+
+    friend FixedAmount operator+(FixedAmount a, FixedAmount b) { return a += b; }
+    friend FixedAmount operator-(FixedAmount a, FixedAmount b) { return a -= b; }
+    friend bool operator==(FixedAmount a, FixedAmount b) { return a.m_raw == b.m_raw; }
+    friend bool operator!=(FixedAmount a, FixedAmount b) { return a.m_raw != b.m_raw; }
+    friend bool operator<(FixedAmount a, FixedAmount b) { return a.m_raw < b.m_raw; }
+    friend bool operator<=(FixedAmount a, FixedAmount b) { return a.m_raw <= b.m_raw; }
+    friend bool operator>(FixedAmount a, FixedAmount b) { return a.m_raw > b.m_raw; }
+    friend bool operator>=(FixedAmount a, FixedAmount b) { return a.m_raw >= b.m_raw; }
+
+private:
+    int64_t m_raw = 0;
+};
@@ -0,0 +1,220 @@
+#include "Forecaster.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "GameConstants.h"
+#include "World.h"
+
+namespace
+{
+    // Amounts and prices this far apart count as the same
+    constexpr float MATERIAL_FLOOR = 100.0f;
+
+    bool Moved(float from, float to, float fraction)
+    {
+        return std::fabs(to - from) > fraction * std::max({std::fabs(from), std::fabs(to), MATERIAL_FLOOR});
+    }
+
+    // Queued jobs share entries, so the entry count alone misses one more
+    size_t CountJobs(const PlayerState &player)
+    {
+        size_t jobs = 0;
+        for (size_t i = 0; i < player.jobCount; ++i)
+            jobs += player.jobs[i].count;
+        return jobs;
+    }
+}
+
+Forecaster::Forecaster(float minutes, size_t samples)
+    : m_minutes(minutes), m_samples(std::max<size_t>(samples, 1)), m_job(std::make_unique<GameState>())
+{
+    m_entries.reserve(MAX_ENTRIES);
+    m_thread = std::thread(&Forecaster::Run, this);
+}
+
+Forecaster::~Forecaster()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+bool Forecaster::Request(const GameState &state, const GameCommand &action, Forecast &out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry &entry = FindEntry(action);
+    entry.lastUsed = ++m_requests;
+    if (!entry.base)
+    {
+        entry.base = std::make_unique<GameState>(state);
+        Start(entry);
+    }
+    else if (IsMaterialChange(*entry.base, state))
+    {
+        *entry.base = state;
+        Start(entry);
+    }
+    else if (!entry.forecast.complete && entry.generation != m_latest)
+    {
+        // Dropped half way for a newer request; pick it up again
+        Start(entry);
+    }
+
+    if (entry.forecast.GetSampleCount() == 0)
+        return false;
+    out = entry.forecast;
+    return true;
+}
+
+bool Forecaster::IsMaterialChange(const GameState &from, const GameState &to) const
+{
+    if (to.time < from.time || to.time - from.time > m_minutes * 60.0f * MATERIAL_CHANGE)
+        return true;
+
+    const PlayerState &a = from.player;
+    const PlayerState &b = to.player;
+    if (a.buildingCount != b.buildingCount || CountJobs(a) != CountJobs(b) ||
+        std::abs(a.reputation - b.reputation) >= MATERIAL_REPUTATION)
+        return true;
+    for (size_t i = 0; i < a.buildingCount; ++i)
+    {
+        const auto &x = a.buildings[i];
+        const auto &y = b.buildings[i];
+        if (x.type != y.type || x.owned != y.owned || x.level != y.level || x.operational != y.operational)
+            return true;
+    }
+
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        const ResourceType type = static_cast<ResourceType>(r);
+        if (Moved(a.ledger.Get(type), b.ledger.Get(type), MATERIAL_CHANGE) ||
+            Moved(from.market.price[r], to.market.price[r], MATERIAL_CHANGE))
+            return true;
+    }
+    return false;
+}
+
+Forecaster::Entry &Forecaster::FindEntry(const GameCommand &action)
+{
+    for (auto &entry : m_entries)
+    {
+        if (entry.type == action.type && entry.target == action.target)
+            return entry;
+    }
+
+    if (m_entries.size() < MAX_ENTRIES)
+    {
+        m_entries.emplace_back();
+        m_entries.back().type = action.type;
+        m_entries.back().target = action.target;
+        return m_entries.back();
+    }
+
+    // Full: reuse the entry asked for least recently
+    Entry &oldest = *std::min_element(m_entries.begin(), m_entries.end(), [](const Entry &x, const Entry &y)
+    {
+        return x.lastUsed < y.lastUsed;
+    });
+    oldest.type = action.type;
+    oldest.target = action.target;
+    oldest.base.reset();
+    oldest.generation = 0;
+    return oldest;
+}
+
+void Forecaster::Start(Entry &entry)
+{
+    Forecast &forecast = entry.forecast;
+    forecast.interval = m_minutes * 60.0f / static_cast<float>(m_samples);
+    forecast.sampleCount = m_samples + 1;
+    forecast.actionApplied = false;
+    forecast.complete = false;
+    for (auto &branch : forecast.curves)
+    {
+        for (auto &curve : branch)
+            curve.clear();
+    }
+
+    entry.generation = ++m_nextGeneration;
+    m_latest = entry.generation;
+    *m_job = *entry.base;
+    m_jobAction = {entry.type, entry.target, 0.0f, {}};
+    m_hasJob = true;
+    m_wake.notify_one();
+}
+
+void Forecaster::Run()
+{
+    auto base = std::make_unique<GameState>();
+    for (;;)
+    {
+        GameCommand action;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || m_hasJob; });
+            if (m_stop)
+                return;
+            *base = *m_job;
+            action = m_jobAction;
+            generation = m_latest;
+            m_hasJob = false;
+        }
+        Simulate(*base, action, generation);
+    }
+}
+
+void Forecaster::Simulate(const GameState &base, const GameCommand &action, uint64_t generation)
+{
+    // Both branches from the same fork, bonus rolls at their average so the
+    // curves show the trend rather than one lucky run
+    World without(base.marketSeed);
+    World with(base.marketSeed);
+    World *worlds[Forecast::BRANCH_COUNT] = {&without, &with};
+    for (World *world : worlds)
+    {
+        world->AddPlayer("Forecast");
+        world->LoadState(0, base);
+        world->SetExpectedValue(true);
+    }
+    const FixedAmount spent = with.GetPlayer(0).totalSpent;
+    with.Apply(0, action);
+    const bool applied = with.GetPlayer(0).totalSpent != spent;
+
+    // Whole ticks per sample, none longer than the game's own cap
+    const float interval = m_minutes * 60.0f / static_cast<float>(m_samples);
+    const int ticks = std::max(1, static_cast<int>(std::ceil(interval / GameConstants::MAX_DELTA_TIME)));
+    const float tick = interval / static_cast<float>(ticks);
+
+    for (size_t s = 0; s <= m_samples; ++s)
+    {
+        if (s > 0)
+        {
+            for (int t = 0; t < ticks; ++t)
+            {
+                without.Update(tick);
+                with.Update(tick);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop || m_latest != generation)
+            return;
+        auto entry = std::find_if(m_entries.begin(), m_entries.end(), [generation](const Entry &e) { return e.generation == generation; });
+        if (entry == m_entries.end())
+            return;
+
+        Forecast &forecast = entry->forecast;
+        forecast.actionApplied = applied;
+        for (size_t b = 0; b < Forecast::BRANCH_COUNT; ++b)
+        {
+            const Player &player = worlds[b]->GetPlayer(0);
+            for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                forecast.curves[b][r].push_back(player.ledger.Get(static_cast<ResourceType>(r)));
+        }
+        forecast.complete = s == m_samples;
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameCommand.h"
+#include "GameState.h"
+#include "Resource.h"
+
+// Projected holdings over the next minutes, once as things are and once
+// with one action taken. Curves grow as the forecast runs.
+struct Forecast
+{
+    enum Branch
+    {
+        WITHOUT_ACTION,
+        WITH_ACTION,
+        BRANCH_COUNT
+    };
+
+    float interval = 0.0f;   // game seconds between samples
+    size_t sampleCount = 0;  // samples per curve once complete
+    bool actionApplied = false; // false if the action was refused in the fork
+    bool complete = false;
+    std::array<std::array<std::vector<float>, RESOURCE_TYPE_COUNT>, BRANCH_COUNT> curves;
+
+    size_t GetSampleCount() const { return curves[WITH_ACTION][0].size(); }
+    float GetLast(Branch branch, ResourceType type) const { return curves[branch][static_cast<size_t>(type)].back(); }
+};
+
+// Answers "what if I build / upgrade this?" on a background thread. Each
+// request forks the game state into two one-player Worlds, applies the
+// action to one of them and fast-forwards both at expected value, publishing
+// samples as it goes. Forecasts are cached per action and kept until the
+// game drifts materially from the state they started at; only the latest
+// request is worked on, so hovering over several buttons never piles up.
+class Forecaster
+{
+public:
+    explicit Forecaster(float minutes = 10.0f, size_t samples = 60);
+    ~Forecaster();
+
+    Forecaster(const Forecaster &) = delete;
+    Forecaster &operator=(const Forecaster &) = delete;
+
+    // Copies the forecast for `action` from `state` as far as it has run
+    // into `out`, starting it first if there is none to reuse; false when
+    // not a single sample is in yet
+    bool Request(const GameState &state, const GameCommand &action, Forecast &out);
+
+    float GetMinutes() const { return m_minutes; }
+
+    // Buildings, levels, jobs, reputation, or holdings and prices moved by
+    // more than a tenth, or a tenth of the horizon gone by
+    bool IsMaterialChange(const GameState &from, const GameState &to) const;
+
+private:
+    struct Entry
+    {
+        CommandType type;
+        int target;
+        std::unique_ptr<GameState> base;
+        Forecast forecast;
+        uint64_t generation = 0; // of the run that fills it
+        uint64_t lastUsed = 0;
+    };
+
+    static constexpr size_t MAX_ENTRIES = 16;
+    static constexpr float MATERIAL_CHANGE = 0.1f;
+    static constexpr int MATERIAL_REPUTATION = 5;
+
+    Entry &FindEntry(const GameCommand &action);
+    void Start(Entry &entry);
+    void Run();
+    void Simulate(const GameState &base, const GameCommand &action, uint64_t generation);
+
+    float m_minutes;
+    size_t m_samples;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Entry> m_entries;
+    uint64_t m_requests = 0;
+    uint64_t m_latest = 0;       // generation the worker should run
+    uint64_t m_nextGeneration = 0;
+    std::unique_ptr<GameState> m_job; // copy of the latest base, taken by the worker
+    GameCommand m_jobAction;
+    bool m_hasJob = false;
+    bool m_stop = false;
+    std::thread m_thread;
+};
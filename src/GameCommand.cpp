@@ -0,0 +1,54 @@
+#include "GameCommand.h"
+#include <cmath>
+
+// Orders per command on the wire; more than any UI batch holds
+constexpr uint32_t MAX_COMMAND_ORDERS = 1024;
+
+void GameCommand::Write(std::ostream &out) const
+{
+    int32_t kind = static_cast<int32_t>(type);
+    int32_t index = target;
+    uint32_t orderCount = static_cast<uint32_t>(orders.size());
+    out.write(reinterpret_cast<const char *>(&kind), sizeof(kind));
+    out.write(reinterpret_cast<const char *>(&index), sizeof(index));
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    out.write(reinterpret_cast<const char *>(&orderCount), sizeof(orderCount));
+    for (const auto &order : orders)
+    {
+        int32_t resource = static_cast<int32_t>(order.type);
+        int32_t side = static_cast<int32_t>(order.side);
+        out.write(reinterpret_cast<const char *>(&resource), sizeof(resource));
+        out.write(reinterpret_cast<const char *>(&order.quantity), sizeof(order.quantity));
+        out.write(reinterpret_cast<const char *>(&side), sizeof(side));
+    }
+}
+
+bool GameCommand::Read(std::istream &in)
+{
+    int32_t kind = 0;
+    int32_t index = 0;
+    uint32_t orderCount = 0;
+    in.read(reinterpret_cast<char *>(&kind), sizeof(kind));
+    in.read(reinterpret_cast<char *>(&index), sizeof(index));
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    in.read(reinterpret_cast<char *>(&orderCount), sizeof(orderCount));
+    if (!in || !std::isfinite(value) || kind < 0 || kind > static_cast<int32_t>(CommandType::SET_AUTOPLAY) || orderCount > MAX_COMMAND_ORDERS)
+        return false;
+
+    type = static_cast<CommandType>(kind);
+    target = index;
+    orders.resize(orderCount);
+    for (auto &order : orders)
+    {
+        int32_t resource = 0;
+        int32_t side = 0;
+        in.read(reinterpret_cast<char *>(&resource), sizeof(resource));
+        in.read(reinterpret_cast<char *>(&order.quantity), sizeof(order.quantity));
+        in.read(reinterpret_cast<char *>(&side), sizeof(side));
+        if (!in || resource < 0 || resource >= static_cast<int32_t>(RESOURCE_TYPE_COUNT) || (side != 0 && side != 1))
+            return false;
+        order.type = static_cast<ResourceType>(resource);
+        order.side = static_cast<OrderSide>(side);
+    }
+    return true;
+}
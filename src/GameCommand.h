@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include "MarketOrders.h"
+
+// Player actions. The UI posts them and the simulation applies them as a
+// batch at the start of a tick, so game state is only ever written by one
+// thread. The same records can be logged for replay or sent over a wire.
+enum class CommandType
+{
+    NEW_GAME,
+    SAVE_GAME,
+    LOAD_GAME,
+    SET_PAUSED,          // value: 1 to pause, 0 to resume
+    BUILD,               // target: BuildingType
+    SELL_BUILDING,       // target: building index
+    UPGRADE_BUILDING,    // target: building index
+    SET_PRIORITY,        // target: building index, value: priority
+    BEGIN_PRODUCTION,    // target: ProductionType
+    EXECUTE_ORDERS,      // orders
+    UNLOCK_STOCKS,
+    SET_SIMULATION_MODE, // target: SimulationMode
+    SET_MARKET_MODEL,    // target: MarketModelType
+    SET_ARCHIVE_SPAN,    // value: hours of archive to plot, 0 for none
+    QUICK_SAVE,          // keeps a GameState in memory
+    QUICK_LOAD,          // rolls back to it
+    SET_RECORDING,       // value: 1 to start a command log, 0 to stop
+    REPLAY_RECORDING,    // plays the command log back
+    SET_AUTOPLAY         // target: AutoPlayerStrategy; value: 1 to start, 0 to stop
+};
+
+struct GameCommand
+{
+    CommandType type = CommandType::SET_PAUSED;
+    int target = 0;
+    float value = 0.0f;
+    std::vector<MarketOrder> orders;
+
+    // Binary record: type, target, value and an order count, then one entry
+    // per order, so its length varies. Read() fails on a truncated or
+    // unknown one, or one whose value is not finite.
+    void Write(std::ostream &out) const;
+    bool Read(std::istream &in);
+};
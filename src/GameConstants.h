@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 namespace GameConstants
 {
@@ -10,6 +11,25 @@ namespace GameConstants
     constexpr float FPS_UPDATE_INTERVAL = 1.0f;
     constexpr float MAX_DELTA_TIME = 0.1f;
 
+    // Fixed tick of the simulation thread; after a stall it runs at most
+    // this many ticks back to back before giving up on catching up
+    constexpr float SIMULATION_TICK = 1.0f / 60.0f;
+    constexpr int SIMULATION_MAX_CATCHUP_TICKS = 5;
+
+    // Production scheduling: independent subgraphs only go to worker
+    // threads once there are enough buildings to amortise the dispatch
+    constexpr size_t PARALLEL_SUBGRAPH_MIN_BUILDINGS = 256;
+
+    // Buildings per job when a stage is split across threads. Fixed, not
+    // derived from the core count, so results never depend on thread count.
+    constexpr size_t BUILDING_CHUNK_SIZE = 4096;
+
+    // Players per job when a World updates its players in parallel
+    constexpr size_t PLAYERS_PER_JOB = 8;
+
+    // Investment jobs of one production type running at once; more wait in line
+    constexpr size_t PRODUCTION_CONCURRENT_JOBS = 3;
+
     // Starting values
     constexpr float STARTING_MONEY = 500.0f;
     constexpr int STARTING_REPUTATION = 0;
@@ -32,6 +52,11 @@ namespace GameConstants
     constexpr float MIN_RESOURCE_PRICE = 0.1f;
     constexpr float PRICE_VOLATILITY = 0.1f;
 
+    // Market liquidity: selling (buying) this much value at once moves the
+    // price down (up) by a factor of e; the impact then fades each economy tick
+    constexpr float MARKET_LIQUIDITY = 5000.0f;
+    constexpr float MARKET_IMPACT_RECOVERY = 0.1f;
+
     // Resource base prices
     constexpr float WOOD_BASE_PRICE = 4.0f;
     constexpr float STONE_BASE_PRICE = 8.0f;
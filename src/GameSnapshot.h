@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "Building.h"
+#include "FixedAmount.h"
+#include "GameState.h"
+#include "MarketModel.h"
+#include "MarketOrders.h"
+#include "PriceHistory.h"
+#include "Production.h"
+#include "Resource.h"
+#include "ResourceLedger.h"
+
+// Immutable copy of everything the UI draws, taken by the simulation thread
+// after each tick. Buildings and productions are kept by value: the derived
+// types only configure their base, so nothing is lost in the copy. Each of
+// the three buffers is refreshed in place, so a tick only rewrites what can
+// have changed since that buffer was last published.
+struct GameSnapshot
+{
+    struct JobSummary
+    {
+        size_t running = 0;
+        size_t queued = 0;
+        float progress = 0.0f; // of the earliest-started running job
+    };
+
+    uint64_t tick = 0;
+    float gameTime = 0.0f;
+    float ticksPerSecond = 0.0f;
+    bool isPaused = false;
+    bool hasQuickSave = false;
+    bool isRecording = false;
+    bool isAutoplaying = false;
+    int autoplayStrategy = 0; // AutoPlayerStrategy
+
+    ResourceLedger ledger;
+    std::map<ResourceType, Resource> resources;
+    std::vector<Building> buildings;
+    std::vector<Production> productions;
+    std::array<JobSummary, PRODUCTION_TYPE_COUNT> jobs{};
+    int reputation = 0;
+    FixedAmount totalEarnings;
+    FixedAmount totalSpent;
+    bool hasStocksUnlocked = false;
+    float productionMultiplier = 1.0f;
+
+    MarketState market;
+    PriceHistory priceHistory;
+
+    // The whole simulation, flat, for forks such as forecasts. Only taken
+    // while the UI shows a forecast, and stale when hasState is false (not
+    // asked for, or the player does not fit a GameState).
+    GameState state;
+    bool hasState = false;
+
+    // Archive plots for the span the UI last asked for (0 when none)
+    float archiveHours = 0.0f;
+    std::array<std::vector<float>, RESOURCE_TYPE_COUNT> archivePlots;
+
+    // priceHistory and archivePlots change about once a second; they are
+    // copied only when this is behind the game's count of chart changes
+    uint64_t chartVersion = 0;
+
+    float GetMoney() const { return ledger.Get(ResourceType::MONEY); }
+
+    ResourceAmounts GetHoldings() const
+    {
+        ResourceAmounts holdings{};
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            holdings[r] = ledger.Get(static_cast<ResourceType>(r));
+        return holdings;
+    }
+
+    OrderReport QuoteOrders(const std::vector<MarketOrder> &orders) const
+    {
+        return MarketOrders::Quote(market, GetHoldings(), orders);
+    }
+};
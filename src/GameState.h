@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "Building.h"
+#include "FixedAmount.h"
+#include "MarketModel.h"
+#include "Production.h"
+#include "Resource.h"
+#include "ResourceLedger.h"
+
+// Everything a player changes as the simulation runs, in one flat block.
+// Buildings and jobs refer to their definitions by type; names, recipes
+// and the rest come from BuildingFactory when the state is loaded.
+struct PlayerState
+{
+    static constexpr size_t MAX_BUILDINGS = 64;
+    static constexpr size_t MAX_JOBS = 256; // entries; a queued entry can stand for many jobs
+
+    struct BuildingState
+    {
+        float efficiency;
+        float baseProductionRate;
+        float maintenanceCost;
+        float upgradeCost;
+        int32_t level;
+        int32_t priority;
+        BuildingType type;
+        bool owned;
+        bool operational;
+    };
+
+    // In ProductionQueue::ForEachJob order: running jobs, then queued ones.
+    // Consecutive queued jobs that match share one entry, so a queue of any
+    // length takes an entry per running job plus one per run of queued ones.
+    struct JobState
+    {
+        double start; // queue time, running jobs only
+        float duration;
+        float payout;
+        uint32_t count; // jobs this entry stands for; 1 when running
+        ProductionType type;
+        bool running;
+    };
+
+    ResourceLedger ledger;
+    std::array<float, RESOURCE_TYPE_COUNT> prices{};
+    FixedAmount totalEarnings;
+    FixedAmount totalSpent;
+    int32_t reputation = 0;
+    int32_t achievements = 0;
+    bool hasStocksUnlocked = false;
+    uint32_t ownedProductions = 0; // bit per ProductionType
+
+    double jobClock = 0.0;
+    uint32_t buildingCount = 0;
+    uint32_t jobCount = 0;
+    std::array<BuildingState, MAX_BUILDINGS> buildings{};
+    std::array<JobState, MAX_JOBS> jobs{};
+};
+
+// A whole single-player simulation: the clock, the market and the player.
+// It is trivially copyable, so forking a game (what-if previews, search,
+// rollback, autosave) copies one block of memory, and a fork loaded into
+// a TycoonGame or a one-player World carries on from the same point.
+struct GameState
+{
+    uint64_t seed = 0;       // the player's bonus rolls
+    uint64_t marketSeed = 0; // price moves; TycoonGame uses one seed for both
+    uint64_t tick = 0;
+    float time = 0.0f;
+    float economyTimer = 0.0f;
+    float reputationTimer = 0.0f;
+    float maintenanceTimer = 0.0f;
+    float resourceTimer = 0.0f;
+    bool paused = false;
+
+    MarketState market;
+    MarketModelType marketModel = MarketModelType::RANDOM_WALK;
+    bool expectedValue = false;   // bonus rolls at their average
+    bool steadyProduction = false; // ledger rates stand in for per-frame production
+    std::array<float, RESOURCE_TYPE_COUNT> steadyFloor{};
+    uint64_t steadySettledTick = 0; // bonus rolls after this tick are still owed
+    float steadyPendingTime = 0.0f; // game time those ticks covered
+
+    PlayerState player;
+};
+
+static_assert(std::is_trivially_copyable_v<PlayerState>, "player states are copied as raw memory");
+static_assert(std::is_trivially_copyable_v<GameState>, "game states are copied as raw memory");
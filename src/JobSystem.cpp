@@ -0,0 +1,124 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+// Index of the current thread's deque in the pool it works for, or none
+static thread_local const JobSystem *t_pool = nullptr;
+static thread_local size_t t_queue = 0;
+
+JobSystem::JobSystem(size_t workers)
+{
+    if (workers == 0)
+        workers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+    m_queues.reserve(workers);
+    for (size_t w = 0; w < workers; ++w)
+        m_queues.push_back(std::make_unique<Queue>());
+    m_workers.reserve(workers);
+    for (size_t w = 0; w < workers; ++w)
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, w);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+JobSystem &JobSystem::GetDefault()
+{
+    static JobSystem pool;
+    return pool;
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &fn)
+{
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || m_workers.empty())
+    {
+        for (size_t begin = 0; begin < count; begin += grain)
+            fn(begin, std::min(begin + grain, count));
+        return;
+    }
+
+    // Workers queue on their own deque; other threads deal the chunks out
+    std::atomic<size_t> pending{chunks};
+    const bool isWorker = t_pool == this;
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t queue = isWorker ? t_queue : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+        Push(queue, {&fn, c * grain, std::min((c + 1) * grain, count), &pending});
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_all();
+
+    // Help out until every chunk of this loop has finished
+    const size_t home = isWorker ? t_queue : 0;
+    while (pending.load(std::memory_order_acquire) > 0)
+    {
+        if (!TryRunOne(home))
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::Push(size_t queue, const Job &job)
+{
+    std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+    m_queues[queue]->jobs.push_back(job);
+    m_queued.fetch_add(1, std::memory_order_release);
+}
+
+bool JobSystem::TryRunOne(size_t home)
+{
+    Job job{};
+    bool found = false;
+    for (size_t i = 0; i < m_queues.size() && !found; ++i)
+    {
+        Queue &queue = *m_queues[(home + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+        // Own deque LIFO keeps caches warm; stealing FIFO takes the biggest backlog
+        if (i == 0)
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        found = true;
+    }
+    if (!found)
+        return false;
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    (*job.fn)(job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+    t_pool = this;
+    t_queue = index;
+    for (;;)
+    {
+        if (TryRunOne(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+        if (m_stop)
+            return;
+    }
+}
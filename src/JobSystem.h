@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads, each with its own job deque. A worker pops
+// the newest job of its own deque and, once that is empty, steals the
+// oldest job of another one. A thread waiting for its jobs runs queued jobs
+// meanwhile, so parallel loops may nest (subgraphs, then chunks of a stage).
+class JobSystem
+{
+public:
+    // workers == 0 uses one worker per core besides the calling thread
+    explicit JobSystem(size_t workers = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Shared pool for the simulation
+    static JobSystem &GetDefault();
+
+    size_t GetWorkerCount() const { return m_workers.size(); }
+
+    // Calls fn(begin, end) for every chunk [k * grain, (k + 1) * grain) of
+    // [0, count), the last one clipped, and returns once all are done.
+    // Chunk bounds depend only on count and grain, never on the number of
+    // threads, so per-chunk results reduced in chunk order are reproducible.
+    // fn must not throw.
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &fn);
+
+private:
+    struct Job
+    {
+        const std::function<void(size_t, size_t)> *fn;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t> *pending;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void Push(size_t queue, const Job &job);
+    bool TryRunOne(size_t home);
+    void WorkerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<size_t> m_nextQueue{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+};
@@ -0,0 +1,412 @@
+#include "MarketArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    constexpr uint32_t FILE_MAGIC = 0x484D5954;  // "TYMH"
+    constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+    constexpr uint32_t FILE_VERSION = 1;
+
+    uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float BitsFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Both expect x != 0
+    int LeadingZeros(uint32_t x)
+    {
+        int n = 0;
+        while (!(x & 0x80000000u))
+        {
+            x <<= 1;
+            n++;
+        }
+        return n;
+    }
+
+    int TrailingZeros(uint32_t x)
+    {
+        int n = 0;
+        while (!(x & 1u))
+        {
+            x >>= 1;
+            n++;
+        }
+        return n;
+    }
+
+    // MSB-first bit stream; each writer starts on a fresh byte
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint8_t> &bytes) : m_bytes(bytes) {}
+
+        void Write(uint32_t value, int count)
+        {
+            for (int i = count - 1; i >= 0; --i)
+            {
+                if (m_bit == 0)
+                    m_bytes.push_back(0);
+                if ((value >> i) & 1u)
+                    m_bytes.back() |= static_cast<uint8_t>(0x80u >> m_bit);
+                m_bit = (m_bit + 1) & 7;
+            }
+        }
+
+    private:
+        std::vector<uint8_t> &m_bytes;
+        int m_bit = 0;
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+        bool Overrun() const { return m_overrun; }
+
+        uint32_t Read(int count)
+        {
+            uint32_t value = 0;
+            while (count > 0)
+            {
+                if (m_pos >= m_size)
+                {
+                    m_overrun = true;
+                    return 0;
+                }
+                int take = std::min(count, 8 - m_bit);
+                uint32_t bits = (m_data[m_pos] >> (8 - m_bit - take)) & ((1u << take) - 1u);
+                value = (value << take) | bits;
+                m_bit += take;
+                count -= take;
+                if (m_bit == 8)
+                {
+                    m_bit = 0;
+                    m_pos++;
+                }
+            }
+            return value;
+        }
+
+    private:
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+        int m_bit = 0;
+        bool m_overrun = false;
+    };
+
+    // Gorilla XOR encoding on 32-bit floats. An unchanged price costs one
+    // bit; a change that fits the previous window of meaningful bits costs
+    // two bits plus the window, anything else 12 bits plus its own window.
+    void EncodeColumn(const std::vector<float> &values, std::vector<uint8_t> &bytes)
+    {
+        BitWriter writer(bytes);
+        uint32_t prev = FloatBits(values[0]);
+        writer.Write(prev, 32);
+
+        int prevLead = -1;
+        int prevTrail = 0;
+        for (size_t i = 1; i < values.size(); ++i)
+        {
+            uint32_t cur = FloatBits(values[i]);
+            uint32_t x = cur ^ prev;
+            prev = cur;
+            if (x == 0)
+            {
+                writer.Write(0, 1);
+                continue;
+            }
+
+            int lead = LeadingZeros(x);
+            int trail = TrailingZeros(x);
+            if (prevLead >= 0 && lead >= prevLead && trail >= prevTrail)
+            {
+                writer.Write(2, 2);
+                writer.Write(x >> prevTrail, 32 - prevLead - prevTrail);
+            }
+            else
+            {
+                int length = 32 - lead - trail;
+                writer.Write(3, 2);
+                writer.Write(static_cast<uint32_t>(lead), 5);
+                writer.Write(static_cast<uint32_t>(length - 1), 5);
+                writer.Write(x >> trail, length);
+                prevLead = lead;
+                prevTrail = trail;
+            }
+        }
+    }
+
+    void DecodeGorilla(const uint8_t *data, size_t size, uint32_t count, std::vector<float> &out)
+    {
+        out.resize(count);
+        if (count == 0)
+            return;
+
+        BitReader reader(data, size);
+        uint32_t prev = reader.Read(32);
+        out[0] = BitsFloat(prev);
+
+        int lead = 0;
+        int trail = 0;
+        for (uint32_t i = 1; i < count; ++i)
+        {
+            if (reader.Read(1) != 0)
+            {
+                if (reader.Read(1) != 0)
+                {
+                    lead = static_cast<int>(reader.Read(5));
+                    int length = static_cast<int>(reader.Read(5)) + 1;
+                    trail = std::max(0, 32 - lead - length);
+                }
+                prev ^= reader.Read(32 - lead - trail) << trail;
+            }
+            if (reader.Overrun())
+            {
+                // Damaged column: hold the last good value
+                std::fill(out.begin() + i, out.end(), out[i - 1]);
+                return;
+            }
+            out[i] = BitsFloat(prev);
+        }
+    }
+}
+
+bool MarketArchive::Open(const std::string &path, uint64_t keepSamples)
+{
+    m_map.Close();
+    m_mapStale = true;
+    m_path = path;
+    m_chunks.clear();
+    m_pending.clear();
+    m_fileSize = 0;
+
+    // Index the chunks that are intact and inside the kept range. Saves
+    // flush first, so a saved sample count always ends on a chunk boundary.
+    uint64_t validSize = 0;
+    if (m_map.Open(path) && m_map.GetSize() >= sizeof(FileHeader))
+    {
+        const uint8_t *data = m_map.GetData();
+        const size_t size = m_map.GetSize();
+        FileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic == FILE_MAGIC && header.version == FILE_VERSION && header.resourceCount == RESOURCE_TYPE_COUNT)
+        {
+            validSize = sizeof(FileHeader);
+            uint64_t nextSample = 0;
+            while (validSize + sizeof(ChunkHeader) <= size)
+            {
+                ChunkHeader chunk;
+                std::memcpy(&chunk, data + validSize, sizeof(chunk));
+                uint64_t bytes = sizeof(ChunkHeader);
+                for (uint32_t columnBytes : chunk.columnBytes)
+                    bytes += columnBytes;
+
+                // A torn write at the end of the file ends the scan as well
+                if (chunk.magic != CHUNK_MAGIC || chunk.sampleCount == 0 || chunk.firstSample != nextSample ||
+                    validSize + bytes > size || nextSample + chunk.sampleCount > keepSamples)
+                    break;
+
+                m_chunks.push_back({chunk.firstSample, chunk.sampleCount, validSize});
+                nextSample += chunk.sampleCount;
+                validSize += bytes;
+            }
+        }
+    }
+    m_map.Close();
+
+    try
+    {
+        if (validSize == 0)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+            FileHeader header{FILE_MAGIC, FILE_VERSION, static_cast<uint32_t>(RESOURCE_TYPE_COUNT), 0};
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            validSize = sizeof(FileHeader);
+        }
+        else if (validSize < std::filesystem::file_size(path))
+        {
+            std::filesystem::resize_file(path, validSize);
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    m_fileSize = validSize;
+    return true;
+}
+
+void MarketArchive::Append(const std::array<float, RESOURCE_TYPE_COUNT> &prices)
+{
+    m_pending.push_back(prices);
+    if (m_pending.size() >= CHUNK_SAMPLES)
+        WriteChunk();
+}
+
+bool MarketArchive::Flush()
+{
+    return m_pending.empty() || WriteChunk();
+}
+
+uint64_t MarketArchive::GetSampleCount() const
+{
+    uint64_t stored = m_chunks.empty() ? 0 : m_chunks.back().firstSample + m_chunks.back().sampleCount;
+    return stored + m_pending.size();
+}
+
+bool MarketArchive::WriteChunk()
+{
+    if (m_path.empty())
+        return false;
+
+    const uint32_t count = static_cast<uint32_t>(m_pending.size());
+    ChunkHeader header{};
+    header.magic = CHUNK_MAGIC;
+    header.sampleCount = count;
+    header.firstSample = GetSampleCount() - count;
+
+    std::vector<uint8_t> payload;
+    std::vector<float> column(count);
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            column[i] = m_pending[i][r];
+            sum += column[i];
+        }
+        size_t before = payload.size();
+        EncodeColumn(column, payload);
+        header.columnBytes[r] = static_cast<uint32_t>(payload.size() - before);
+        header.columnMean[r] = static_cast<float>(sum / count);
+    }
+
+    // The file cannot grow under a live mapping on every platform
+    m_map.Close();
+    m_mapStale = true;
+
+    std::ofstream file(m_path, std::ios::binary | std::ios::app);
+    if (!file.is_open())
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(payload.data()), payload.size());
+    file.close();
+    if (!file)
+    {
+        // Cut off the partial chunk so later appends stay aligned
+        std::error_code ec;
+        std::filesystem::resize_file(m_path, m_fileSize, ec);
+        return false;
+    }
+
+    m_chunks.push_back({header.firstSample, count, m_fileSize});
+    m_fileSize += sizeof(header) + payload.size();
+    m_pending.clear();
+    return true;
+}
+
+bool MarketArchive::EnsureMapped() const
+{
+    if (m_mapStale)
+        m_mapStale = !m_map.Open(m_path);
+    return m_map.IsOpen() && m_map.GetSize() >= m_fileSize;
+}
+
+void MarketArchive::DecodeColumn(const ChunkRef &chunk, size_t resource, std::vector<float> &out) const
+{
+    ChunkHeader header;
+    std::memcpy(&header, m_map.GetData() + chunk.offset, sizeof(header));
+    uint64_t offset = chunk.offset + sizeof(ChunkHeader);
+    for (size_t r = 0; r < resource; ++r)
+        offset += header.columnBytes[r];
+    DecodeGorilla(m_map.GetData() + offset, header.columnBytes[resource], chunk.sampleCount, out);
+}
+
+void MarketArchive::Query(ResourceType type, uint64_t first, uint64_t last, size_t points, std::vector<float> &out) const
+{
+    out.clear();
+    last = std::min(last, GetSampleCount());
+    if (first >= last || points == 0)
+        return;
+
+    const uint64_t span = last - first;
+    points = static_cast<size_t>(std::min<uint64_t>(points, span));
+    const size_t resource = static_cast<size_t>(type);
+
+    std::vector<double> sums(points, 0.0);
+    std::vector<uint64_t> counts(points, 0);
+    auto bucketOf = [&](uint64_t sample)
+    { return static_cast<size_t>((sample - first) * points / span); };
+
+    // Buckets at least a chunk wide are served from the chunk headers
+    // without decoding (or even touching) the column data
+    const bool useMeans = span / points >= CHUNK_SAMPLES;
+
+    auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), first, [](uint64_t sample, const ChunkRef &chunk)
+                               { return sample < chunk.firstSample + chunk.sampleCount; });
+    std::vector<float> column;
+    for (; it != m_chunks.end() && it->firstSample < last && EnsureMapped(); ++it)
+    {
+        const uint64_t chunkEnd = it->firstSample + it->sampleCount;
+        if (useMeans && it->firstSample >= first && chunkEnd <= last)
+        {
+            ChunkHeader header;
+            std::memcpy(&header, m_map.GetData() + it->offset, sizeof(header));
+            size_t bucket = bucketOf(it->firstSample + it->sampleCount / 2);
+            sums[bucket] += static_cast<double>(header.columnMean[resource]) * it->sampleCount;
+            counts[bucket] += it->sampleCount;
+            continue;
+        }
+
+        DecodeColumn(*it, resource, column);
+        for (uint64_t s = std::max(first, it->firstSample); s < std::min(last, chunkEnd); ++s)
+        {
+            size_t bucket = bucketOf(s);
+            sums[bucket] += column[s - it->firstSample];
+            counts[bucket]++;
+        }
+    }
+
+    // Samples that have not reached the disk yet
+    const uint64_t stored = GetSampleCount() - m_pending.size();
+    for (uint64_t s = std::max(first, stored); s < last; ++s)
+    {
+        size_t bucket = bucketOf(s);
+        sums[bucket] += m_pending[s - stored][resource];
+        counts[bucket]++;
+    }
+
+    // Empty buckets repeat their left neighbour
+    size_t firstFilled = 0;
+    while (firstFilled < points && counts[firstFilled] == 0)
+        firstFilled++;
+    if (firstFilled == points)
+        return;
+
+    out.resize(points);
+    float value = static_cast<float>(sums[firstFilled] / counts[firstFilled]);
+    for (size_t i = 0; i < points; ++i)
+    {
+        if (counts[i] > 0)
+            value = static_cast<float>(sums[i] / counts[i]);
+        out[i] = value;
+    }
+}
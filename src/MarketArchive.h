@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Resource.h"
+
+// Persistent market history: one price sample per resource per economy
+// tick, stored on disk in fixed-size chunks. Each chunk holds one column per
+// resource, compressed with Gorilla-style XOR float encoding, plus a header
+// with the column means. Reads go through a memory mapping, and wide zooms
+// are served from the chunk headers alone, so only the chunks a query
+// actually needs are paged in and decoded.
+//
+// File layout: FileHeader, then ChunkHeader + column bytes, repeated.
+class MarketArchive
+{
+public:
+    static constexpr uint32_t CHUNK_SAMPLES = 600; // ten minutes of 1 s samples
+
+    // Opens or creates the archive and drops every sample past keepSamples,
+    // so the history matches the save it belongs to
+    bool Open(const std::string &path, uint64_t keepSamples);
+
+    // Buffers one sample; a full chunk is compressed and appended to disk
+    void Append(const std::array<float, RESOURCE_TYPE_COUNT> &prices);
+
+    // Writes the partially filled chunk, e.g. before saving the game
+    bool Flush();
+
+    uint64_t GetSampleCount() const;
+
+    // Averages samples [first, last) of one resource into at most `points`
+    // evenly sized buckets, oldest first
+    void Query(ResourceType type, uint64_t first, uint64_t last, size_t points, std::vector<float> &out) const;
+
+private:
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t resourceCount;
+        uint32_t reserved;
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t magic;
+        uint32_t sampleCount;
+        uint64_t firstSample;
+        uint32_t columnBytes[RESOURCE_TYPE_COUNT];
+        float columnMean[RESOURCE_TYPE_COUNT];
+    };
+
+    struct ChunkRef
+    {
+        uint64_t firstSample;
+        uint32_t sampleCount;
+        uint64_t offset; // of the ChunkHeader within the file
+    };
+
+    bool WriteChunk();
+    bool EnsureMapped() const;
+    void DecodeColumn(const ChunkRef &chunk, size_t resource, std::vector<float> &out) const;
+
+    std::string m_path;
+    std::vector<ChunkRef> m_chunks;
+    uint64_t m_fileSize = 0;
+    std::vector<std::array<float, RESOURCE_TYPE_COUNT>> m_pending; // not yet on disk
+
+    // Remapped lazily after the file grows
+    mutable MappedFile m_map;
+    mutable bool m_mapStale = true;
+};
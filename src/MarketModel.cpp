@@ -0,0 +1,176 @@
+#include "MarketModel.h"
+#include <algorithm>
+#include <cmath>
+#include "GameConstants.h"
+#include "ProductionRng.h"
+
+namespace
+{
+    struct MarketParameters
+    {
+        float referencePrice;
+        float minPrice;
+        float maxPrice;
+        float volatility;
+    };
+
+    constexpr MarketParameters GetMarketParameters(ResourceType type)
+    {
+        switch (type)
+        {
+        case ResourceType::WOOD:
+            return {GameConstants::WOOD_BASE_PRICE, 1.0f, 6.85f, GameConstants::PRICE_VOLATILITY};
+        case ResourceType::STONE:
+            return {GameConstants::STONE_BASE_PRICE, 4.0f, 12.0f, GameConstants::PRICE_VOLATILITY};
+        case ResourceType::IRON:
+            return {GameConstants::IRON_BASE_PRICE, 5.0f, 39.0f, GameConstants::PRICE_VOLATILITY};
+        case ResourceType::GOLD:
+            return {GameConstants::GOLD_BASE_PRICE, 100.0f, 500.0f, 0.05f}; // tighter than the rest
+        case ResourceType::CRYSTAL:
+            return {GameConstants::CRYSTAL_BASE_PRICE, 50.0f, 200.0f, GameConstants::PRICE_VOLATILITY};
+        case ResourceType::ENERGY:
+            return {GameConstants::ENERGY_BASE_PRICE, 10.0f, 40.0f, GameConstants::PRICE_VOLATILITY};
+        case ResourceType::DIAMOND:
+            return {GameConstants::DIAMOND_BASE_PRICE, 400.0f, 1000.0f, 0.03f}; // tighter still
+        default:
+            return {1.0f, 1.0f, 1.0f, 0.0f}; // money never moves
+        }
+    }
+
+    // Market draws use ids far above any building index, so they never
+    // share a stream with the production bonus rolls
+    constexpr uint32_t MARKET_RNG_ID = 0xFFFF0000u;
+    constexpr size_t N = RESOURCE_TYPE_COUNT;
+
+    // Two uniforms per resource: u[r] and u[N + r]
+    void DrawUniforms(uint64_t seed, uint64_t tick, float *u, size_t count)
+    {
+        uint32_t ids[2 * N];
+        for (size_t i = 0; i < count; ++i)
+            ids[i] = MARKET_RNG_ID + static_cast<uint32_t>(i);
+        ProductionRng::Uniforms(seed, tick, ids, u, count);
+    }
+
+    inline float ClampPrice(const MarketState &state, size_t r, float price)
+    {
+        return std::min(std::max(price, state.minPrice[r]), state.maxPrice[r]);
+    }
+}
+
+MarketState MarketState::CreateDefault()
+{
+    MarketState state;
+    for (size_t r = 0; r < N; ++r)
+    {
+        MarketParameters params = GetMarketParameters(static_cast<ResourceType>(r));
+        state.price[r] = params.referencePrice;
+        state.referencePrice[r] = params.referencePrice;
+        state.minPrice[r] = params.minPrice;
+        state.maxPrice[r] = params.maxPrice;
+        state.volatility[r] = params.volatility;
+        state.liquidity[r] = GameConstants::MARKET_LIQUIDITY / params.referencePrice;
+    }
+    return state;
+}
+
+float MarketState::GetQuotedPrice(ResourceType type) const
+{
+    size_t r = static_cast<size_t>(type);
+    return price[r] * std::exp(impact[r]);
+}
+
+// Integral of p * exp(-q / L) over [0, amount]; expm1 keeps small orders exact
+float MarketState::QuoteSell(ResourceType type, float amount) const
+{
+    size_t r = static_cast<size_t>(type);
+    return -GetQuotedPrice(type) * liquidity[r] * std::expm1(-amount / liquidity[r]);
+}
+
+float MarketState::QuoteBuy(ResourceType type, float amount) const
+{
+    size_t r = static_cast<size_t>(type);
+    return GetQuotedPrice(type) * liquidity[r] * std::expm1(amount / liquidity[r]);
+}
+
+void MarketState::ApplySell(ResourceType type, float amount)
+{
+    size_t r = static_cast<size_t>(type);
+    impact[r] -= amount / liquidity[r];
+    supply[r] += amount;
+}
+
+void MarketState::ApplyBuy(ResourceType type, float amount)
+{
+    size_t r = static_cast<size_t>(type);
+    impact[r] += amount / liquidity[r];
+    demand[r] += amount;
+}
+
+void MarketState::RecoverImpact(float rate)
+{
+    for (size_t r = 0; r < N; ++r)
+        impact[r] *= 1.0f - rate;
+}
+
+std::unique_ptr<MarketModel> MarketModel::Create(MarketModelType type)
+{
+    switch (type)
+    {
+    case MarketModelType::MEAN_REVERTING:
+        return std::make_unique<OrnsteinUhlenbeckMarketModel>();
+    case MarketModelType::SUPPLY_DEMAND:
+        return std::make_unique<SupplyDemandMarketModel>();
+    default:
+        return std::make_unique<RandomWalkMarketModel>();
+    }
+}
+
+void RandomWalkMarketModel::Update(MarketState &state, uint64_t seed, uint64_t tick) const
+{
+    float u[N];
+    DrawUniforms(seed, tick, u, N);
+    for (size_t r = 0; r < N; ++r)
+    {
+        float step = (2.0f * u[r] - 1.0f) * state.volatility[r];
+        state.price[r] = ClampPrice(state, r, state.price[r] * (1.0f + step));
+    }
+}
+
+void OrnsteinUhlenbeckMarketModel::Update(MarketState &state, uint64_t seed, uint64_t tick) const
+{
+    constexpr float TWO_PI = 6.28318531f;
+    // A uniform step of +-v has a standard deviation of v / sqrt(3)
+    constexpr float UNIFORM_TO_SIGMA = 0.57735027f;
+    const float decay = std::exp(-REVERSION_RATE);
+    const float noiseScale = std::sqrt((1.0f - decay * decay) / (2.0f * REVERSION_RATE));
+
+    float u[2 * N];
+    DrawUniforms(seed, tick, u, 2 * N);
+    for (size_t r = 0; r < N; ++r)
+    {
+        // Box-Muller; 1 - u lies in (0, 1], so the log stays finite
+        float z = std::sqrt(-2.0f * std::log(1.0f - u[r])) * std::cos(TWO_PI * u[N + r]);
+        float mean = std::log(state.referencePrice[r]);
+        float x = mean + (std::log(state.price[r]) - mean) * decay +
+                  state.volatility[r] * UNIFORM_TO_SIGMA * noiseScale * z;
+        state.price[r] = ClampPrice(state, r, std::exp(x));
+    }
+}
+
+void SupplyDemandMarketModel::Update(MarketState &state, uint64_t seed, uint64_t tick) const
+{
+    float u[N];
+    DrawUniforms(seed, tick, u, N);
+    for (size_t r = 0; r < N; ++r)
+    {
+        float demandValue = state.demand[r] * state.referencePrice[r];
+        float supplyValue = state.supply[r] * state.referencePrice[r];
+        float equilibrium = state.referencePrice[r] *
+                            std::pow((MARKET_DEPTH + demandValue) / (MARKET_DEPTH + supplyValue), ELASTICITY);
+        float noise = (2.0f * u[r] - 1.0f) * state.volatility[r] * NOISE_SCALE;
+        float price = state.price[r] + (equilibrium - state.price[r]) * ADJUSTMENT_RATE;
+        state.price[r] = ClampPrice(state, r, price * (1.0f + noise));
+        state.supply[r] *= FLOW_DECAY;
+        state.demand[r] *= FLOW_DECAY;
+    }
+}
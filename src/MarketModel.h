@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include "Resource.h"
+
+enum class MarketModelType
+{
+    RANDOM_WALK,
+    MEAN_REVERTING,
+    SUPPLY_DEMAND
+};
+
+// Structure-of-arrays market state, one lane per resource. MONEY is a lane
+// like any other but has zero volatility and a fixed price range, so every
+// model can sweep all lanes without branching on the resource type.
+//
+// Models move the fundamental `price`. Player trades walk a liquidity curve
+// p(q) = p * exp(-q / liquidity) on top of it, accumulated in `impact` (a
+// log-price offset) that fades back towards zero each tick. Quotes along the
+// curve are closed-form, so previewing any quantity is O(1).
+struct MarketState
+{
+    std::array<float, RESOURCE_TYPE_COUNT> price{};
+    std::array<float, RESOURCE_TYPE_COUNT> impact{};
+    std::array<float, RESOURCE_TYPE_COUNT> liquidity{};      // units that move the price by a factor e
+    std::array<float, RESOURCE_TYPE_COUNT> referencePrice{}; // long-run level
+    std::array<float, RESOURCE_TYPE_COUNT> minPrice{};
+    std::array<float, RESOURCE_TYPE_COUNT> maxPrice{};
+    std::array<float, RESOURCE_TYPE_COUNT> volatility{};     // max relative move per tick
+    std::array<float, RESOURCE_TYPE_COUNT> supply{};         // recently sold units, decaying
+    std::array<float, RESOURCE_TYPE_COUNT> demand{};         // recently bought units, decaying
+
+    static MarketState CreateDefault();
+
+    // Price the next unit trades at
+    float GetQuotedPrice(ResourceType type) const;
+
+    // Total proceeds / cost of trading `amount` units in one go
+    float QuoteSell(ResourceType type, float amount) const;
+    float QuoteBuy(ResourceType type, float amount) const;
+
+    // Moves the price along the curve and records the order flow
+    void ApplySell(ResourceType type, float amount);
+    void ApplyBuy(ResourceType type, float amount);
+
+    void RecoverImpact(float rate);
+};
+
+// Moves every resource price by one economy tick in a single batched call.
+// Random draws come from the counter-based generator keyed by (seed, tick),
+// so a replay with the same seed reproduces the same prices.
+class MarketModel
+{
+public:
+    virtual ~MarketModel() = default;
+
+    virtual MarketModelType GetType() const = 0;
+    virtual void Update(MarketState &state, uint64_t seed, uint64_t tick) const = 0;
+
+    static std::unique_ptr<MarketModel> Create(MarketModelType type);
+};
+
+// Uniform relative step of up to +-volatility, clamped to the price range.
+// This is the original behaviour of Resource::UpdatePrice.
+class RandomWalkMarketModel : public MarketModel
+{
+public:
+    MarketModelType GetType() const override { return MarketModelType::RANDOM_WALK; }
+    void Update(MarketState &state, uint64_t seed, uint64_t tick) const override;
+};
+
+// Ornstein-Uhlenbeck process on the log price, pulled back towards the
+// reference price. Uses the exact discretisation, so the stationary spread
+// does not depend on the tick length.
+class OrnsteinUhlenbeckMarketModel : public MarketModel
+{
+public:
+    static constexpr float REVERSION_RATE = 0.02f; // per tick
+
+    MarketModelType GetType() const override { return MarketModelType::MEAN_REVERTING; }
+    void Update(MarketState &state, uint64_t seed, uint64_t tick) const override;
+};
+
+// Prices chase an equilibrium set by recent player order flow: selling
+// pushes the equilibrium below the reference price, buying above it.
+class SupplyDemandMarketModel : public MarketModel
+{
+public:
+    static constexpr float MARKET_DEPTH = 2000.0f;    // $ of one-sided order flow that doubles the demand/supply ratio
+    static constexpr float ELASTICITY = 0.5f;
+    static constexpr float ADJUSTMENT_RATE = 0.1f;    // share of the gap closed per tick
+    static constexpr float FLOW_DECAY = 0.95f;        // per tick
+    static constexpr float NOISE_SCALE = 0.25f;       // of the random walk volatility
+
+    MarketModelType GetType() const override { return MarketModelType::SUPPLY_DEMAND; }
+    void Update(MarketState &state, uint64_t seed, uint64_t tick) const override;
+};
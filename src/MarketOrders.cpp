@@ -0,0 +1,80 @@
+#include "MarketOrders.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MarketOrders
+{
+    std::vector<MarketOrder> SellAll(const ResourceAmounts &holdings)
+    {
+        return SellFraction(holdings, 1.0f);
+    }
+
+    std::vector<MarketOrder> SellFraction(const ResourceAmounts &holdings, float fraction)
+    {
+        std::vector<MarketOrder> orders;
+        fraction = std::clamp(fraction, 0.0f, 1.0f);
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            ResourceType type = static_cast<ResourceType>(r);
+            float quantity = holdings[r] * fraction;
+            if (type != ResourceType::MONEY && quantity > 0.0f)
+                orders.push_back({type, quantity, OrderSide::SELL});
+        }
+        return orders;
+    }
+
+    std::vector<MarketOrder> Rebalance(const ResourceAmounts &holdings, const ResourceAmounts &targets)
+    {
+        std::vector<MarketOrder> orders;
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            ResourceType type = static_cast<ResourceType>(r);
+            float delta = std::max(targets[r], 0.0f) - holdings[r];
+            if (type == ResourceType::MONEY || delta == 0.0f)
+                continue;
+            orders.push_back({type, std::abs(delta), delta > 0.0f ? OrderSide::BUY : OrderSide::SELL});
+        }
+        return orders;
+    }
+
+    bool Net(const std::vector<MarketOrder> &orders, ResourceAmounts &net)
+    {
+        net = {};
+        for (const auto &order : orders)
+        {
+            size_t r = static_cast<size_t>(order.type);
+            if (r >= RESOURCE_TYPE_COUNT || order.type == ResourceType::MONEY ||
+                !std::isfinite(order.quantity) || order.quantity < 0.0f)
+                return false;
+            net[r] += order.side == OrderSide::BUY ? order.quantity : -order.quantity;
+        }
+        return true;
+    }
+
+    OrderReport Quote(const MarketState &market, const ResourceAmounts &holdings, const std::vector<MarketOrder> &orders)
+    {
+        OrderReport report;
+        ResourceAmounts net;
+        if (!Net(orders, net))
+            return report;
+
+        // Large orders walk the price along the liquidity curve
+        bool covered = true;
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            ResourceType type = static_cast<ResourceType>(r);
+            if (net[r] < 0.0f)
+            {
+                covered = covered && -net[r] <= holdings[r];
+                report.proceeds += market.QuoteSell(type, -net[r]);
+            }
+            else if (net[r] > 0.0f)
+            {
+                report.cost += market.QuoteBuy(type, net[r]);
+            }
+        }
+        float money = holdings[static_cast<size_t>(ResourceType::MONEY)];
+        report.accepted = covered && money + report.proceeds >= report.cost;
+        return report;
+    }
+}
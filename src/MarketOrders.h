@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "MarketModel.h"
+#include "Resource.h"
+
+enum class OrderSide
+{
+    BUY,
+    SELL
+};
+
+struct MarketOrder
+{
+    ResourceType type;
+    float quantity;
+    OrderSide side;
+};
+
+// Outcome of a batch: either every order fills or none does
+struct OrderReport
+{
+    bool accepted = false;
+    float proceeds = 0.0f;
+    float cost = 0.0f;
+};
+
+// Common batches, built from the current holdings. MONEY is never traded.
+namespace MarketOrders
+{
+    std::vector<MarketOrder> SellAll(const ResourceAmounts &holdings);
+    std::vector<MarketOrder> SellFraction(const ResourceAmounts &holdings, float fraction);
+
+    // Buys or sells the difference between holdings and targets
+    std::vector<MarketOrder> Rebalance(const ResourceAmounts &holdings, const ResourceAmounts &targets);
+
+    // Net quantity per resource (buys positive), or false if any order is
+    // malformed. Trades on the liquidity curve are path independent, so a
+    // batch costs exactly what its net quantities cost.
+    bool Net(const std::vector<MarketOrder> &orders, ResourceAmounts &net);
+
+    // Prices a batch against the market without filling it; accepted only if
+    // every sell is covered by holdings and the money covers the net cost
+    OrderReport Quote(const MarketState &market, const ResourceAmounts &holdings, const std::vector<MarketOrder> &orders);
+}
@@ -0,0 +1,596 @@
+#include "Player.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include "AllocationSolver.h"
+#include "BuildingFactory.h"
+#include "BuildingKernels.h"
+#include "GameConstants.h"
+#include "JobSystem.h"
+#include "ProductionBonus.h"
+#include "ProductionRng.h"
+
+ResourceAmounts Player::GetHoldings() const
+{
+    ResourceAmounts holdings{};
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        holdings[r] = ledger.Get(static_cast<ResourceType>(r));
+    return holdings;
+}
+
+void Player::InitializeResources()
+{
+    resources.clear();
+    resources[ResourceType::MONEY] = Resource(ResourceType::MONEY, "Money", 1.0f);
+    resources[ResourceType::WOOD] = Resource(ResourceType::WOOD, "Wood", GameConstants::WOOD_BASE_PRICE);
+    resources[ResourceType::STONE] = Resource(ResourceType::STONE, "Stone", GameConstants::STONE_BASE_PRICE);
+    resources[ResourceType::IRON] = Resource(ResourceType::IRON, "Iron", GameConstants::IRON_BASE_PRICE);
+    resources[ResourceType::GOLD] = Resource(ResourceType::GOLD, "Gold", GameConstants::GOLD_BASE_PRICE);
+    resources[ResourceType::CRYSTAL] = Resource(ResourceType::CRYSTAL, "Crystal", GameConstants::CRYSTAL_BASE_PRICE);
+    resources[ResourceType::ENERGY] = Resource(ResourceType::ENERGY, "Energy", GameConstants::ENERGY_BASE_PRICE);
+    resources[ResourceType::DIAMOND] = Resource(ResourceType::DIAMOND, "Diamond", GameConstants::DIAMOND_BASE_PRICE);
+
+    ledger.Clear();
+    ledger.Add(ResourceType::MONEY, GameConstants::STARTING_MONEY);
+}
+
+void Player::InitializeBuildingTypes()
+{
+    try
+    {
+        // Clear existing buildings
+        buildings.clear();
+        productionGraph.Invalidate();
+
+        // Get available building types from factory
+        auto buildingTypes = BuildingFactory::GetAvailableBuildingTypes();
+
+        // Create one of each building type
+        for (auto type : buildingTypes)
+        {
+            if (auto building = BuildingFactory::CreateBuilding(type))
+            {
+                buildings.push_back(std::move(building));
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::stringstream ss;
+        ss << "Failed to initialize building types: " << e.what();
+        throw std::runtime_error(ss.str());
+    }
+}
+
+void Player::InitializeProductionTypes()
+{
+    try
+    {
+        productions.clear();
+        jobs.Clear();
+        auto productionTypes = BuildingFactory::GetAvailableProductionTypes();
+        for (auto type : productionTypes)
+        {
+            if (auto production = BuildingFactory::CreateProduction(type))
+            {
+                productions.push_back(std::move(production));
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::stringstream ss;
+        ss << "Failed to initialize production types: " << e.what();
+        throw std::runtime_error(ss.str());
+    }
+}
+
+bool Player::SaveState(PlayerState &state) const
+{
+    if (buildings.size() > PlayerState::MAX_BUILDINGS)
+        return false;
+
+    state.ledger = ledger;
+    for (const auto &[type, resource] : resources)
+        state.prices[static_cast<size_t>(type)] = resource.GetBasePrice();
+    state.totalEarnings = totalEarnings;
+    state.totalSpent = totalSpent;
+    state.reputation = reputation;
+    state.achievements = achievements;
+    state.hasStocksUnlocked = hasStocksUnlocked;
+
+    state.ownedProductions = 0;
+    for (const auto &production : productions)
+    {
+        if (production && production->IsOwned())
+            state.ownedProductions |= 1u << static_cast<uint32_t>(production->GetType());
+    }
+
+    state.buildingCount = static_cast<uint32_t>(buildings.size());
+    for (size_t i = 0; i < buildings.size(); ++i)
+    {
+        const Building &building = *buildings[i];
+        auto &saved = state.buildings[i];
+        saved.efficiency = building.GetEfficiency();
+        saved.baseProductionRate = building.GetBaseProductionRate();
+        saved.maintenanceCost = building.GetMaintenanceCost();
+        saved.upgradeCost = building.GetUpgradeCost();
+        saved.level = building.GetLevel();
+        saved.priority = building.GetPriority();
+        saved.type = building.GetType();
+        saved.owned = building.IsOwned();
+        saved.operational = building.IsOperational();
+    }
+
+    // Each type's running jobs come first, so the first GetRunningCount()
+    // of a type are the running ones. A queued job like the one before it
+    // only adds to that entry's count.
+    std::array<size_t, PRODUCTION_TYPE_COUNT> seen{};
+    bool fits = true;
+    state.jobClock = jobs.GetTime();
+    state.jobCount = 0;
+    jobs.ForEachJob([&](const ProductionQueue::Job &job, float)
+    {
+        const bool running = seen[static_cast<size_t>(job.type)]++ < jobs.GetRunningCount(job.type);
+        if (!running && state.jobCount > 0)
+        {
+            auto &last = state.jobs[state.jobCount - 1];
+            if (!last.running && last.type == job.type && last.duration == job.duration && last.payout == job.payout)
+            {
+                ++last.count;
+                return;
+            }
+        }
+        if (state.jobCount == PlayerState::MAX_JOBS)
+        {
+            fits = false;
+            return;
+        }
+        auto &saved = state.jobs[state.jobCount++];
+        saved.start = running ? job.start : 0.0;
+        saved.duration = job.duration;
+        saved.payout = job.payout;
+        saved.count = 1;
+        saved.type = job.type;
+        saved.running = running;
+    });
+    if (!fits)
+        fprintf(stderr, "Production queue does not fit in a saved state: more than %zu running jobs or runs of queued ones\n",
+                PlayerState::MAX_JOBS);
+    return fits;
+}
+
+void Player::LoadState(const PlayerState &state)
+{
+    ledger = state.ledger;
+    for (auto &[type, resource] : resources)
+        resource.SetBasePrice(state.prices[static_cast<size_t>(type)]);
+    totalEarnings = state.totalEarnings;
+    totalSpent = state.totalSpent;
+    reputation = state.reputation;
+    achievements = state.achievements;
+    hasStocksUnlocked = state.hasStocksUnlocked;
+
+    for (auto &production : productions)
+    {
+        if (production)
+            production->SetOwned((state.ownedProductions >> static_cast<uint32_t>(production->GetType())) & 1u);
+    }
+
+    // Buildings of the right type are kept and overwritten; only a slot
+    // that changed type needs a new one
+    buildings.resize(state.buildingCount);
+    for (size_t i = 0; i < buildings.size(); ++i)
+    {
+        const auto &saved = state.buildings[i];
+        auto &building = buildings[i];
+        if (!building || building->GetType() != saved.type)
+            building = BuildingFactory::CreateBuilding(saved.type);
+        if (!building)
+            continue;
+
+        building->SetEfficiency(saved.efficiency);
+        building->SetBaseProductionRate(saved.baseProductionRate);
+        building->SetMaintenanceCost(saved.maintenanceCost);
+        building->SetUpgradeCost(saved.upgradeCost);
+        building->SetLevel(saved.level);
+        building->SetPriority(saved.priority);
+        building->SetOwned(saved.owned);
+        building->SetOperational(saved.operational);
+    }
+
+    // Rebuilt now rather than on the next update, which would read as a
+    // change of buildings and stop steady production
+    productionGraph.Rebuild(buildings);
+
+    jobs.Clear(state.jobClock);
+    for (size_t i = 0; i < state.jobCount; ++i)
+    {
+        const auto &saved = state.jobs[i];
+        for (uint32_t n = 0; n < saved.count; ++n)
+            jobs.Restore({saved.type, saved.duration, saved.payout, saved.start}, saved.running);
+    }
+}
+
+float Player::CalculateProductionMultiplier() const
+{
+    try
+    {
+        float multiplier = GameConstants::BASE_PRODUCTION_MULTIPLIER;
+
+        // Add reputation bonus
+        multiplier += reputation * GameConstants::REPUTATION_BONUS_MULTIPLIER;
+
+        // Add Research Lab bonus
+        for (const auto &building : buildings)
+        {
+            if (building && building->IsOwned() && building->GetType() == BuildingType::RESEARCH_LAB)
+            {
+                multiplier += GameConstants::RESEARCH_LAB_BONUS_MULTIPLIER * building->GetLevel();
+            }
+        }
+
+        return std::max(multiplier, GameConstants::BASE_PRODUCTION_MULTIPLIER);
+    }
+    catch (...)
+    {
+        return GameConstants::BASE_PRODUCTION_MULTIPLIER;
+    }
+}
+
+const Production *Player::FindProduction(ProductionType type) const
+{
+    for (const auto &production : productions)
+    {
+        if (production && production->GetType() == type)
+            return production.get();
+    }
+    return nullptr;
+}
+
+bool Player::BuildStructure(BuildingType type)
+{
+    for (auto &building : buildings)
+    {
+        if (!building || building->GetType() != type)
+            continue;
+        if (building->IsOwned() ||
+            GetMoney() < building->GetCost() ||
+            reputation < building->GetRequiredReputation())
+            return false;
+
+        ledger.Consume(ResourceType::MONEY, building->GetCost());
+        totalSpent += building->GetCost();
+        building->SetOwned(true);
+        productionGraph.Invalidate();
+
+        constexpr float STARTER_FUEL = 20.0f;
+        for (auto const &req : building->GetInputResources())
+            ledger.Add(req.GetType(), STARTER_FUEL);
+        return true;
+    }
+    return false;
+}
+
+bool Player::SellStructure(int buildingIndex)
+{
+    try
+    {
+        if (buildingIndex < 0 || buildingIndex >= static_cast<int>(buildings.size()))
+            return false;
+
+        auto &building = buildings[buildingIndex];
+        if (!building || !building->IsOwned())
+            return false;
+
+        // Return 50% of the building's cost
+        float refund = building->GetCost() * 0.5f;
+        ledger.Add(ResourceType::MONEY, refund);
+        totalEarnings += refund;
+
+        // Create a new building of the same type to replace the sold one
+        auto newBuilding = BuildingFactory::CreateBuilding(building->GetType());
+        if (newBuilding)
+        {
+            buildings[buildingIndex] = std::move(newBuilding);
+            productionGraph.Invalidate();
+            return true;
+        }
+        return false;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+bool Player::UpgradeBuilding(int buildingIndex)
+{
+    try
+    {
+        if (buildingIndex < 0 || buildingIndex >= static_cast<int>(buildings.size()))
+            return false;
+
+        auto &building = buildings[buildingIndex];
+        // A building at MAX_LEVEL would refuse the upgrade after paying
+        if (!building || !building->IsOwned() || building->GetLevel() >= Building::MAX_LEVEL)
+            return false;
+
+        if (!ledger.Consume(ResourceType::MONEY, building->GetUpgradeCost()))
+            return false;
+
+        totalSpent += building->GetUpgradeCost();
+        return building->Upgrade();
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+bool Player::BeginProduction(ProductionType type)
+{
+    try
+    {
+        const Production *production = FindProduction(type);
+        if (!production)
+            return false;
+
+        // Check if player has enough money, inputs and reputation
+        if (GetMoney() < production->GetCost() || !production->HasInputs(ledger) ||
+            reputation < production->GetRequiredReputation())
+            return false;
+
+        // Deduct cost and reserve the whole recipe; the job runs once
+        // a slot of this type is free
+        ledger.Consume(ResourceType::MONEY, production->GetCost());
+        for (const auto &in : production->GetInputs())
+            ledger.Consume(in.type, in.quantity);
+        totalSpent += production->GetCost();
+        jobs.Enqueue(type, production->GetCompletionTime(), production->GetCompletionAmount());
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+bool Player::UnlockStocks()
+{
+    if (hasStocksUnlocked || reputation < 40)
+        return false;
+    if (!ledger.Consume(ResourceType::MONEY, GameConstants::STOCK_GRAPH_UNLOCK_PRICE))
+        return false;
+
+    totalSpent += GameConstants::STOCK_GRAPH_UNLOCK_PRICE;
+    hasStocksUnlocked = true;
+    return true;
+}
+
+OrderReport Player::ExecuteOrders(MarketState &market, const std::vector<MarketOrder> &orders)
+{
+    OrderReport report = MarketOrders::Quote(market, GetHoldings(), orders);
+    if (!report.accepted)
+        return report;
+
+    ResourceAmounts net;
+    MarketOrders::Net(orders, net);
+    for (auto &[type, resource] : resources)
+    {
+        float quantity = net[static_cast<size_t>(type)];
+        if (quantity == 0.0f)
+            continue;
+
+        if (quantity > 0.0f)
+        {
+            market.ApplyBuy(type, quantity);
+            ledger.Add(type, quantity);
+        }
+        else
+        {
+            market.ApplySell(type, -quantity);
+            ledger.Consume(type, -quantity);
+        }
+        resource.SetBasePrice(market.GetQuotedPrice(type));
+    }
+
+    // One money update for the whole batch
+    ledger.Add(ResourceType::MONEY, report.proceeds - report.cost);
+    totalEarnings += report.proceeds;
+    totalSpent += report.cost;
+    return report;
+}
+
+void Player::PayMaintenance()
+{
+    float totalMaintenance = 0.0f;
+
+    // Calculate maintenance costs for owned buildings
+    for (const auto &building : buildings)
+    {
+        if (building && building->IsOwned())
+        {
+            totalMaintenance += building->GetMaintenanceCost();
+        }
+    }
+
+    // Deduct maintenance cost if player has enough money
+    if (ledger.Consume(ResourceType::MONEY, totalMaintenance))
+    {
+        totalSpent += totalMaintenance;
+    }
+    else
+    {
+        float availableMoney = GetMoney();
+        ledger.Set(ResourceType::MONEY, 0.0f);
+        totalSpent += availableMoney;
+    }
+}
+
+void Player::UpdateReputation()
+{
+    // Gain reputation based on owned buildings and their efficiency
+    int newReputation = 0;
+    for (const auto &building : buildings)
+    {
+        if (building && building->IsOwned())
+        {
+            // Base reputation gain from each building
+            newReputation += 1;
+
+            // Additional reputation for efficient buildings
+            if (building->GetEfficiency() > 0.8f)
+            {
+                newReputation += 1;
+            }
+        }
+    }
+
+    // Add reputation with diminishing returns
+    if (newReputation > 0)
+    {
+        reputation += static_cast<int>(newReputation * (100.0f / (100.0f + reputation)));
+    }
+}
+
+void Player::UpdateBuildings(float deltaTime, bool expectedValue, uint64_t seed, uint64_t tick)
+{
+    if (productionGraph.IsDirty())
+        productionGraph.Rebuild(buildings);
+
+    // Each stage shares its fuel fairly and applies its outputs in one
+    // sweep. Efficiency and production only read the holdings, so large
+    // stages compute them in chunks on the job system.
+    productionGraph.Run([&](const ProductionGraph::Stage &stage)
+    {
+        const ResourceAmounts holdings = GetHoldings();
+        AllocationSolver solver(Building::FUEL_CONSUMPTION_FACTOR);
+        solver.Resize(stage.size());
+        JobSystem::GetDefault().ParallelFor(stage.size(), GameConstants::BUILDING_CHUNK_SIZE, [&](size_t begin, size_t end)
+        {
+            BuildingBatch batch;
+            batch.Gather(buildings, stage.data() + begin, end - begin, holdings);
+            batch.UpdateEfficiency(deltaTime);
+            if (expectedValue)
+                batch.CalculateExpectedProduction(deltaTime);
+            else
+                batch.CalculateProduction(deltaTime, seed, tick);
+
+            for (size_t i = 0; i < batch.GetCount(); ++i)
+                solver.Set(begin + i, batch.GetBuilding(i), batch.GetProduction(i));
+        });
+        solver.Resolve(ledger);
+    });
+}
+
+void Player::UpdateResources(float deltaTime)
+{
+    float productionMultiplier = CalculateProductionMultiplier();
+
+    if (productionGraph.IsDirty())
+        productionGraph.Rebuild(buildings);
+
+    // Walk the graph so a consumer only draws once its producers have run;
+    // buildings within a stage split scarce inputs instead of racing for them
+    productionGraph.Run([&](const ProductionGraph::Stage &stage)
+    {
+        AllocationSolver solver;
+        solver.Reserve(stage.size());
+        for (size_t index : stage)
+        {
+            const auto &building = buildings[index];
+            float raw = building->GetBaseProductionRate() * building->GetEfficiency() * deltaTime * productionMultiplier;
+            solver.Request(*building, raw);
+        }
+        solver.Resolve(ledger);
+    });
+}
+
+void Player::AdvanceJobs(float deltaTime)
+{
+    // Pay out the production jobs that finished this frame, summed
+    // per resource so the ledger sees one deposit each
+    m_completedJobs.clear();
+    jobs.Advance(deltaTime, m_completedJobs);
+    if (m_completedJobs.empty())
+        return;
+
+    ResourceAmounts deposits{};
+    for (const auto &job : m_completedJobs)
+    {
+        deposits[static_cast<size_t>(ResourceType::MONEY)] += job.payout;
+        if (const Production *production = FindProduction(job.type))
+        {
+            for (const auto &out : production->GetOutputs())
+                deposits[static_cast<size_t>(out.type)] += out.quantity;
+        }
+    }
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        if (deposits[r] > 0.0f)
+            ledger.Add(static_cast<ResourceType>(r), deposits[r]);
+    }
+}
+
+void Player::SettleBonusRolls(uint64_t seed, uint64_t fromTick, uint64_t toTick, float elapsed)
+{
+    if (toTick <= fromTick)
+        return;
+
+    // Only buildings that can roll a bonus leave a remainder
+    std::vector<uint32_t> ids;
+    std::vector<float> chance;
+    std::vector<float> multiplier;
+    for (size_t i = 0; i < buildings.size(); ++i)
+    {
+        const Building &building = *buildings[i];
+        if (!building.IsOwned() || !building.IsOperational() || building.GetOutputResources().empty())
+            continue;
+        if (GetProductionBonusChance(building.GetType(), building.GetLevel()) <= 0.0f)
+            continue;
+        ids.push_back(static_cast<uint32_t>(i));
+        chance.push_back(GetProductionBonusChance(building.GetType(), building.GetLevel()));
+        multiplier.push_back(GetProductionBonus(building.GetType()).multiplier);
+    }
+    if (ids.empty())
+        return;
+
+    const uint64_t ticks = toTick - fromTick;
+    std::vector<float> bonus(ids.size());
+    std::vector<float> rolled(ids.size(), 0.0f);
+    for (uint64_t tick = fromTick + 1; tick <= toTick; ++tick)
+    {
+        ProductionRng::RollBonuses(seed, tick, ids.data(), chance.data(), multiplier.data(), bonus.data(), ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            rolled[i] += bonus[i];
+    }
+
+    // A roll scales the building's output and its fuel draw alike
+    const float tickTime = elapsed / static_cast<float>(ticks);
+    ResourceAmounts remainder{};
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        const Building &building = *buildings[ids[i]];
+        const float average = GetExpectedProductionBonus(building.GetType(), building.GetLevel()) * static_cast<float>(ticks);
+        const float extra = (rolled[i] - average) * building.GetBaseProductionRate() * tickTime;
+        for (const auto &out : building.GetOutputResources())
+            remainder[static_cast<size_t>(out.GetType())] += extra * out.GetProductionRate();
+        for (const auto &in : building.GetInputResources())
+            remainder[static_cast<size_t>(in.GetType())] -= extra * in.GetProductionRate() * Building::FUEL_CONSUMPTION_FACTOR;
+    }
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        if (remainder[r] > 0.0f)
+            ledger.Add(static_cast<ResourceType>(r), remainder[r]);
+        else if (remainder[r] < 0.0f)
+            ledger.ConsumeUpTo(static_cast<ResourceType>(r), -remainder[r]);
+    }
+}
+
+void Player::SyncPrices(const MarketState &market)
+{
+    for (auto &[type, resource] : resources)
+        resource.SetBasePrice(market.GetQuotedPrice(type));
+}
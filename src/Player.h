@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Building.h"
+#include "FixedAmount.h"
+#include "GameState.h"
+#include "MarketModel.h"
+#include "MarketOrders.h"
+#include "Production.h"
+#include "ProductionGraph.h"
+#include "ProductionQueue.h"
+#include "Resource.h"
+#include "ResourceLedger.h"
+
+// One empire: its holdings, buildings and investments, and the rules that
+// only touch those. TycoonGame runs a single player; a World runs many that
+// meet only in the market.
+class Player
+{
+public:
+    std::string name;
+    ResourceLedger ledger;                       // every amount, money included
+    std::map<ResourceType, Resource> resources;  // names and market prices
+    std::vector<std::unique_ptr<Production>> productions;
+    ProductionQueue jobs;                        // running and queued investments
+    std::vector<std::unique_ptr<Building>> buildings;
+    ProductionGraph productionGraph;             // owned buildings, producers first
+    int reputation;
+    FixedAmount totalEarnings;
+    FixedAmount totalSpent;
+    int achievements;
+    bool hasStocksUnlocked = false;
+
+    float GetMoney() const { return ledger.Get(ResourceType::MONEY); }
+    ResourceAmounts GetHoldings() const;
+
+    // Starting state: every resource at zero but the starting money, one
+    // unowned building of each type and one template per production type
+    void InitializeResources();
+    void InitializeBuildingTypes();
+    void InitializeProductionTypes();
+
+    // Flat copy of everything that changes in play; false, leaving the
+    // state incomplete, when it holds fewer buildings or jobs than this
+    bool SaveState(PlayerState &state) const;
+
+    // Takes a saved state back. Definitions come from BuildingFactory, so
+    // the player must have been initialized first.
+    void LoadState(const PlayerState &state);
+
+    float CalculateProductionMultiplier() const;
+    const Production *FindProduction(ProductionType type) const;
+
+    // Actions; each returns false, changing nothing, when not allowed or
+    // not affordable
+    bool BuildStructure(BuildingType type);
+    bool SellStructure(int buildingIndex);
+    bool UpgradeBuilding(int buildingIndex);
+    bool BeginProduction(ProductionType type);
+    bool UnlockStocks();
+
+    // Fills the whole batch against the market or none of it
+    OrderReport ExecuteOrders(MarketState &market, const std::vector<MarketOrder> &orders);
+
+    // Per-tick rules
+    void PayMaintenance();
+    void UpdateReputation();
+    void UpdateBuildings(float deltaTime, bool expectedValue, uint64_t seed, uint64_t tick);
+    void UpdateResources(float deltaTime);
+    void AdvanceJobs(float deltaTime);
+    void SyncPrices(const MarketState &market);
+
+    // While production runs as ledger rates at the average bonus, deposits
+    // what the bonus rolls of ticks (fromTick, toTick] made above or below
+    // that average, rolled exactly as UpdateBuildings would have rolled them.
+    // elapsed is the game time those ticks covered.
+    void SettleBonusRolls(uint64_t seed, uint64_t fromTick, uint64_t toTick, float elapsed);
+
+private:
+    std::vector<ProductionQueue::Job> m_completedJobs;
+};
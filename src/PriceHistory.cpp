@@ -0,0 +1,54 @@
+#include "PriceHistory.h"
+#include <algorithm>
+
+PriceHistory::PriceHistory()
+    : m_samples(RESOLUTION_COUNT * RESOURCE_TYPE_COUNT * CAPACITY, 0.0f)
+{
+}
+
+void PriceHistory::Clear()
+{
+    std::fill(m_samples.begin(), m_samples.end(), 0.0f);
+    m_tiers = {};
+}
+
+void PriceHistory::Record(const std::array<float, RESOURCE_TYPE_COUNT> &prices)
+{
+    Append(0, prices);
+}
+
+void PriceHistory::Append(size_t tier, const std::array<float, RESOURCE_TYPE_COUNT> &values)
+{
+    Tier &t = m_tiers[tier];
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        Buffer(tier, r)[t.head] = values[r];
+    t.head = (t.head + 1) % CAPACITY;
+    t.count = std::min(t.count + 1, CAPACITY);
+
+    if (tier + 1 >= RESOLUTION_COUNT)
+        return;
+
+    // Downsample into the next tier once a full bucket has accumulated
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        t.sums[r] += values[r];
+    if (++t.pending < SAMPLES_PER_BUCKET)
+        return;
+
+    std::array<float, RESOURCE_TYPE_COUNT> averages;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        averages[r] = static_cast<float>(t.sums[r] / SAMPLES_PER_BUCKET);
+    t.sums = {};
+    t.pending = 0;
+    Append(tier + 1, averages);
+}
+
+PriceHistory::Series PriceHistory::GetSeries(ResourceType type, Resolution resolution) const
+{
+    size_t tier = static_cast<size_t>(resolution);
+    const Tier &t = m_tiers[tier];
+    Series series;
+    series.data = Buffer(tier, static_cast<size_t>(type));
+    series.count = static_cast<int>(t.count);
+    series.offset = t.count < CAPACITY ? 0 : static_cast<int>(t.head);
+    return series;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "Resource.h"
+
+// Market price time series owned by the simulation. Samples are recorded
+// once per economy tick into fixed-capacity ring buffers, one per resource
+// and resolution tier, all stored in one contiguous block. Every 60 samples
+// of a tier are averaged into one sample of the next, coarser tier.
+class PriceHistory
+{
+public:
+    enum class Resolution
+    {
+        SECOND,
+        MINUTE,
+        HOUR
+    };
+
+    static constexpr size_t RESOLUTION_COUNT = 3;
+    static constexpr size_t CAPACITY = 60;            // samples kept per tier
+    static constexpr size_t SAMPLES_PER_BUCKET = 60;  // fine samples per coarse sample
+
+    // View over one ring buffer, laid out for ImGui::PlotLines: the oldest
+    // sample sits at `offset` and the data wraps around at `count`
+    struct Series
+    {
+        const float *data;
+        int count;
+        int offset;
+    };
+
+    PriceHistory();
+
+    void Clear();
+
+    // O(1) per resource; call once per second with the current prices
+    void Record(const std::array<float, RESOURCE_TYPE_COUNT> &prices);
+
+    Series GetSeries(ResourceType type, Resolution resolution) const;
+
+private:
+    struct Tier
+    {
+        size_t head = 0;  // next slot to write
+        size_t count = 0; // valid samples, up to CAPACITY
+        size_t pending = 0;
+        std::array<double, RESOURCE_TYPE_COUNT> sums{};
+    };
+
+    void Append(size_t tier, const std::array<float, RESOURCE_TYPE_COUNT> &values);
+    float *Buffer(size_t tier, size_t resource) { return &m_samples[(tier * RESOURCE_TYPE_COUNT + resource) * CAPACITY]; }
+    const float *Buffer(size_t tier, size_t resource) const { return &m_samples[(tier * RESOURCE_TYPE_COUNT + resource) * CAPACITY]; }
+
+    std::vector<float> m_samples;
+    std::array<Tier, RESOLUTION_COUNT> m_tiers;
+};
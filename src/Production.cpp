@@ -1,15 +1,34 @@
 #include "Production.h"
 #include <algorithm>
+#include "ResourceLedger.h"
 
 Production::Production(ProductionType type,
                         const std::string &name,
                         float cost,
-                        const std::vector<Resource>& inputResources,
-                        const std::vector<Resource>& outputResources,
-                        float time,
+                        const std::vector<RecipeEntry>& inputs,
+                        const std::vector<RecipeEntry>& outputs,
                         float completionTime,
                         float completionAmount,
                         int requiredReputation)
-    : m_type(type), m_name(name), m_cost(cost), m_inputResources(inputResources), m_outputResources(outputResources), m_currentTime(time), m_completionTime(completionTime), m_completionAmount(completionAmount), m_requiredReputation(requiredReputation), m_invested(false), m_isOwned(false)
+    : m_type(type), m_name(name), m_cost(cost), m_inputs(inputs), m_outputs(outputs), m_completionTime(completionTime), m_completionAmount(completionAmount), m_requiredReputation(requiredReputation), m_isOwned(false)
 {
-}
\ No newline at end of file
+}
+
+void Production::CopyState(const Production &from)
+{
+    m_cost = from.m_cost;
+    m_completionTime = from.m_completionTime;
+    m_completionAmount = from.m_completionAmount;
+    m_isOwned = from.m_isOwned;
+    m_requiredReputation = from.m_requiredReputation;
+}
+
+bool Production::HasInputs(const ResourceLedger &ledger) const
+{
+    for (const auto &in : m_inputs)
+    {
+        if (ledger.Get(in.type) < in.quantity)
+            return false;
+    }
+    return true;
+}
@@ -3,6 +3,8 @@
 #include <vector>
 #include "Resource.h"
 
+class ResourceLedger;
+
 // Production type enum
 enum class ProductionType
 {
@@ -12,15 +14,23 @@ enum class ProductionType
     JEWELRY
 };
 
+constexpr size_t PRODUCTION_TYPE_COUNT = static_cast<size_t>(ProductionType::JEWELRY) + 1;
+
+// One line of a recipe: how many units of a resource one job takes or makes
+struct RecipeEntry
+{
+    ResourceType type;
+    float quantity;
+};
+
 class Production
 {
 public:
     Production(ProductionType type,
                 const std::string &name,
                 float cost,
-                const std::vector<Resource>& inputResources,
-                const std::vector<Resource>& outputResources,
-                float time,
+                const std::vector<RecipeEntry>& inputs,
+                const std::vector<RecipeEntry>& outputs,
                 float completionTime,
                 float compeltionAmount,
                 int requiredReputation = 0);
@@ -30,35 +40,39 @@ public:
     ProductionType GetType() const { return m_type; }
     const std::string &GetName() const { return m_name; }
     float GetCost() const { return m_cost; }
-    float GetTime() const { return m_currentTime; }
     float GetCompletionTime() const { return m_completionTime; }
     float GetCompletionAmount() const { return m_completionAmount; }
     bool IsOwned() const { return m_isOwned; }
     int GetRequiredReputation() const { return m_requiredReputation; }
-    int IsInvested() const { return m_invested; }
-    
+
+    // Recipe of one job: inputs are reserved when the job is queued,
+    // outputs are deposited when it completes (on top of the completion
+    // amount in money)
+    const std::vector<RecipeEntry> &GetInputs() const { return m_inputs; }
+    const std::vector<RecipeEntry> &GetOutputs() const { return m_outputs; }
+    bool HasInputs(const ResourceLedger &ledger) const;
 
     // Setters
-    void SetTime(float amount) { m_currentTime = amount; }
     void SetCompletionTime(float price) { m_completionTime = price; }
     void SetOwned(bool owned) { m_isOwned = owned; }
-    void SetIsInvested(bool invested) { m_invested = invested; }
     void SetCost(float cost) { m_cost = cost; }
     void SetCompletionAmount(float amount) { m_completionAmount = amount; }
     void SetRequiredReputation(int reputation) { m_requiredReputation = reputation; }
 
+    // Takes every value of a production of the same type, leaving the name
+    // and recipe, which the type fixes, untouched
+    void CopyState(const Production &from);
+
 
 protected:
     ProductionType m_type;
     std::string m_name;
     float m_cost;
-    float m_currentTime;
     float m_completionTime;
     float m_completionAmount;
-    std::vector<Resource> m_inputResources;
-    std::vector<Resource> m_outputResources;
+    std::vector<RecipeEntry> m_inputs;
+    std::vector<RecipeEntry> m_outputs;
     bool m_isOperational;
     bool m_isOwned = false;
     int m_requiredReputation;
-    bool m_invested;
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "Building.h"
+
+// Per-frame chance for a building to produce extra output: the chance grows
+// with level, the multiplier is fixed per building type
+struct ProductionBonus
+{
+    float chancePerLevel;
+    float multiplier;
+};
+
+constexpr ProductionBonus GetProductionBonus(BuildingType type)
+{
+    switch (type)
+    {
+    case BuildingType::WOODCUTTER:
+        return {0.05f, 1.5f}; // 5% per level for 50% bonus wood
+    case BuildingType::MINE:
+        return {0.03f, 2.0f}; // 3% per level for a rare double yield
+    case BuildingType::CRYSTAL_MINE:
+        return {0.02f, 3.0f}; // 2% per level for a crystal vein
+    case BuildingType::POWER_PLANT:
+        return {0.04f, 1.75f}; // 4% per level for extra output
+    default:
+        return {0.0f, 1.0f};
+    }
+}
+
+constexpr float GetProductionBonusChance(BuildingType type, int level)
+{
+    return level * GetProductionBonus(type).chancePerLevel;
+}
+
+// Long-run average multiplier, used instead of rolling in expected-value mode
+constexpr float CalculateExpectedProductionBonus(BuildingType type, int level)
+{
+    ProductionBonus bonus = GetProductionBonus(type);
+    float chance = GetProductionBonusChance(type, level);
+    chance = chance < 0.0f ? 0.0f : (chance > 1.0f ? 1.0f : chance);
+    return 1.0f + chance * (bonus.multiplier - 1.0f);
+}
+
+struct ExpectedProductionBonusTable
+{
+    float values[BUILDING_TYPE_COUNT][Building::MAX_LEVEL + 1];
+};
+
+constexpr ExpectedProductionBonusTable MakeExpectedProductionBonusTable()
+{
+    ExpectedProductionBonusTable table{};
+    for (size_t type = 0; type < BUILDING_TYPE_COUNT; ++type)
+    {
+        for (int level = 0; level <= Building::MAX_LEVEL; ++level)
+            table.values[type][level] = CalculateExpectedProductionBonus(static_cast<BuildingType>(type), level);
+    }
+    return table;
+}
+
+inline constexpr ExpectedProductionBonusTable EXPECTED_PRODUCTION_BONUS = MakeExpectedProductionBonusTable();
+
+constexpr float GetExpectedProductionBonus(BuildingType type, int level)
+{
+    level = level < 0 ? 0 : (level > Building::MAX_LEVEL ? Building::MAX_LEVEL : level);
+    return EXPECTED_PRODUCTION_BONUS.values[static_cast<size_t>(type)][level];
+}
+
+static_assert(GetExpectedProductionBonus(BuildingType::WOODCUTTER, 1) == 1.0f + 0.05f * 0.5f,
+              "Woodcutter L1 should average a 5% chance of 1.5x");
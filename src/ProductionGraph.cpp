@@ -0,0 +1,208 @@
+#include "ProductionGraph.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include "GameConstants.h"
+#include "JobSystem.h"
+
+void ProductionGraph::Rebuild(const std::vector<std::unique_ptr<Building>> &buildings)
+{
+    m_subgraphs.clear();
+    m_dirty = false;
+
+    // Only owned, operational buildings take part in production
+    std::vector<size_t> nodes;
+    for (size_t i = 0; i < buildings.size(); ++i)
+    {
+        if (buildings[i] && buildings[i]->IsOwned() && buildings[i]->IsOperational())
+            nodes.push_back(i);
+    }
+    m_nodeCount = nodes.size();
+    if (nodes.empty())
+        return;
+
+    // Bipartite graph: building -> output resource, input resource -> building.
+    // This keeps the edge count linear in the number of buildings.
+    const int buildingCount = static_cast<int>(nodes.size());
+    const int nodeCount = buildingCount + static_cast<int>(RESOURCE_TYPE_COUNT);
+    auto resourceNode = [buildingCount](ResourceType type)
+    { return buildingCount + static_cast<int>(type); };
+
+    std::vector<std::vector<int>> edges(nodeCount);
+    for (int b = 0; b < buildingCount; ++b)
+    {
+        const auto &building = buildings[nodes[b]];
+        for (const auto &out : building->GetOutputResources())
+            edges[b].push_back(resourceNode(out.GetType()));
+        for (const auto &in : building->GetInputResources())
+            edges[resourceNode(in.GetType())].push_back(b);
+    }
+
+    // Strongly connected components (iterative Tarjan). Components are
+    // numbered in reverse topological order.
+    std::vector<int> index(nodeCount, -1), low(nodeCount, 0), component(nodeCount, -1);
+    std::vector<int> sccStack;
+    std::vector<bool> onStack(nodeCount, false);
+    std::vector<std::pair<int, size_t>> callStack;
+    int counter = 0;
+    int componentCount = 0;
+
+    for (int start = 0; start < nodeCount; ++start)
+    {
+        if (index[start] != -1)
+            continue;
+
+        index[start] = low[start] = counter++;
+        sccStack.push_back(start);
+        onStack[start] = true;
+        callStack.emplace_back(start, 0);
+
+        while (!callStack.empty())
+        {
+            int v = callStack.back().first;
+            size_t &edge = callStack.back().second;
+            if (edge < edges[v].size())
+            {
+                int w = edges[v][edge++];
+                if (index[w] == -1)
+                {
+                    index[w] = low[w] = counter++;
+                    sccStack.push_back(w);
+                    onStack[w] = true;
+                    callStack.emplace_back(w, 0);
+                }
+                else if (onStack[w])
+                {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            if (low[v] == index[v])
+            {
+                int w;
+                do
+                {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[w] = false;
+                    component[w] = componentCount;
+                } while (w != v);
+                componentCount++;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty())
+            {
+                int parent = callStack.back().first;
+                low[parent] = std::min(low[parent], low[v]);
+            }
+        }
+    }
+
+    // Longest-path depth over the condensed DAG, walked in topological order
+    std::vector<std::vector<int>> members(componentCount);
+    for (int v = 0; v < nodeCount; ++v)
+        members[component[v]].push_back(v);
+
+    std::vector<int> depth(componentCount, 0);
+    for (int c = componentCount - 1; c >= 0; --c)
+    {
+        for (int v : members[c])
+        {
+            for (int w : edges[v])
+            {
+                if (component[w] != c)
+                    depth[component[w]] = std::max(depth[component[w]], depth[c] + 1);
+            }
+        }
+    }
+
+    // Weakly connected components: buildings that never share a resource
+    // can be evaluated independently.
+    std::vector<int> parent(nodeCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int v)
+    {
+        while (parent[v] != v)
+        {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+    for (int v = 0; v < nodeCount; ++v)
+    {
+        for (int w : edges[v])
+            parent[find(v)] = find(w);
+    }
+
+    // Inside a cycle there is no true producer; run the buildings fed by
+    // earlier stages first (the Power Plant before the Mine it powers).
+    auto externalFeedRatio = [&](int b)
+    {
+        const auto &inputs = buildings[nodes[b]]->GetInputResources();
+        if (inputs.empty())
+            return 1.0f;
+        int external = 0;
+        for (const auto &in : inputs)
+        {
+            if (component[resourceNode(in.GetType())] != component[b])
+                external++;
+        }
+        return static_cast<float>(external) / inputs.size();
+    };
+
+    std::map<int, size_t> subgraphOfRoot;
+    std::vector<std::map<int, Stage>> stagesByDepth;
+    for (int b = 0; b < buildingCount; ++b)
+    {
+        int root = find(b);
+        auto it = subgraphOfRoot.find(root);
+        if (it == subgraphOfRoot.end())
+        {
+            it = subgraphOfRoot.emplace(root, stagesByDepth.size()).first;
+            stagesByDepth.emplace_back();
+        }
+        stagesByDepth[it->second][depth[component[b]]].push_back(static_cast<size_t>(b));
+    }
+
+    m_subgraphs.reserve(stagesByDepth.size());
+    for (auto &stages : stagesByDepth)
+    {
+        Subgraph subgraph;
+        for (auto &[d, stage] : stages)
+        {
+            std::stable_sort(stage.begin(), stage.end(), [&](size_t a, size_t b)
+                             { return externalFeedRatio(static_cast<int>(a)) > externalFeedRatio(static_cast<int>(b)); });
+            for (auto &b : stage)
+                b = nodes[b];
+            subgraph.push_back(std::move(stage));
+        }
+        m_subgraphs.push_back(std::move(subgraph));
+    }
+}
+
+void ProductionGraph::Run(const std::function<void(const Stage &)> &fn) const
+{
+    auto runSubgraph = [&fn](const Subgraph &subgraph)
+    {
+        for (const auto &stage : subgraph)
+            fn(stage);
+    };
+
+    if (m_subgraphs.size() <= 1 || m_nodeCount < GameConstants::PARALLEL_SUBGRAPH_MIN_BUILDINGS)
+    {
+        for (const auto &subgraph : m_subgraphs)
+            runSubgraph(subgraph);
+        return;
+    }
+
+    // Subgraphs touch disjoint resources, so they can run concurrently;
+    // their stages may split further into chunks on the same pool
+    JobSystem::GetDefault().ParallelFor(m_subgraphs.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t s = begin; s < end; ++s)
+            runSubgraph(m_subgraphs[s]);
+    });
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include "Building.h"
+
+// Orders owned buildings by their resource dependencies so producers are
+// evaluated before consumers (e.g. Woodcutter -> Power Plant -> Mine).
+// The graph is rebuilt only after Invalidate() is called, i.e. when a
+// building is built, sold or the building list is reloaded.
+class ProductionGraph
+{
+public:
+    // Buildings (indices into Player::buildings) that can run once every
+    // earlier stage has run. Buildings that feed each other in a cycle
+    // (Power Plant <-> Mine via Stone/Energy) share a stage.
+    using Stage = std::vector<size_t>;
+
+    // A set of stages sharing no resource with any other subgraph.
+    using Subgraph = std::vector<Stage>;
+
+    void Invalidate() { m_dirty = true; }
+    bool IsDirty() const { return m_dirty; }
+
+    void Rebuild(const std::vector<std::unique_ptr<Building>> &buildings);
+
+    // Calls fn for every stage in producer-before-consumer order.
+    // Independent subgraphs are run on worker threads once the graph is large
+    // enough for that to pay off.
+    void Run(const std::function<void(const Stage &)> &fn) const;
+
+    const std::vector<Subgraph> &GetSubgraphs() const { return m_subgraphs; }
+    size_t GetNodeCount() const { return m_nodeCount; }
+
+private:
+    std::vector<Subgraph> m_subgraphs;
+    size_t m_nodeCount = 0;
+    bool m_dirty = true;
+};
@@ -0,0 +1,130 @@
+#include "ProductionQueue.h"
+#include <cmath>
+#include "GameConstants.h"
+
+ProductionQueue::ProductionQueue()
+{
+    for (auto &queue : m_types)
+        queue.concurrency = GameConstants::PRODUCTION_CONCURRENT_JOBS;
+}
+
+void ProductionQueue::Clear(double time)
+{
+    m_jobs.clear();
+    m_finished.clear();
+    m_free.clear();
+    for (auto &queue : m_types)
+    {
+        queue.runningCount = 0;
+        queue.running.clear();
+        queue.waiting.clear();
+    }
+    m_wheel.Reset(static_cast<uint64_t>(std::floor(time * TICKS_PER_SECOND)));
+    m_time = time;
+}
+
+void ProductionQueue::SetConcurrency(ProductionType type, size_t jobs)
+{
+    auto &queue = m_types[static_cast<size_t>(type)];
+    queue.concurrency = jobs;
+    while (queue.runningCount < queue.concurrency && !queue.waiting.empty())
+    {
+        uint32_t next = queue.waiting.front();
+        queue.waiting.pop_front();
+        Start(next, m_time);
+    }
+}
+
+void ProductionQueue::Enqueue(ProductionType type, float duration, float payout, float elapsed)
+{
+    uint32_t id = Allocate({type, duration, payout, 0.0});
+    auto &queue = m_types[static_cast<size_t>(type)];
+    if (queue.runningCount < queue.concurrency)
+        Start(id, m_time - elapsed);
+    else
+        queue.waiting.push_back(id);
+}
+
+void ProductionQueue::Restore(const Job &job, bool running)
+{
+    uint32_t id = Allocate(job);
+    if (running)
+        Start(id, job.start);
+    else
+        m_types[static_cast<size_t>(job.type)].waiting.push_back(id);
+}
+
+void ProductionQueue::Advance(double deltaTime, std::vector<Job> &completed)
+{
+    m_time += deltaTime;
+    m_expired.clear();
+    m_wheel.Advance(static_cast<uint64_t>(std::floor(m_time * TICKS_PER_SECOND)), m_expired);
+
+    for (uint32_t id : m_expired)
+    {
+        const Job job = m_jobs[id];
+        m_finished[id] = true;
+        completed.push_back(job);
+
+        auto &queue = m_types[static_cast<size_t>(job.type)];
+        queue.runningCount--;
+        while (!queue.running.empty() && m_finished[queue.running.front()])
+        {
+            m_free.push_back(queue.running.front());
+            queue.running.pop_front();
+        }
+
+        // The next job takes over the slot from the moment it was freed
+        if (!queue.waiting.empty() && queue.runningCount < queue.concurrency)
+        {
+            uint32_t next = queue.waiting.front();
+            queue.waiting.pop_front();
+            Start(next, job.start + job.duration);
+        }
+    }
+}
+
+const ProductionQueue::Job *ProductionQueue::GetLeadingJob(ProductionType type) const
+{
+    const auto &queue = m_types[static_cast<size_t>(type)];
+    return queue.running.empty() ? nullptr : &m_jobs[queue.running.front()];
+}
+
+void ProductionQueue::ForEachJob(const std::function<void(const Job &, float elapsed)> &fn) const
+{
+    for (const auto &queue : m_types)
+    {
+        for (uint32_t id : queue.running)
+        {
+            if (!m_finished[id])
+                fn(m_jobs[id], GetElapsed(m_jobs[id]));
+        }
+        for (uint32_t id : queue.waiting)
+            fn(m_jobs[id], 0.0f);
+    }
+}
+
+uint32_t ProductionQueue::Allocate(const Job &job)
+{
+    if (!m_free.empty())
+    {
+        uint32_t id = m_free.back();
+        m_free.pop_back();
+        m_jobs[id] = job;
+        m_finished[id] = false;
+        return id;
+    }
+    m_jobs.push_back(job);
+    m_finished.push_back(false);
+    return static_cast<uint32_t>(m_jobs.size() - 1);
+}
+
+void ProductionQueue::Start(uint32_t id, double start)
+{
+    Job &job = m_jobs[id];
+    job.start = start;
+    auto &queue = m_types[static_cast<size_t>(job.type)];
+    queue.running.push_back(id);
+    queue.runningCount++;
+    m_wheel.Schedule(static_cast<uint64_t>(std::ceil((start + job.duration) * TICKS_PER_SECOND)), id);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "Production.h"
+#include "TimerWheel.h"
+
+// Investment jobs for every production type. Each type runs up to its
+// concurrency limit at once; further jobs wait in a FIFO and start as
+// running ones finish. Completions are scheduled on a timer wheel keyed by
+// end time, so a frame costs O(completions) however many jobs are in flight.
+class ProductionQueue
+{
+public:
+    static constexpr double TICKS_PER_SECOND = 100.0;
+
+    struct Job
+    {
+        ProductionType type;
+        float duration;
+        float payout;
+        double start; // queue time the job started running
+    };
+
+    ProductionQueue();
+
+    // Drops every job and sets the queue clock to `time`
+    void Clear(double time = 0.0);
+    double GetTime() const { return m_time; }
+
+    void SetConcurrency(ProductionType type, size_t jobs);
+    size_t GetConcurrency(ProductionType type) const { return m_types[static_cast<size_t>(type)].concurrency; }
+
+    // Starts right away if a slot of that type is free, otherwise queues.
+    // `elapsed` resumes a job that was already partly done (loading saves).
+    void Enqueue(ProductionType type, float duration, float payout, float elapsed = 0.0f);
+
+    // Puts a job back exactly as it was: running since job.start or queued.
+    // Restoring the ForEachJob() order after Clear() at the saved clock
+    // rebuilds a queue that finishes the same jobs on the same ticks.
+    void Restore(const Job &job, bool running);
+
+    // Advances the queue clock and appends every job finished by then to
+    // `completed`, freeing its slot for the next queued job of that type
+    void Advance(double deltaTime, std::vector<Job> &completed);
+
+    size_t GetRunningCount(ProductionType type) const { return m_types[static_cast<size_t>(type)].runningCount; }
+    size_t GetQueuedCount(ProductionType type) const { return m_types[static_cast<size_t>(type)].waiting.size(); }
+    size_t GetJobCount() const { return m_jobs.size() - m_free.size(); }
+
+    // Earliest-started running job of a type, or nullptr
+    const Job *GetLeadingJob(ProductionType type) const;
+    float GetElapsed(const Job &job) const { return static_cast<float>(m_time - job.start); }
+
+    // Running jobs in start order, then queued ones in FIFO order, per type;
+    // enqueuing them again in this order rebuilds the same queue
+    void ForEachJob(const std::function<void(const Job &, float elapsed)> &fn) const;
+
+private:
+    struct TypeQueue
+    {
+        size_t concurrency;
+        size_t runningCount = 0;
+        std::deque<uint32_t> running; // start order; finished ones are dropped from the front
+        std::deque<uint32_t> waiting;
+    };
+
+    uint32_t Allocate(const Job &job);
+    void Start(uint32_t id, double start);
+
+    std::vector<Job> m_jobs;
+    std::vector<bool> m_finished;
+    std::vector<uint32_t> m_free;
+    std::array<TypeQueue, PRODUCTION_TYPE_COUNT> m_types;
+    TimerWheel m_wheel;
+    std::vector<uint32_t> m_expired;
+    double m_time = 0.0;
+};
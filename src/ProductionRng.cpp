@@ -0,0 +1,158 @@
+#include "ProductionRng.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TYCOON_RNG_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+    constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+    constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+    constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+    constexpr int PHILOX_ROUNDS = 10;
+
+    // 24 random bits map exactly onto the float mantissa
+    constexpr float UNIT_SCALE = 1.0f / 16777216.0f;
+
+    uint32_t Philox(uint32_t id, uint64_t tick, uint64_t seed)
+    {
+        uint32_t c0 = id;
+        uint32_t c1 = static_cast<uint32_t>(tick);
+        uint32_t c2 = static_cast<uint32_t>(tick >> 32);
+        uint32_t c3 = 0;
+        uint32_t k0 = static_cast<uint32_t>(seed);
+        uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+
+        for (int round = 0; round < PHILOX_ROUNDS; ++round)
+        {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        return c0;
+    }
+
+    void RollBonusesScalar(uint64_t seed, uint64_t tick, const uint32_t *ids, const float *chance,
+                           const float *multiplier, float *bonus, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float u = static_cast<float>(Philox(ids[i], tick, seed) >> 8) * UNIT_SCALE;
+            bonus[i] = u < chance[i] ? multiplier[i] : 1.0f;
+        }
+    }
+
+    void UniformsScalar(uint64_t seed, uint64_t tick, const uint32_t *ids, float *out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = static_cast<float>(Philox(ids[i], tick, seed) >> 8) * UNIT_SCALE;
+    }
+
+#if defined(TYCOON_RNG_SSE2)
+    // 32x32 -> 64 bit multiply of all four lanes, split into low and high halves
+    inline void MulHiLo(__m128i a, __m128i m, __m128i &lo, __m128i &hi)
+    {
+        const __m128i low32 = _mm_set_epi32(0, -1, 0, -1);
+        __m128i even = _mm_mul_epu32(a, m);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+        lo = _mm_or_si128(_mm_and_si128(even, low32), _mm_slli_epi64(odd, 32));
+        hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(low32, odd));
+    }
+
+    // Philox for four ids at once; tick and seed are shared by the block
+    inline __m128i PhiloxSse2(__m128i c0, uint64_t tick, uint64_t seed)
+    {
+        const __m128i m0 = _mm_set1_epi32(static_cast<int>(PHILOX_M0));
+        const __m128i m1 = _mm_set1_epi32(static_cast<int>(PHILOX_M1));
+        __m128i c1 = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(tick)));
+        __m128i c2 = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(tick >> 32)));
+        __m128i c3 = _mm_setzero_si128();
+        uint32_t k0 = static_cast<uint32_t>(seed);
+        uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+
+        for (int round = 0; round < PHILOX_ROUNDS; ++round)
+        {
+            __m128i lo0, hi0, lo1, hi1;
+            MulHiLo(c0, m0, lo0, hi0);
+            MulHiLo(c2, m1, lo1, hi1);
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(static_cast<int>(k0)));
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(static_cast<int>(k1)));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        return c0;
+    }
+
+    inline __m128 UniformSse2(const uint32_t *ids, uint64_t tick, uint64_t seed)
+    {
+        __m128i c0 = PhiloxSse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ids)), tick, seed);
+        return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c0, 8)), _mm_set1_ps(UNIT_SCALE));
+    }
+
+    void RollBonusesSse2(uint64_t seed, uint64_t tick, const uint32_t *ids, const float *chance,
+                         const float *multiplier, float *bonus, size_t count)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 u = UniformSse2(ids + i, tick, seed);
+            __m128 hit = _mm_cmplt_ps(u, _mm_loadu_ps(chance + i));
+            __m128 result = _mm_or_ps(_mm_and_ps(hit, _mm_loadu_ps(multiplier + i)), _mm_andnot_ps(hit, one));
+            _mm_storeu_ps(bonus + i, result);
+        }
+        RollBonusesScalar(seed, tick, ids + i, chance + i, multiplier + i, bonus + i, count - i);
+    }
+
+    void UniformsSse2(uint64_t seed, uint64_t tick, const uint32_t *ids, float *out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, UniformSse2(ids + i, tick, seed));
+        UniformsScalar(seed, tick, ids + i, out + i, count - i);
+    }
+#endif
+}
+
+namespace ProductionRng
+{
+    uint32_t Generate(uint64_t seed, uint64_t tick, uint32_t id)
+    {
+        return Philox(id, tick, seed);
+    }
+
+    float Uniform(uint64_t seed, uint64_t tick, uint32_t id)
+    {
+        return static_cast<float>(Philox(id, tick, seed) >> 8) * UNIT_SCALE;
+    }
+
+    void RollBonuses(uint64_t seed, uint64_t tick, const uint32_t *ids, const float *chance,
+                     const float *multiplier, float *bonus, size_t count)
+    {
+#if defined(TYCOON_RNG_SSE2)
+        RollBonusesSse2(seed, tick, ids, chance, multiplier, bonus, count);
+#else
+        RollBonusesScalar(seed, tick, ids, chance, multiplier, bonus, count);
+#endif
+    }
+
+    void Uniforms(uint64_t seed, uint64_t tick, const uint32_t *ids, float *out, size_t count)
+    {
+#if defined(TYCOON_RNG_SSE2)
+        UniformsSse2(seed, tick, ids, out, count);
+#else
+        UniformsScalar(seed, tick, ids, out, count);
+#endif
+    }
+}
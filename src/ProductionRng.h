@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Counter-based random numbers (Philox4x32-10). Every value is a pure
+// function of (seed, tick, id), so rolls can be generated in any order, on
+// any thread, or replayed later and always come out the same.
+namespace ProductionRng
+{
+    uint32_t Generate(uint64_t seed, uint64_t tick, uint32_t id);
+
+    // Uniform float in [0, 1)
+    float Uniform(uint64_t seed, uint64_t tick, uint32_t id);
+
+    // out[i] = Uniform(seed, tick, ids[i]), four ids per SSE2 instruction
+    void Uniforms(uint64_t seed, uint64_t tick, const uint32_t *ids, float *out, size_t count);
+
+    // bonus[i] = multiplier[i] if Uniform(seed, tick, ids[i]) < chance[i], else 1.
+    // Processes four buildings per SSE2 instruction where available.
+    void RollBonuses(uint64_t seed, uint64_t tick, const uint32_t *ids, const float *chance,
+                     const float *multiplier, float *bonus, size_t count);
+}
@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include <string>
+#include <cstddef>
 
 // Resource type enum
 enum class ResourceType
@@ -14,33 +16,33 @@ enum class ResourceType
     DIAMOND  // New high-value resource
 };
 
+constexpr size_t RESOURCE_TYPE_COUNT = static_cast<size_t>(ResourceType::DIAMOND) + 1;
+
+// One amount per resource type, indexed by ResourceType
+using ResourceAmounts = std::array<float, RESOURCE_TYPE_COUNT>;
+
+// A resource's name and market price. How much of it a player holds lives
+// in their ResourceLedger.
 class Resource
 {
 public:
     Resource() = default;
-    Resource(ResourceType type, const std::string &name, float amount, float basePrice, bool isOwned);
+    Resource(ResourceType type, const std::string &name, float basePrice);
     virtual ~Resource() = default;
 
     // Getters
     ResourceType GetType() const { return m_type; }
     const std::string &GetName() const { return m_name; }
-    float GetAmount() const { return m_amount; }
     float GetBasePrice() const { return m_basePrice; }
-    bool IsOwned() const { return m_isOwned; }
 
     // Setters
-    void SetAmount(float amount) { m_amount = amount; }
     void SetBasePrice(float price) { m_basePrice = price; }
-    void SetOwned(bool owned) { m_isOwned = owned; }
 
     // Virtual methods that can be overridden by specific resource types
-    virtual void UpdatePrice(float volatility);
     virtual float GetProductionRate() const { return 1.0f; }
 
 protected:
     ResourceType m_type;
     std::string m_name;
-    float m_amount;
     float m_basePrice;
-    bool m_isOwned;
 };
\ No newline at end of file
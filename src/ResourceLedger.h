@@ -0,0 +1,126 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include "FixedAmount.h"
+#include "Resource.h"
+
+// The one store of resource amounts, money included (ResourceType::MONEY).
+// Everything that produces, consumes, buys or sells goes through here, and
+// the UI reads it directly. Amounts are kept in fixed point so late-game
+// stockpiles keep growing by each frame's small increment.
+//
+// Each slot may also carry a steady rate per second: its amount is then
+// value + rate * (now - since), evaluated on read, so steady production
+// costs nothing per frame. Any write folds the accrued part in first; a
+// slot without a rate, the common case, skips that entirely.
+class ResourceLedger
+{
+public:
+    void Add(ResourceType type, float amount)
+    {
+        size_t slot = Settle(type);
+        m_value[slot] += amount;
+    }
+
+    // Try to consume; returns false if insufficient
+    bool Consume(ResourceType type, float amount)
+    {
+        size_t slot = Settle(type);
+        FixedAmount wanted = FixedAmount::FromFloat(amount);
+        if (m_value[slot] >= wanted)
+        {
+            m_value[slot] -= wanted;
+            return true;
+        }
+        return false;
+    }
+
+    // Consume as much of amount as there is, never going below zero
+    void ConsumeUpTo(ResourceType type, float amount)
+    {
+        size_t slot = Settle(type);
+        m_value[slot] -= std::min(m_value[slot], FixedAmount::FromFloat(amount));
+    }
+
+    // Query how much you have; never more than is actually stored
+    float Get(ResourceType type) const
+    {
+        size_t slot = static_cast<size_t>(type);
+        return (m_value[slot] + Accrued(slot)).ToFloat();
+    }
+
+    void Set(ResourceType type, float amount)
+    {
+        size_t slot = Settle(type);
+        m_value[slot] = FixedAmount::FromFloat(amount);
+    }
+
+    // The stored amount without rounding, e.g. for save files
+    FixedAmount GetExact(ResourceType type) const
+    {
+        size_t slot = static_cast<size_t>(type);
+        return m_value[slot] + Accrued(slot);
+    }
+
+    void SetExact(ResourceType type, FixedAmount amount)
+    {
+        size_t slot = Settle(type);
+        m_value[slot] = amount;
+    }
+
+    float GetRate(ResourceType type) const { return m_rate[static_cast<size_t>(type)]; }
+
+    void SetRate(ResourceType type, float ratePerSecond)
+    {
+        size_t slot = Settle(type);
+        m_rate[slot] = ratePerSecond;
+        m_since[slot] = m_now;
+    }
+
+    // Fold everything accrued so far into the stored amounts and stop accruing
+    void ClearRates()
+    {
+        for (size_t slot = 0; slot < RESOURCE_TYPE_COUNT; ++slot)
+            SetRate(static_cast<ResourceType>(slot), 0.0f);
+    }
+
+    // Moves the ledger clock; O(1) however many slots are accruing
+    void Advance(double deltaTime) { m_now += deltaTime; }
+
+    void Clear()
+    {
+        m_value = {};
+        m_rate = {};
+        m_since = {};
+        m_now = 0.0;
+    }
+
+private:
+    FixedAmount Accrued(size_t slot) const
+    {
+        if (m_rate[slot] == 0.0f)
+            return FixedAmount();
+        FixedAmount accrued = FixedAmount::FromFloat(m_rate[slot] * (m_now - m_since[slot]));
+        // a draining slot bottoms out at zero
+        return std::max(accrued, FixedAmount() - m_value[slot]);
+    }
+
+    // m_since only means something while the slot has a rate
+    size_t Settle(ResourceType type)
+    {
+        size_t slot = static_cast<size_t>(type);
+        if (m_rate[slot] != 0.0f)
+        {
+            m_value[slot] += Accrued(slot);
+            m_since[slot] = m_now;
+        }
+        return slot;
+    }
+
+    // Fixed slot per type so independent production subgraphs can update
+    // disjoint resources concurrently without touching shared structure
+    std::array<FixedAmount, RESOURCE_TYPE_COUNT> m_value{};
+    std::array<float, RESOURCE_TYPE_COUNT> m_rate{};
+    std::array<double, RESOURCE_TYPE_COUNT> m_since{};
+    double m_now = 0.0;
+};
@@ -0,0 +1,498 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "Player.h"
+#include "World.h"
+
+namespace
+{
+    // Names as they appear in scenario files, in enum order
+    constexpr const char *BUILDING_NAMES[] = {"woodcutter", "mine", "crystal_mine", "power_plant", "research_lab", "diamond_mine"};
+    constexpr const char *RESOURCE_NAMES[] = {"money", "wood", "stone", "iron", "gold", "crystal", "energy", "diamond"};
+    constexpr const char *PRODUCTION_NAMES[] = {"furniture", "tools", "railroads", "jewelry"};
+    constexpr const char *MARKET_NAMES[] = {"random_walk", "mean_reverting", "supply_demand"};
+    constexpr const char *COMPARE_NAMES[] = {"<", "<=", ">", ">=", "==", "!="};
+
+    static_assert(sizeof(BUILDING_NAMES) / sizeof(BUILDING_NAMES[0]) == BUILDING_TYPE_COUNT, "a name per building type");
+    static_assert(sizeof(RESOURCE_NAMES) / sizeof(RESOURCE_NAMES[0]) == RESOURCE_TYPE_COUNT, "a name per resource type");
+    static_assert(sizeof(PRODUCTION_NAMES) / sizeof(PRODUCTION_NAMES[0]) == PRODUCTION_TYPE_COUNT, "a name per production type");
+
+    template <size_t N>
+    bool Lookup(const char *const (&names)[N], const std::string &word, int &index)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (word == names[i])
+            {
+                index = static_cast<int>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseNumber(const std::string &word, float &value)
+    {
+        char *end = nullptr;
+        value = std::strtof(word.c_str(), &end);
+        return !word.empty() && *end == '\0' && std::isfinite(value);
+    }
+
+    bool ParseNumber(const std::string &word, double &value)
+    {
+        char *end = nullptr;
+        value = std::strtod(word.c_str(), &end);
+        return !word.empty() && *end == '\0' && std::isfinite(value);
+    }
+
+    // 90, 90s, 15m, 2h, 1.5h
+    bool ParseTime(const std::string &word, float &seconds)
+    {
+        char *end = nullptr;
+        seconds = std::strtof(word.c_str(), &end);
+        if (word.empty() || end == word.c_str() || !std::isfinite(seconds) || seconds < 0.0f)
+            return false;
+        std::string unit = end;
+        if (unit == "m")
+            seconds *= 60.0f;
+        else if (unit == "h")
+            seconds *= 3600.0f;
+        else if (!unit.empty() && unit != "s")
+            return false;
+        return true;
+    }
+
+    // Amounts and money are fixed point underneath; equality is to the cent
+    long long InCents(double value)
+    {
+        return std::llround(value * 100.0);
+    }
+
+    int FindBuilding(const Player &player, int type)
+    {
+        for (size_t i = 0; i < player.buildings.size(); ++i)
+        {
+            if (player.buildings[i] && static_cast<int>(player.buildings[i]->GetType()) == type)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+}
+
+bool Scenario::Load(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        fprintf(stderr, "Error opening scenario %s\n", filename.c_str());
+        return false;
+    }
+    return Parse(file, filename);
+}
+
+bool Scenario::Parse(std::istream &in, const std::string &name)
+{
+    *this = Scenario();
+    m_name = name;
+
+    std::string text;
+    int line = 0;
+    while (std::getline(in, text))
+    {
+        ++line;
+        text = text.substr(0, text.find('#'));
+        std::istringstream stream(text);
+        std::vector<std::string> words;
+        for (std::string word; stream >> word;)
+            words.push_back(word);
+        if (!words.empty() && !ParseLine(words, line))
+            return false;
+    }
+
+    if (!m_hasDuration)
+    {
+        fprintf(stderr, "%s: no \"run\" line\n", m_name.c_str());
+        return false;
+    }
+    for (const Event &event : m_events)
+    {
+        if (event.time > m_duration)
+        {
+            fprintf(stderr, "%s:%d: \"at\" is after the end of the run\n", m_name.c_str(), event.line);
+            return false;
+        }
+    }
+
+    // Events at the same time keep their file order
+    std::stable_sort(m_events.begin(), m_events.end(), [](const Event &a, const Event &b) { return a.time < b.time; });
+    return true;
+}
+
+bool Scenario::ParseLine(const std::vector<std::string> &words, int line)
+{
+    const std::string &keyword = words[0];
+    const size_t count = words.size();
+    bool ok = false;
+    int index = 0;
+    float value = 0.0f;
+
+    if (keyword == "seed" && count == 2)
+    {
+        char *end = nullptr;
+        m_seed = std::strtoull(words[1].c_str(), &end, 10);
+        ok = *end == '\0';
+    }
+    else if (keyword == "market" && count == 2)
+    {
+        ok = Lookup(MARKET_NAMES, words[1], index);
+        m_marketModel = static_cast<MarketModelType>(index);
+    }
+    else if (keyword == "expected" && count == 2)
+    {
+        ok = words[1] == "on" || words[1] == "off";
+        m_expectedValue = words[1] == "on";
+    }
+    else if (keyword == "tick" && count == 2)
+    {
+        ok = ParseNumber(words[1], value) && value > 0.0f && value <= GameConstants::MAX_DELTA_TIME;
+        m_tick = value;
+    }
+    else if (keyword == "set" && count == 3 && ParseNumber(words[2], value))
+    {
+        if (words[1] == "reputation")
+        {
+            m_reputation = static_cast<int>(value);
+            ok = m_reputation >= 0;
+        }
+        else if (Lookup(RESOURCE_NAMES, words[1], index))
+        {
+            m_amounts.push_back({static_cast<ResourceType>(index), value});
+            ok = value >= 0.0f;
+        }
+    }
+    else if (keyword == "own" && (count == 2 || count == 3) && Lookup(BUILDING_NAMES, words[1], index))
+    {
+        value = 1.0f;
+        ok = count == 2 || (ParseNumber(words[2], value) && value >= 1.0f && value <= Building::MAX_LEVEL);
+        m_owned.push_back({static_cast<BuildingType>(index), static_cast<int>(value)});
+    }
+    else if (keyword == "run" && count == 2)
+    {
+        ok = ParseTime(words[1], m_duration);
+        m_hasDuration = true;
+    }
+    else if (keyword == "expect")
+    {
+        Expectation expectation;
+        ok = ParseExpectation(words, 1, line, expectation);
+        m_final.push_back(expectation);
+    }
+    else if (keyword == "at" && count >= 3)
+    {
+        Event event;
+        event.line = line;
+        ok = ParseTime(words[1], event.time);
+        if (ok && words[2] == "expect")
+        {
+            event.type = Event::Type::EXPECT;
+            ok = ParseExpectation(words, 3, line, event.expectation);
+        }
+        else if (ok)
+        {
+            ok = ParseAction(words, 2, event);
+        }
+        m_events.push_back(event);
+    }
+
+    if (!ok)
+        fprintf(stderr, "%s:%d: cannot read \"%s\"\n", m_name.c_str(), line, keyword.c_str());
+    return ok;
+}
+
+bool Scenario::ParseAction(const std::vector<std::string> &words, size_t first, Event &event)
+{
+    const std::string &action = words[first];
+    const size_t count = words.size() - first;
+
+    if (action == "build" && count == 2)
+    {
+        event.type = Event::Type::BUILD;
+        return Lookup(BUILDING_NAMES, words[first + 1], event.target);
+    }
+    if (action == "upgrade" && count == 2)
+    {
+        event.type = Event::Type::UPGRADE;
+        return Lookup(BUILDING_NAMES, words[first + 1], event.target);
+    }
+    if (action == "priority" && count == 3)
+    {
+        event.type = Event::Type::PRIORITY;
+        return Lookup(BUILDING_NAMES, words[first + 1], event.target) &&
+               ParseNumber(words[first + 2], event.value) && event.value >= 0.0f && event.value <= Building::MAX_PRIORITY;
+    }
+    if (action == "produce" && (count == 2 || count == 3))
+    {
+        event.type = Event::Type::PRODUCE;
+        event.value = 1.0f;
+        return Lookup(PRODUCTION_NAMES, words[first + 1], event.target) &&
+               (count == 2 || (ParseNumber(words[first + 2], event.value) && event.value >= 1.0f));
+    }
+    if (action == "unlock" && count == 2 && words[first + 1] == "stocks")
+    {
+        event.type = Event::Type::UNLOCK_STOCKS;
+        return true;
+    }
+    if (action == "sell" && count == 2)
+    {
+        event.type = Event::Type::SELL_BUILDING;
+        return Lookup(BUILDING_NAMES, words[first + 1], event.target);
+    }
+    if ((action == "buy" || action == "sell") && count == 3)
+    {
+        // MONEY is never traded
+        if (!Lookup(RESOURCE_NAMES, words[first + 1], event.target) || event.target == static_cast<int>(ResourceType::MONEY))
+            return false;
+        if (action == "sell" && words[first + 2] == "all")
+        {
+            event.type = Event::Type::SELL_ALL;
+            return true;
+        }
+        event.type = action == "buy" ? Event::Type::BUY : Event::Type::SELL;
+        return ParseNumber(words[first + 2], event.value) && event.value > 0.0f;
+    }
+    return false;
+}
+
+bool Scenario::ParseExpectation(const std::vector<std::string> &words, size_t first, int line, Expectation &expectation)
+{
+    expectation.line = line;
+    for (size_t i = first; i < words.size(); ++i)
+        expectation.text += (i > first ? " " : "") + words[i];
+
+    size_t next = first;
+    if (next >= words.size())
+        return false;
+
+    Measure &measure = expectation.measure;
+    const std::string &name = words[next++];
+    if (name == "reputation")
+        measure.kind = Measure::Kind::REPUTATION;
+    else if (name == "buildings")
+        measure.kind = Measure::Kind::BUILDINGS;
+    else if (name == "jobs")
+        measure.kind = Measure::Kind::JOBS;
+    else if (name == "earnings")
+        measure.kind = Measure::Kind::EARNINGS;
+    else if (name == "spent")
+        measure.kind = Measure::Kind::SPENT;
+    else if (name == "level")
+    {
+        measure.kind = Measure::Kind::LEVEL;
+        if (next >= words.size() || !Lookup(BUILDING_NAMES, words[next++], measure.target))
+            return false;
+    }
+    else if (Lookup(RESOURCE_NAMES, name, measure.target))
+        measure.kind = Measure::Kind::RESOURCE;
+    else
+        return false;
+
+    int compare = 0;
+    if (next + 2 != words.size() || !Lookup(COMPARE_NAMES, words[next], compare))
+        return false;
+    expectation.compare = static_cast<Compare>(compare);
+    return ParseNumber(words[next + 1], expectation.value);
+}
+
+std::unique_ptr<World> Scenario::CreateWorld() const
+{
+    auto world = std::make_unique<World>(m_seed);
+    world->SetMarketModel(m_marketModel);
+    world->SetExpectedValue(m_expectedValue);
+    Player &player = world->GetPlayer(world->AddPlayer(m_name));
+
+    for (const auto &[type, amount] : m_amounts)
+        player.ledger.Set(type, amount);
+    if (m_reputation >= 0)
+        player.reputation = m_reputation;
+
+    // Owned from the start: no price paid, no starter fuel
+    for (const auto &[type, level] : m_owned)
+    {
+        int index = FindBuilding(player, static_cast<int>(type));
+        if (index < 0)
+            continue;
+        Building &building = *player.buildings[index];
+        building.SetOwned(true);
+        while (building.GetLevel() < level && building.Upgrade())
+        {
+        }
+    }
+    player.productionGraph.Invalidate();
+    return world;
+}
+
+ScenarioResult Scenario::Run(World &world) const
+{
+    using Clock = std::chrono::steady_clock;
+    const auto started = Clock::now();
+
+    ScenarioResult result;
+    const double begin = world.GetTime();
+    const uint64_t ticks = m_duration > begin ? static_cast<uint64_t>(std::llround((m_duration - begin) / m_tick)) : 0;
+
+    // An event lands on the tick nearest its time
+    size_t next = 0;
+    while (next < m_events.size() && m_events[next].time < begin)
+        ++next;
+    const size_t first = next;
+    for (uint64_t t = 0;; ++t)
+    {
+        const double now = begin + static_cast<double>(t) * m_tick;
+        for (; next < m_events.size() && m_events[next].time <= now + m_tick * 0.5; ++next)
+        {
+            const Event &event = m_events[next];
+            if (event.type == Event::Type::EXPECT)
+                Check(world.GetPlayer(0), event.expectation, event.time, result);
+            else
+                Apply(world, event);
+        }
+        if (t == ticks)
+            break;
+        world.Update(m_tick);
+    }
+    result.ticks = ticks;
+
+    // Events before the world's time or past the last tick never ran
+    for (size_t i = 0; i < m_events.size(); ++i)
+    {
+        if (i >= first && i < next)
+            continue;
+        char message[256];
+        std::snprintf(message, sizeof(message), "%s:%d: never reached (at %.0fs, run from %.0fs to %.0fs)",
+                      m_name.c_str(), m_events[i].line, m_events[i].time, begin, std::max<double>(m_duration, begin));
+        result.failures.push_back(message);
+    }
+
+    for (const auto &expectation : m_final)
+        Check(world.GetPlayer(0), expectation, std::max<float>(m_duration, world.GetTime()), result);
+
+    result.passed = result.failures.empty();
+    result.seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    return result;
+}
+
+void Scenario::Apply(World &world, const Event &event) const
+{
+    const Player &player = world.GetPlayer(0);
+    GameCommand command;
+    switch (event.type)
+    {
+    case Event::Type::BUILD:
+        command = {CommandType::BUILD, event.target, 0.0f, {}};
+        break;
+    case Event::Type::UPGRADE:
+        command = {CommandType::UPGRADE_BUILDING, FindBuilding(player, event.target), 0.0f, {}};
+        break;
+    case Event::Type::SELL_BUILDING:
+        command = {CommandType::SELL_BUILDING, FindBuilding(player, event.target), 0.0f, {}};
+        break;
+    case Event::Type::PRIORITY:
+        command = {CommandType::SET_PRIORITY, FindBuilding(player, event.target), event.value, {}};
+        break;
+    case Event::Type::PRODUCE:
+        command = {CommandType::BEGIN_PRODUCTION, event.target, 0.0f, {}};
+        for (int job = 0; job < static_cast<int>(event.value); ++job)
+            world.Apply(0, command);
+        return;
+    case Event::Type::BUY:
+    case Event::Type::SELL:
+    case Event::Type::SELL_ALL:
+    {
+        const ResourceType type = static_cast<ResourceType>(event.target);
+        float quantity = event.type == Event::Type::SELL_ALL ? player.ledger.Get(type) : event.value;
+        if (quantity <= 0.0f)
+            return;
+        command.type = CommandType::EXECUTE_ORDERS;
+        command.orders.push_back({type, quantity, event.type == Event::Type::BUY ? OrderSide::BUY : OrderSide::SELL});
+        break;
+    }
+    case Event::Type::UNLOCK_STOCKS:
+        command = {CommandType::UNLOCK_STOCKS, 0, 0.0f, {}};
+        break;
+    case Event::Type::EXPECT:
+        return;
+    }
+    world.Apply(0, command);
+}
+
+void Scenario::Check(const Player &player, const Expectation &expectation, float time, ScenarioResult &result) const
+{
+    const Measure &measure = expectation.measure;
+    double actual = 0.0;
+    switch (measure.kind)
+    {
+    case Measure::Kind::RESOURCE:
+        actual = player.ledger.GetExact(static_cast<ResourceType>(measure.target)).ToDouble();
+        break;
+    case Measure::Kind::REPUTATION:
+        actual = player.reputation;
+        break;
+    case Measure::Kind::LEVEL:
+        for (const auto &building : player.buildings)
+        {
+            if (building && building->IsOwned() && static_cast<int>(building->GetType()) == measure.target)
+                actual = std::max<double>(actual, building->GetLevel());
+        }
+        break;
+    case Measure::Kind::BUILDINGS:
+        for (const auto &building : player.buildings)
+            actual += building && building->IsOwned() ? 1.0 : 0.0;
+        break;
+    case Measure::Kind::JOBS:
+        actual = static_cast<double>(player.jobs.GetJobCount());
+        break;
+    case Measure::Kind::EARNINGS:
+        actual = player.totalEarnings.ToDouble();
+        break;
+    case Measure::Kind::SPENT:
+        actual = player.totalSpent.ToDouble();
+        break;
+    }
+
+    bool holds = false;
+    switch (expectation.compare)
+    {
+    case Compare::LESS:
+        holds = actual < expectation.value;
+        break;
+    case Compare::LESS_EQUAL:
+        holds = actual <= expectation.value;
+        break;
+    case Compare::GREATER:
+        holds = actual > expectation.value;
+        break;
+    case Compare::GREATER_EQUAL:
+        holds = actual >= expectation.value;
+        break;
+    case Compare::EQUAL:
+        holds = InCents(actual) == InCents(expectation.value);
+        break;
+    case Compare::NOT_EQUAL:
+        holds = InCents(actual) != InCents(expectation.value);
+        break;
+    }
+
+    result.checks++;
+    if (!holds)
+    {
+        char message[256];
+        std::snprintf(message, sizeof(message), "%s:%d: expected %s at %.0fs, was %.2f",
+                      m_name.c_str(), expectation.line, expectation.text.c_str(), time, actual);
+        result.failures.push_back(message);
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Building.h"
+#include "GameConstants.h"
+#include "MarketModel.h"
+#include "Resource.h"
+
+class Player;
+class World;
+
+// Outcome of one scenario run
+struct ScenarioResult
+{
+    bool passed = false;
+    size_t checks = 0;                 // expectations evaluated
+    std::vector<std::string> failures; // one line per failed expectation
+    uint64_t ticks = 0;
+    double seconds = 0.0;              // wall clock
+};
+
+// A reproducible game in a few lines of text, played on a one-player World
+// as fast as the machine allows:
+//
+//   # comments run to the end of the line
+//   seed 7
+//   market supply_demand         random_walk, mean_reverting or supply_demand
+//   expected on                  bonus rolls at their average
+//   tick 0.1                     seconds per tick; SIMULATION_TICK otherwise
+//   set money 50000              money, a resource or reputation
+//   own mine 3                   owned from the start, at that level
+//   at 90s build power_plant
+//   at 2m upgrade mine
+//   at 5m produce tools 20       that many jobs; one otherwise
+//   at 10m buy energy 50
+//   at 10m sell gold all         or a quantity
+//   at 15m sell mine             half the building's price back
+//   at 20m priority mine 2
+//   at 30m unlock stocks
+//   at 30m expect money > 1000   checked at that time
+//   run 2h
+//   expect level mine >= 4       checked at the end
+//
+// Times take s, m or h (seconds without a unit). `run` is required and no
+// `at` may come after it. `set` and `own` describe the starting state
+// wherever they appear. Expectations compare money, a resource,
+// reputation, `level <building>` (0 unless owned), `buildings` (owned),
+// `jobs` (running and queued), `earnings` or `spent` using <, <=, >, >=,
+// == or != (the last two to the cent).
+class Scenario
+{
+public:
+    // Reports the first error to stderr as file:line and returns false
+    bool Load(const std::string &filename);
+    bool Parse(std::istream &in, const std::string &name);
+
+    const std::string &GetName() const { return m_name; }
+    float GetDuration() const { return m_duration; }
+
+    // A fresh one-player World in the starting state
+    std::unique_ptr<World> CreateWorld() const;
+
+    // Plays every event from the world's current time to the end of the
+    // scenario, then checks the final expectations. An event the run never
+    // reaches counts as a failure.
+    ScenarioResult Run(World &world) const;
+
+private:
+    struct Measure
+    {
+        enum class Kind
+        {
+            RESOURCE,  // target: ResourceType
+            REPUTATION,
+            LEVEL,     // target: BuildingType
+            BUILDINGS,
+            JOBS,
+            EARNINGS,
+            SPENT
+        };
+
+        Kind kind = Kind::RESOURCE;
+        int target = 0;
+    };
+
+    enum class Compare
+    {
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        EQUAL,
+        NOT_EQUAL
+    };
+
+    struct Expectation
+    {
+        Measure measure;
+        Compare compare = Compare::EQUAL;
+        double value = 0.0;
+        std::string text; // as written, for failure messages
+        int line = 0;
+    };
+
+    struct Event
+    {
+        enum class Type
+        {
+            BUILD,         // target: BuildingType
+            UPGRADE,       // target: BuildingType
+            SELL_BUILDING, // target: BuildingType
+            PRIORITY,      // target: BuildingType, value: priority
+            PRODUCE,       // target: ProductionType, value: jobs
+            BUY,           // target: ResourceType, value: quantity
+            SELL,          // target: ResourceType, value: quantity
+            SELL_ALL,      // target: ResourceType
+            UNLOCK_STOCKS,
+            EXPECT
+        };
+
+        float time = 0.0f;
+        Type type = Type::EXPECT;
+        int target = 0;
+        float value = 0.0f;
+        Expectation expectation;
+        int line = 0;
+    };
+
+    bool ParseLine(const std::vector<std::string> &words, int line);
+    bool ParseAction(const std::vector<std::string> &words, size_t first, Event &event);
+    bool ParseExpectation(const std::vector<std::string> &words, size_t first, int line, Expectation &expectation);
+    void Apply(World &world, const Event &event) const;
+    void Check(const Player &player, const Expectation &expectation, float time, ScenarioResult &result) const;
+
+    std::string m_name;
+    uint64_t m_seed = 1;
+    MarketModelType m_marketModel = MarketModelType::SUPPLY_DEMAND;
+    bool m_expectedValue = false;
+    float m_tick = GameConstants::SIMULATION_TICK;
+    float m_duration = 0.0f;
+    bool m_hasDuration = false;
+
+    std::vector<std::pair<ResourceType, float>> m_amounts;
+    int m_reputation = -1; // starting reputation unless set
+    std::vector<std::pair<BuildingType, int>> m_owned;
+    std::vector<Event> m_events; // in time order, file order within a time
+    std::vector<Expectation> m_final;
+};
@@ -0,0 +1,88 @@
+#include "TimerWheel.h"
+
+namespace
+{
+    constexpr uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+
+    // Mask of the tick bits below `level`
+    constexpr uint64_t LowBits(size_t level)
+    {
+        return (uint64_t(1) << (level * TimerWheel::SLOT_BITS)) - 1;
+    }
+}
+
+void TimerWheel::Schedule(uint64_t due, uint32_t id)
+{
+    Insert({due > m_now ? due : m_now + 1, id});
+    m_pending++;
+}
+
+void TimerWheel::Insert(const Timer &timer)
+{
+    // The highest digit where due and now differ picks the level
+    uint64_t diff = timer.due ^ m_now;
+    size_t level = 0;
+    while (level < LEVELS && (diff >> ((level + 1) * SLOT_BITS)) != 0)
+        level++;
+
+    if (level >= LEVELS)
+    {
+        m_overflow.push_back(timer);
+        return;
+    }
+    m_slots[level][(timer.due >> (level * SLOT_BITS)) & SLOT_MASK].push_back(timer);
+}
+
+void TimerWheel::Cascade(size_t level)
+{
+    auto &slot = m_slots[level][(m_now >> (level * SLOT_BITS)) & SLOT_MASK];
+    m_scratch.swap(slot);
+    for (const Timer &timer : m_scratch)
+        Insert(timer);
+    m_scratch.clear();
+}
+
+void TimerWheel::Advance(uint64_t now, std::vector<uint32_t> &expired)
+{
+    while (m_now < now)
+    {
+        if (m_pending == 0)
+        {
+            m_now = now;
+            return;
+        }
+
+        m_now++;
+        if ((m_now & LowBits(LEVELS)) == 0)
+        {
+            m_scratch.swap(m_overflow);
+            for (const Timer &timer : m_scratch)
+                Insert(timer);
+            m_scratch.clear();
+        }
+        // Coarser levels first, so their timers can drop all the way down
+        for (size_t level = LEVELS - 1; level > 0; --level)
+        {
+            if ((m_now & LowBits(level)) == 0)
+                Cascade(level);
+        }
+
+        auto &slot = m_slots[0][m_now & SLOT_MASK];
+        for (const Timer &timer : slot)
+            expired.push_back(timer.id);
+        m_pending -= slot.size();
+        slot.clear();
+    }
+}
+
+void TimerWheel::Reset(uint64_t now)
+{
+    for (auto &level : m_slots)
+    {
+        for (auto &slot : level)
+            slot.clear();
+    }
+    m_overflow.clear();
+    m_now = now;
+    m_pending = 0;
+}
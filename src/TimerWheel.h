@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel: four levels of 256 slots over integer ticks.
+// A timer sits in the level of the highest digit where its due tick differs
+// from the current tick, and is moved down a level each time the wheel
+// reaches its slot. Advancing costs one slot visit per tick plus the timers
+// that fire or cascade, independent of how many timers are pending.
+class TimerWheel
+{
+public:
+    static constexpr int SLOT_BITS = 8;
+    static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+    static constexpr size_t LEVELS = 4;
+
+    // Fires on the first Advance() that reaches `due` (a timer that is
+    // already due fires on the next tick); ids need not be unique
+    void Schedule(uint64_t due, uint32_t id);
+
+    // Moves the wheel to `now` and appends every timer due by then to
+    // `expired`, in due order
+    void Advance(uint64_t now, std::vector<uint32_t> &expired);
+
+    uint64_t GetNow() const { return m_now; }
+    size_t GetPendingCount() const { return m_pending; }
+
+    // Drops every timer and restarts the wheel at `now`
+    void Reset(uint64_t now);
+
+private:
+    struct Timer
+    {
+        uint64_t due;
+        uint32_t id;
+    };
+
+    void Insert(const Timer &timer);
+    void Cascade(size_t level);
+
+    std::array<std::array<std::vector<Timer>, SLOTS>, LEVELS> m_slots;
+    std::vector<Timer> m_overflow; // beyond the top level's range
+    std::vector<Timer> m_scratch;
+    uint64_t m_now = 0;
+    size_t m_pending = 0;
+};
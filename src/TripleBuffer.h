@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-writer / single-reader triple buffer. The writer fills
+// its private buffer and publishes it by swapping it with the shared middle
+// one; the reader swaps the middle one for its own whenever something new
+// was published. Neither side ever waits for the other, and the reader
+// always sees a complete, unchanging value.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side: fill this, then Publish()
+    T &GetWriteBuffer() { return m_buffers[m_write]; }
+
+    void Publish()
+    {
+        m_write = m_middle.exchange(static_cast<uint8_t>(m_write | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader side: the latest published value, valid until the next Read()
+    const T &Read()
+    {
+        if (m_middle.load(std::memory_order_relaxed) & FRESH)
+            m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & INDEX;
+        return m_buffers[m_read];
+    }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3> m_buffers{};
+    std::atomic<uint8_t> m_middle{1};
+    uint8_t m_write = 0;
+    uint8_t m_read = 2;
+};
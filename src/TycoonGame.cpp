@@ -2,6 +2,9 @@
 #include "BuildingFactory.h"
 #include "../lib/imgui.h"
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
 #include <random>
 #include <map>
 #include <stdexcept>
@@ -9,10 +12,39 @@
 #include <iomanip>
 #include <cmath>
 #include <fstream>
-#include "ResourceManager.h"
+#include "ProductionBonus.h"
+
+constexpr const char *SAVE_FILE = "savegame.dat";
+constexpr const char *MARKET_ARCHIVE_FILE = "market_history.dat";
+constexpr const char *COMMAND_LOG_FILE = "commands.log";
+
+// A command log starts with this tag and the GameState it was opened at
+constexpr uint32_t COMMAND_LOG_MAGIC = 0x474C4354; // "TCLG"
+
+// Commands that depend on files or on memory from before the log was
+// opened; each is followed in the log by the GameState it left behind
+static bool ReplacesState(CommandType type)
+{
+    return type == CommandType::NEW_GAME || type == CommandType::LOAD_GAME || type == CommandType::QUICK_LOAD;
+}
+
+// Never part of a recording: recording control, and autoplay, whose
+// commands are recorded instead
+static bool IsUnrecorded(CommandType type)
+{
+    return type == CommandType::SET_RECORDING || type == CommandType::REPLAY_RECORDING ||
+           type == CommandType::SET_AUTOPLAY;
+}
+constexpr size_t ARCHIVE_PLOT_POINTS = 120;
+
+static uint64_t MakeRngSeed()
+{
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
 
 TycoonGame::TycoonGame()
-    : m_gameTime(0.0f), m_isPaused(false), m_economyUpdateTimer(0.0f), m_resourceUpdateTimer(0.0f), m_reputationUpdateTimer(0.0f), m_maintenanceUpdateTimer(0.0f), m_lastFrameTime(0.0f), m_fps(0.0f), m_frameCount(0), m_fpsUpdateTimer(0.0f)
+    : m_gameTime(0.0f), m_isPaused(false), m_economyUpdateTimer(0.0f), m_resourceUpdateTimer(0.0f), m_reputationUpdateTimer(0.0f), m_maintenanceUpdateTimer(0.0f), m_lastFrameTime(0.0f), m_fps(0.0f), m_frameCount(0), m_fpsUpdateTimer(0.0f), m_rngSeed(0), m_tick(0)
 {
     try
     {
@@ -24,7 +56,11 @@ TycoonGame::TycoonGame()
     }
 }
 
-TycoonGame::~TycoonGame() = default;
+TycoonGame::~TycoonGame()
+{
+    StopSimulationThread();
+    CloseCommandLog();
+}
 
 // Initializing
 void TycoonGame::Initialize()
@@ -32,20 +68,20 @@ void TycoonGame::Initialize()
     try
     {
         // Try to load the saved game first
-        if (!LoadGame("savegame.dat"))
+        if (!LoadGame(SAVE_FILE))
         {
             // If loading fails, initialize with default values
             // Initialize player
             m_player.name = "Player";
-            m_player.money = GameConstants::STARTING_MONEY;
             m_player.reputation = GameConstants::STARTING_REPUTATION;
-            m_player.totalEarnings = 0.0f;
-            m_player.totalSpent = 0.0f;
+            m_player.totalEarnings = FixedAmount();
+            m_player.totalSpent = FixedAmount();
             m_player.achievements = 0;
 
-            InitializeResources();
-            InitializeBuildingTypes();
-            InitializeProductionTypes();
+            m_steadyProduction = false;
+            m_player.InitializeResources();
+            m_player.InitializeBuildingTypes();
+            m_player.InitializeProductionTypes();
 
             // Reset timers
             m_gameTime = 0.0f;
@@ -57,6 +93,14 @@ void TycoonGame::Initialize()
             m_fps = 0.0f;
             m_frameCount = 0;
             m_fpsUpdateTimer = 0.0f;
+
+            m_rngSeed = MakeRngSeed();
+            m_tick = 0;
+
+            m_market = MarketState::CreateDefault();
+            m_marketArchive.Open(MARKET_ARCHIVE_FILE, 0);
+            m_priceHistory.Clear();
+            RecordPrices();
         }
     }
     catch (const std::exception &e)
@@ -67,455 +111,657 @@ void TycoonGame::Initialize()
     }
 }
 
-void TycoonGame::InitializeResources()
-{
-    m_player.resources.clear();
-    m_player.resources[ResourceType::MONEY] = Resource(ResourceType::MONEY, "Money", GameConstants::STARTING_MONEY, 1.0f, true);
-    m_player.resources[ResourceType::WOOD] = Resource(ResourceType::WOOD, "Wood", 0.0f, GameConstants::WOOD_BASE_PRICE, false);
-    m_player.resources[ResourceType::STONE] = Resource(ResourceType::STONE, "Stone", 0.0f, GameConstants::STONE_BASE_PRICE, false);
-    m_player.resources[ResourceType::IRON] = Resource(ResourceType::IRON, "Iron", 0.0f, GameConstants::IRON_BASE_PRICE, false);
-    m_player.resources[ResourceType::GOLD] = Resource(ResourceType::GOLD, "Gold", 0.0f, GameConstants::GOLD_BASE_PRICE, false);
-    m_player.resources[ResourceType::CRYSTAL] = Resource(ResourceType::CRYSTAL, "Crystal", 0.0f, GameConstants::CRYSTAL_BASE_PRICE, false);
-    m_player.resources[ResourceType::ENERGY] = Resource(ResourceType::ENERGY, "Energy", 0.0f, GameConstants::ENERGY_BASE_PRICE, false);
-    m_player.resources[ResourceType::DIAMOND] = Resource(ResourceType::DIAMOND, "Diamond", 0.0f, GameConstants::DIAMOND_BASE_PRICE, false);
-
-    // Mirror into the global pool:
-    auto &rm = ResourceManager::Instance();
-    for (auto &p : m_player.resources)
-        rm.Add(p.first, p.second.GetAmount());
-}
-
-void TycoonGame::InitializeBuildingTypes()
+void TycoonGame::Update(float deltaTime)
 {
     try
     {
-        // Clear existing buildings
-        m_player.buildings.clear();
-
-        // Get available building types from factory
-        auto buildingTypes = BuildingFactory::GetAvailableBuildingTypes();
-
-        // Create one of each building type
-        for (auto type : buildingTypes)
-        {
-            if (auto building = BuildingFactory::CreateBuilding(type))
-            {
-                m_player.buildings.push_back(std::move(building));
-            }
-        }
+        // Player actions land together on the tick boundary, paused or not
+        ApplyCommands();
+        RunAutoplay();
+        Step(deltaTime);
     }
-    catch (const std::exception &e)
+    catch (...)
     {
-        std::stringstream ss;
-        ss << "Failed to initialize building types: " << e.what();
-        throw std::runtime_error(ss.str());
+        // Log error but don't crash
+        fprintf(stderr, "Error in Update\n");
     }
 }
 
-void TycoonGame::InitializeProductionTypes()
+void TycoonGame::Step(float deltaTime)
 {
-    try
+    // Cap delta time to prevent large jumps
+    deltaTime = std::min(deltaTime, GameConstants::MAX_DELTA_TIME);
+
+    // Update FPS counter
+    m_frameCount++;
+    m_fpsUpdateTimer += deltaTime;
+    if (m_fpsUpdateTimer >= GameConstants::FPS_UPDATE_INTERVAL)
     {
-        m_player.productions.clear();
-        auto productionTypes = BuildingFactory::GetAvailableProductionTypes();
-        for (auto type : productionTypes)
-        {
-            if (auto production = BuildingFactory::CreateProduction(type))
-            {
-                m_player.productions.push_back(std::move(production));
-            }
-        }
+        m_fps = static_cast<float>(m_frameCount) / m_fpsUpdateTimer;
+        m_frameCount = 0;
+        m_fpsUpdateTimer = 0.0f;
     }
-    catch (const std::exception &e)
-    {
-        std::stringstream ss;
-        ss << "Failed to initialize production types: " << e.what();
-        throw std::runtime_error(ss.str());
-    }
-}
 
-void TycoonGame::Update(float deltaTime)
-{
-    try
+    if (!m_isPaused)
     {
-        // Cap delta time to prevent large jumps
-        deltaTime = std::min(deltaTime, GameConstants::MAX_DELTA_TIME);
+        // Steady production only covers ticks it can run in full, so it
+        // stops before the clock moves rather than after the rates accrued
+        if (m_steadyProduction && (m_player.productionGraph.IsDirty() || !IsSteadyProductionValid()))
+            StopSteadyProduction();
+
+        m_gameTime += deltaTime;
+        m_tick++;
+        m_player.ledger.Advance(deltaTime);
+        if (m_steadyProduction)
+            m_steadyPendingTime += deltaTime;
+
+        // Update economy
+        m_economyUpdateTimer += deltaTime;
+        if (m_economyUpdateTimer >= GameConstants::ECONOMY_UPDATE_INTERVAL)
+        {
+            UpdateEconomy(GameConstants::ECONOMY_UPDATE_INTERVAL);
+            m_economyUpdateTimer = 0.0f;
+        }
 
-        // Update FPS counter
-        m_frameCount++;
-        m_fpsUpdateTimer += deltaTime;
-        if (m_fpsUpdateTimer >= GameConstants::FPS_UPDATE_INTERVAL)
+        // Update reputation
+        m_reputationUpdateTimer += deltaTime;
+        if (m_reputationUpdateTimer >= GameConstants::REPUTATION_UPDATE_INTERVAL)
         {
-            m_fps = static_cast<float>(m_frameCount) / m_fpsUpdateTimer;
-            m_frameCount = 0;
-            m_fpsUpdateTimer = 0.0f;
+            m_player.UpdateReputation();
+            m_reputationUpdateTimer = 0.0f;
         }
 
-        if (!m_isPaused)
+        // Update maintenance costs
+        m_maintenanceUpdateTimer += deltaTime;
+        if (m_maintenanceUpdateTimer >= GameConstants::MAINTENANCE_UPDATE_INTERVAL)
         {
-            m_gameTime += deltaTime;
+            m_player.PayMaintenance();
+            m_maintenanceUpdateTimer = 0.0f;
+        }
 
-            // Update economy
-            m_economyUpdateTimer += deltaTime;
-            if (m_economyUpdateTimer >= GameConstants::ECONOMY_UPDATE_INTERVAL)
-            {
-                UpdateEconomy(GameConstants::ECONOMY_UPDATE_INTERVAL);
-                m_economyUpdateTimer = 0.0f;
-            }
+        // Update all buildings, producers before consumers
+        if (m_player.productionGraph.IsDirty())
+            m_player.productionGraph.Rebuild(m_player.buildings);
 
-            // Update reputation
-            m_reputationUpdateTimer += deltaTime;
-            if (m_reputationUpdateTimer >= GameConstants::REPUTATION_UPDATE_INTERVAL)
-            {
-                UpdateReputation();
-                m_reputationUpdateTimer = 0.0f;
-            }
+        if (!m_steadyProduction)
+        {
+            m_player.UpdateBuildings(deltaTime, m_simulationMode == SimulationMode::EXPECTED_VALUE, m_rngSeed, m_tick);
+            TryStartSteadyProduction();
+        }
 
-            // Update maintenance costs
-            m_maintenanceUpdateTimer += deltaTime;
-            if (m_maintenanceUpdateTimer >= GameConstants::MAINTENANCE_UPDATE_INTERVAL)
-            {
-                float totalMaintenance = 0.0f;
+        // Update all resources
+        m_resourceUpdateTimer += deltaTime;
+        if (m_resourceUpdateTimer >= GameConstants::RESOURCE_UPDATE_INTERVAL)
+        {
+            SettleSteadyProduction();
+            m_player.UpdateResources(m_resourceUpdateTimer);
+            m_resourceUpdateTimer = 0.0f;
+        }
 
-                // Calculate maintenance costs for owned buildings
-                for (const auto &building : m_player.buildings)
-                {
-                    if (building && building->IsOwned())
-                    {
-                        totalMaintenance += building->GetMaintenanceCost();
-                    }
-                }
+        m_player.AdvanceJobs(deltaTime);
+    }
+}
 
-                // Deduct maintenance cost if player has enough money
-                if (m_player.money >= totalMaintenance)
-                {
-                    m_player.money -= totalMaintenance;
-                    m_player.totalSpent += totalMaintenance;
-                }
-                else
-                {
-                    float availableMoney = m_player.money;
-                    m_player.money = 0.0f;
-                    m_player.totalSpent += availableMoney;
-                }
+// Functions
+void TycoonGame::TryStartSteadyProduction()
+{
+    // Rates run at the average bonus in either mode; stochastic rolls are
+    // settled against that average later
+    std::array<float, RESOURCE_TYPE_COUNT> rate{};
+    std::array<float, RESOURCE_TYPE_COUNT> floor{};
+    for (const auto &building : m_player.buildings)
+    {
+        if (!building || !building->IsOwned() || !building->IsOperational())
+            continue;
+        if (building->GetEfficiency() < 1.0f)
+            return;
 
-                m_maintenanceUpdateTimer = 0.0f;
-            }
+        // Holding a second of fuel keeps raw efficiency at 1 and the
+        // solver granting every request in full
+        float perSecond = building->GetBaseProductionRate();
+        for (const auto &in : building->GetInputResources())
+            floor[static_cast<size_t>(in.GetType())] += perSecond * in.GetProductionRate() * Building::FUEL_CONSUMPTION_FACTOR;
 
-            // Update all buildings
-            for (auto &building : m_player.buildings)
-            {
-                if (building && building->IsOwned() && building->IsOperational())
-                {
-                    building->Update(deltaTime);
-                }
-            }
+        // buildings without outputs (Research Lab) burn no fuel per frame
+        if (building->GetOutputResources().empty())
+            continue;
+        perSecond *= GetExpectedProductionBonus(building->GetType(), building->GetLevel());
+        for (const auto &in : building->GetInputResources())
+            rate[static_cast<size_t>(in.GetType())] -= perSecond * in.GetProductionRate() * Building::FUEL_CONSUMPTION_FACTOR;
+        for (const auto &out : building->GetOutputResources())
+            rate[static_cast<size_t>(out.GetType())] += perSecond * out.GetProductionRate();
+    }
 
-            // Update all resources
-            m_resourceUpdateTimer += deltaTime;
-            if (m_resourceUpdateTimer >= GameConstants::RESOURCE_UPDATE_INTERVAL)
-            {
-                UpdateResources(m_resourceUpdateTimer);
-                m_resourceUpdateTimer = 0.0f;
-            }
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        if (m_player.ledger.Get(static_cast<ResourceType>(r)) < floor[r])
+            return;
+    }
 
-            // — Mirror the global pool back into your UI map —
-            auto &rm = ResourceManager::Instance();
-            for (auto &pair : m_player.resources)
-            {
-                float amt = rm.Get(pair.first);
-                pair.second.SetAmount(amt);
-                pair.second.SetOwned(amt > 0.0f);
-            }
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        m_player.ledger.SetRate(static_cast<ResourceType>(r), rate[r]);
+    m_steadyFloor = floor;
+    m_steadyProduction = true;
+    m_steadySettledTick = m_tick;
+    m_steadyPendingTime = 0.0f;
+}
 
-            // Update all productions
-            for (auto &production : m_player.productions)
-            {
-                if (production && production->IsInvested())
-                {
-                    production->SetTime(production->GetTime() + deltaTime);
-                    if (production->GetTime() >= production->GetCompletionTime())
-                    {
-                        production->SetIsInvested(false);
-                        production->SetTime(0.0f);
-                        m_player.money += production->GetCompletionAmount();
-                    }
-                }
-            }
-        }
-    }
-    catch (...)
+bool TycoonGame::IsSteadyProductionValid() const
+{
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
     {
-        // Log error but don't crash
-        fprintf(stderr, "Error in Update\n");
+        if (m_player.ledger.Get(static_cast<ResourceType>(r)) < m_steadyFloor[r])
+            return false;
     }
+    return true;
 }
 
-// Functions
-float TycoonGame::CalculateProductionMultiplier() const
+// Deposits the bonus rolls owed since the last settlement. Runs before
+// anything in the simulation reads the holdings: the resource update,
+// production jobs, market orders, saving and stopping. In between, the
+// holdings show the average, so the UI is at most half a second behind
+// the rolls.
+void TycoonGame::SettleSteadyProduction()
 {
-    try
-    {
-        float multiplier = GameConstants::BASE_PRODUCTION_MULTIPLIER;
+    if (!m_steadyProduction)
+        return;
+    if (m_simulationMode == SimulationMode::STOCHASTIC)
+        m_player.SettleBonusRolls(m_rngSeed, m_steadySettledTick, m_tick, m_steadyPendingTime);
+    m_steadySettledTick = m_tick;
+    m_steadyPendingTime = 0.0f;
+}
 
-        // Add reputation bonus
-        multiplier += m_player.reputation * GameConstants::REPUTATION_BONUS_MULTIPLIER;
+void TycoonGame::StopSteadyProduction()
+{
+    if (!m_steadyProduction)
+        return;
+    SettleSteadyProduction();
+    m_player.ledger.ClearRates();
+    m_steadyProduction = false;
+}
 
-        // Add Research Lab bonus
-        for (const auto &building : m_player.buildings)
-        {
-            if (building && building->IsOwned() && building->GetType() == BuildingType::RESEARCH_LAB)
-            {
-                multiplier += GameConstants::RESEARCH_LAB_BONUS_MULTIPLIER * building->GetLevel();
-            }
-        }
+void TycoonGame::UpdateEconomy(float deltaTime)
+{
+    // Update prices for all resources in one batched step, then let the
+    // impact of recent player trades fade
+    m_marketModel->Update(m_market, m_rngSeed, m_tick);
+    m_market.RecoverImpact(GameConstants::MARKET_IMPACT_RECOVERY);
+    m_player.SyncPrices(m_market);
+    RecordPrices();
+}
+
+void TycoonGame::SetMarketModel(MarketModelType type)
+{
+    // Order flow only means something to the model that recorded it
+    m_market.supply = {};
+    m_market.demand = {};
+    m_marketModel = MarketModel::Create(type);
+}
+
+void TycoonGame::RecordPrices()
+{
+    std::array<float, RESOURCE_TYPE_COUNT> prices{};
+    for (const auto &[type, resource] : m_player.resources)
+        prices[static_cast<size_t>(type)] = resource.GetBasePrice();
+    m_priceHistory.Record(prices);
+    m_marketArchive.Append(prices);
+    ++m_chartVersion;
+    if (m_archiveHours > 0.0f)
+        RefreshArchivePlots();
+}
 
-        return std::max(multiplier, GameConstants::BASE_PRODUCTION_MULTIPLIER);
+void TycoonGame::RestorePriceHistory()
+{
+    // Replay enough of the archive to refill every in-memory tier
+    const uint64_t sampleCount = m_marketArchive.GetSampleCount();
+    const uint64_t span = std::min<uint64_t>(sampleCount, PriceHistory::CAPACITY * PriceHistory::SAMPLES_PER_BUCKET * PriceHistory::SAMPLES_PER_BUCKET);
+    m_priceHistory.Clear();
+    ++m_chartVersion;
+    if (span == 0)
+    {
+        RecordPrices();
+        return;
     }
-    catch (...)
+
+    std::array<std::vector<float>, RESOURCE_TYPE_COUNT> columns;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        m_marketArchive.Query(static_cast<ResourceType>(r), sampleCount - span, sampleCount, static_cast<size_t>(span), columns[r]);
+
+    std::array<float, RESOURCE_TYPE_COUNT> prices{};
+    for (size_t i = 0; i < span; ++i)
     {
-        return GameConstants::BASE_PRODUCTION_MULTIPLIER;
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            prices[r] = i < columns[r].size() ? columns[r][i] : 0.0f;
+        m_priceHistory.Record(prices);
     }
 }
 
-void TycoonGame::UpdateResources(float deltaTime)
+bool TycoonGame::BuildStructure(BuildingType type)
 {
-    float productionMultiplier = CalculateProductionMultiplier();
-    auto &rm = ResourceManager::Instance();
+    // Rates and owed rolls belong to the buildings as they were
+    StopSteadyProduction();
+    return m_player.BuildStructure(type);
+}
 
-    for (auto &building : m_player.buildings)
-    {
-        if (!building || !building->IsOwned() || !building->IsOperational())
-            continue;
+bool TycoonGame::BeginProduction(ProductionType type)
+{
+    SettleSteadyProduction();
+    return m_player.BeginProduction(type);
+}
 
-        // 1) compute “raw” production this tick
-        float raw = building->GetBaseProductionRate() * building->GetEfficiency() * deltaTime * productionMultiplier;
+bool TycoonGame::SellStructure(int buildingIndex)
+{
+    StopSteadyProduction();
+    return m_player.SellStructure(buildingIndex);
+}
 
-        // 2) consume each input from the global pool
-        bool ok = true;
-        for (auto const &req : building->GetInputResources())
-        {
-            float need = raw * req.GetProductionRate();
-            if (!rm.Consume(req.GetType(), need))
-            {
-                ok = false;
-                break;
-            }
-        }
-        if (!ok)
-            continue;
+bool TycoonGame::UpgradeBuilding(int buildingIndex)
+{
+    // Rates were set for the old level
+    StopSteadyProduction();
+    return m_player.UpgradeBuilding(buildingIndex);
+}
 
-        // 3) deposit outputs into the global pool
-        for (auto const &out : building->GetOutputResources())
-        {
-            float give = raw * out.GetProductionRate();
-            rm.Add(out.GetType(), give);
-        }
-    }
+bool TycoonGame::UnlockStocks()
+{
+    return m_player.UnlockStocks();
 }
 
-void TycoonGame::UpdateEconomy(float deltaTime)
+bool TycoonGame::BuyResource(ResourceType type, float amount)
 {
-    // Update prices for all resources
-    for (auto &[type, resource] : m_player.resources)
-    {
-        if (type != ResourceType::MONEY)
-        {
-            resource.UpdatePrice(GameConstants::PRICE_VOLATILITY);
-        }
-    }
+    return ExecuteOrders({{type, amount, OrderSide::BUY}}).accepted;
 }
 
-void TycoonGame::UpdateReputation()
+bool TycoonGame::SellResource(ResourceType type, float amount)
 {
-    // Gain reputation based on owned buildings and their efficiency
-    int newReputation = 0;
-    for (const auto &building : m_player.buildings)
-    {
-        if (building && building->IsOwned())
-        {
-            // Base reputation gain from each building
-            newReputation += 1;
+    return ExecuteOrders({{type, amount, OrderSide::SELL}}).accepted;
+}
 
-            // Additional reputation for efficient buildings
-            if (building->GetEfficiency() > 0.8f)
-            {
-                newReputation += 1;
-            }
-        }
-    }
+ResourceAmounts TycoonGame::GetHoldings() const
+{
+    return m_player.GetHoldings();
+}
 
-    // Add reputation with diminishing returns
-    if (newReputation > 0)
-    {
-        m_player.reputation += static_cast<int>(newReputation * (100.0f / (100.0f + m_player.reputation)));
-    }
+OrderReport TycoonGame::QuoteOrders(const std::vector<MarketOrder> &orders) const
+{
+    return MarketOrders::Quote(m_market, GetHoldings(), orders);
 }
 
-bool TycoonGame::BuildStructure(BuildingType type)
+OrderReport TycoonGame::ExecuteOrders(const std::vector<MarketOrder> &orders)
 {
-    for (auto &building : m_player.buildings)
-    {
-        if (!building || building->GetType() != type)
-            continue;
-        if (building->IsOwned() ||
-            m_player.money < building->GetCost() ||
-            m_player.reputation < building->GetRequiredReputation())
-            return false;
+    SettleSteadyProduction();
+    return m_player.ExecuteOrders(m_market, orders);
+}
+
+float TycoonGame::CalculateResourcePrice(ResourceType type) const
+{
+    auto it = m_player.resources.find(type);
+    if (it == m_player.resources.end())
+        return 0.0f;
+    return it->second.GetBasePrice();
+}
 
-        m_player.money -= building->GetCost();
-        m_player.totalSpent += building->GetCost();
-        building->SetOwned(true);
+// Simulation thread
+void TycoonGame::StartSimulationThread()
+{
+    if (m_simulationRunning.exchange(true))
+        return;
+    PublishSnapshot();
+    m_simulationThread = std::thread(&TycoonGame::RunSimulation, this);
+}
 
-        constexpr float STARTER_FUEL = 20.0f;
-        auto &rm = ResourceManager::Instance();
-        for (auto const &req : building->GetInputResources())
-        {
-            rm.Add(req.GetType(), STARTER_FUEL);
-            auto &pr = m_player.resources[req.GetType()];
-            pr.SetAmount(pr.GetAmount() + STARTER_FUEL);
-            pr.SetOwned(true);
-        }
-        return true;
-    }
-    return false;
+void TycoonGame::StopSimulationThread()
+{
+    if (!m_simulationRunning.exchange(false))
+        return;
+    m_simulationThread.join();
+
+    // Commands posted during the last tick still count
+    ApplyCommands();
 }
 
-bool TycoonGame::BeginProduction(ProductionType type)
+void TycoonGame::RunSimulation()
 {
-    try
+    using Clock = std::chrono::steady_clock;
+    const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(GameConstants::SIMULATION_TICK));
+
+    auto next = Clock::now();
+    while (m_simulationRunning.load(std::memory_order_acquire))
     {
-        // Find production template
-        for (const auto &production : m_player.productions)
-        {
-            if (production && production->GetType() == type)
-            {
-                // Check if player has enough money and reputation
-                if (m_player.money < production->GetCost() || m_player.reputation < production->GetRequiredReputation())
-                    return false;
-
-                // Check if player already invested in this type of production
-                if (production->IsInvested())
-                    return false;
-
-                // Deduct cost and mark as invested
-                m_player.money -= production->GetCost();
-                m_player.totalSpent += production->GetCost();
-                production->SetIsInvested(true);
-                return true;
-            }
-        }
-        return false;
+        Update(GameConstants::SIMULATION_TICK);
+        PublishSnapshot();
+
+        // After a long stall, drop the backlog instead of racing through it
+        next += tick;
+        auto now = Clock::now();
+        if (now - next > tick * GameConstants::SIMULATION_MAX_CATCHUP_TICKS)
+            next = now;
+        std::this_thread::sleep_until(next);
     }
-    catch (...)
+}
+
+void TycoonGame::Post(const GameCommand &command)
+{
+    // Only a stalled simulation lets the queue fill up; without the thread
+    // nobody else will drain it, so apply what is queued here instead
+    while (!m_commands.TryPush(command))
     {
-        return false;
+        if (m_simulationRunning.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        else
+            ApplyCommands();
     }
 }
 
-bool TycoonGame::SellStructure(int buildingIndex)
+bool TycoonGame::OpenCommandLog(const std::string &filename)
 {
-    try
+    CloseCommandLog();
+    auto start = std::make_unique<GameState>();
+    if (!SaveState(*start))
     {
-        if (buildingIndex < 0 || buildingIndex >= static_cast<int>(m_player.buildings.size()))
-            return false;
-
-        auto &building = m_player.buildings[buildingIndex];
-        if (!building || !building->IsOwned())
-            return false;
-
-        // Return 50% of the building's cost
-        float refund = building->GetCost() * 0.5f;
-        m_player.money += refund;
-        m_player.totalEarnings += refund;
-
-        // Create a new building of the same type to replace the sold one
-        auto newBuilding = BuildingFactory::CreateBuilding(building->GetType());
-        if (newBuilding)
-        {
-            m_player.buildings[buildingIndex] = std::move(newBuilding);
-            return true;
-        }
+        fprintf(stderr, "Error recording: the game does not fit a GameState\n");
         return false;
     }
-    catch (...)
+    m_commandLog.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_commandLog.is_open())
     {
+        fprintf(stderr, "Error opening command log %s\n", filename.c_str());
         return false;
     }
+    const uint32_t magic = COMMAND_LOG_MAGIC;
+    m_commandLog.write(reinterpret_cast<const char *>(&magic), sizeof(magic));
+    m_commandLog.write(reinterpret_cast<const char *>(start.get()), sizeof(GameState));
+    return true;
 }
 
-bool TycoonGame::UpgradeBuilding(int buildingIndex)
+void TycoonGame::CloseCommandLog()
 {
-    try
-    {
-        if (buildingIndex < 0 || buildingIndex >= static_cast<int>(m_player.buildings.size()))
-            return false;
-
-        auto &building = m_player.buildings[buildingIndex];
-        if (!building || !building->IsOwned())
-            return false;
+    if (!m_commandLog.is_open())
+        return;
+    // A last record marks the tick the recording ran to
+    const GameCommand stop{CommandType::SET_RECORDING, 0, 0.0f, {}};
+    m_commandLog.write(reinterpret_cast<const char *>(&m_tick), sizeof(m_tick));
+    stop.Write(m_commandLog);
+    m_commandLog.close();
+}
 
-        if (m_player.money < building->GetUpgradeCost())
-            return false;
+void TycoonGame::ApplyCommands()
+{
+    GameCommand command;
+    while (m_commands.TryPop(command))
+        Execute(command);
+}
 
-        m_player.money -= building->GetUpgradeCost();
-        m_player.totalSpent += building->GetUpgradeCost();
-        return building->Upgrade();
+void TycoonGame::Execute(const GameCommand &command)
+{
+    const bool logged = m_commandLog.is_open() && !IsUnrecorded(command.type);
+    if (logged)
+    {
+        m_commandLog.write(reinterpret_cast<const char *>(&m_tick), sizeof(m_tick));
+        command.Write(m_commandLog);
     }
-    catch (...)
+    Apply(command);
+    if (logged && ReplacesState(command.type))
     {
-        return false;
+        auto state = std::make_unique<GameState>();
+        if (SaveState(*state))
+        {
+            m_commandLog.write(reinterpret_cast<const char *>(state.get()), sizeof(GameState));
+        }
+        else
+        {
+            fprintf(stderr, "Error recording: the game no longer fits a GameState\n");
+            m_commandLog.close();
+        }
     }
 }
 
-bool TycoonGame::BuyResource(ResourceType type, float amount)
+bool TycoonGame::ReplayCommandLog(const std::string &filename)
 {
-    auto it = m_player.resources.find(type);
-    if (it == m_player.resources.end())
-        return false;
-
-    float cost = amount * it->second.GetBasePrice();
-    if (m_player.money < cost)
+    CloseCommandLog();
+    std::ifstream file(filename, std::ios::binary);
+    uint32_t magic = 0;
+    auto state = std::make_unique<GameState>();
+    file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char *>(state.get()), sizeof(GameState));
+    if (!file || magic != COMMAND_LOG_MAGIC)
+    {
+        fprintf(stderr, "Error reading command log %s\n", filename.c_str());
         return false;
+    }
+    LoadState(*state);
 
-    m_player.money -= cost;
-    m_player.totalSpent += cost;
+    uint64_t tick = 0;
+    GameCommand command;
+    while (file.read(reinterpret_cast<char *>(&tick), sizeof(tick)) && command.Read(file))
+    {
+        // Each command was applied at the start of the tick that left m_tick
+        // at its recorded value
+        while (m_tick < tick)
+        {
+            if (m_isPaused)
+            {
+                fprintf(stderr, "Error replaying %s: paused at tick %llu, next command at %llu\n", filename.c_str(),
+                        static_cast<unsigned long long>(m_tick), static_cast<unsigned long long>(tick));
+                return false;
+            }
+            Step(GameConstants::SIMULATION_TICK);
+        }
 
-    it->second.SetAmount(it->second.GetAmount() + amount);
-    it->second.SetOwned(true);
+        if (ReplacesState(command.type))
+        {
+            if (!file.read(reinterpret_cast<char *>(state.get()), sizeof(GameState)))
+                break;
+            LoadState(*state);
+        }
+        else if (command.type == CommandType::SAVE_GAME)
+        {
+            // The file is not written again, but saving settled the rolls
+            SettleSteadyProduction();
+        }
+        else if (!IsUnrecorded(command.type))
+        {
+            Apply(command);
+        }
+    }
 
-    ResourceManager::Instance().Add(type, amount);
+    // A log cut short (the game was killed) replays as far as it goes
+    if (!file.eof())
+        fprintf(stderr, "Command log %s ends in a damaged record; replayed up to tick %llu\n", filename.c_str(),
+                static_cast<unsigned long long>(m_tick));
     return true;
 }
 
-bool TycoonGame::SellResource(ResourceType type, float amount)
+void TycoonGame::Apply(const GameCommand &command)
 {
-    auto it = m_player.resources.find(type);
-    if (it == m_player.resources.end() || !it->second.IsOwned())
-        return false;
+    switch (command.type)
+    {
+    case CommandType::NEW_GAME:
+        std::remove(SAVE_FILE);
+        Initialize();
+        RefreshArchivePlots();
+        break;
+    case CommandType::SAVE_GAME:
+        SaveGame(SAVE_FILE);
+        break;
+    case CommandType::LOAD_GAME:
+        LoadGame(SAVE_FILE);
+        RefreshArchivePlots();
+        break;
+    case CommandType::SET_PAUSED:
+        m_isPaused = command.value != 0.0f;
+        break;
+    case CommandType::BUILD:
+        BuildStructure(static_cast<BuildingType>(command.target));
+        break;
+    case CommandType::SELL_BUILDING:
+        SellStructure(command.target);
+        break;
+    case CommandType::UPGRADE_BUILDING:
+        UpgradeBuilding(command.target);
+        break;
+    case CommandType::SET_PRIORITY:
+        if (command.target >= 0 && command.target < static_cast<int>(m_player.buildings.size()))
+            m_player.buildings[command.target]->SetPriority(static_cast<int>(std::clamp(command.value, 0.0f, static_cast<float>(Building::MAX_PRIORITY))));
+        break;
+    case CommandType::BEGIN_PRODUCTION:
+        BeginProduction(static_cast<ProductionType>(command.target));
+        break;
+    case CommandType::EXECUTE_ORDERS:
+        ExecuteOrders(command.orders);
+        break;
+    case CommandType::UNLOCK_STOCKS:
+        UnlockStocks();
+        break;
+    case CommandType::SET_SIMULATION_MODE:
+        SetSimulationMode(static_cast<SimulationMode>(command.target));
+        break;
+    case CommandType::SET_MARKET_MODEL:
+        SetMarketModel(static_cast<MarketModelType>(command.target));
+        break;
+    case CommandType::SET_ARCHIVE_SPAN:
+        m_archiveHours = command.value;
+        RefreshArchivePlots();
+        break;
+    case CommandType::QUICK_SAVE:
+        if (!m_quickSave)
+            m_quickSave = std::make_unique<GameState>();
+        if (!SaveState(*m_quickSave))
+            m_quickSave.reset();
+        break;
+    case CommandType::QUICK_LOAD:
+        if (m_quickSave)
+            LoadState(*m_quickSave);
+        break;
+    case CommandType::SET_RECORDING:
+        if (command.value != 0.0f)
+            OpenCommandLog(COMMAND_LOG_FILE);
+        else
+            CloseCommandLog();
+        break;
+    case CommandType::REPLAY_RECORDING:
+        ReplayCommandLog(COMMAND_LOG_FILE);
+        break;
+    case CommandType::SET_AUTOPLAY:
+        SetAutoplay(command.value != 0.0f, static_cast<AutoPlayerStrategy>(command.target));
+        break;
+    }
+}
 
-    float have = it->second.GetAmount();
-    if (have < amount)
-        return false;
+// Copies each object into a reused vector; the derived building and
+// production types only configure their base, so slicing loses nothing.
+// Where the buffer already holds one of the same type, only its state is
+// copied: names and recipes are fixed by the type.
+template <typename T>
+static void CopyValues(std::vector<T> &to, const std::vector<std::unique_ptr<T>> &from)
+{
+    if (to.size() > from.size())
+        to.erase(to.begin() + from.size(), to.end());
+    for (size_t i = 0; i < from.size(); ++i)
+    {
+        if (i == to.size())
+            to.push_back(*from[i]);
+        else if (to[i].GetType() == from[i]->GetType())
+            to[i].CopyState(*from[i]);
+        else
+            to[i] = *from[i];
+    }
+}
 
-    float earnings = amount * it->second.GetBasePrice();
-    m_player.money += earnings;
-    m_player.totalEarnings += earnings;
+void TycoonGame::PublishSnapshot()
+{
+    GameSnapshot &snapshot = m_snapshots.GetWriteBuffer();
+    snapshot.tick = m_tick;
+    snapshot.gameTime = m_gameTime;
+    snapshot.ticksPerSecond = m_fps;
+    snapshot.isPaused = m_isPaused;
+    snapshot.hasQuickSave = m_quickSave != nullptr;
+    snapshot.isRecording = m_commandLog.is_open();
+    snapshot.isAutoplaying = m_autoPlayer != nullptr;
+    snapshot.autoplayStrategy = m_autoPlayer ? static_cast<int>(m_autoPlayer->GetSettings().strategy) : 0;
+
+    snapshot.ledger = m_player.ledger;
+    // The resource names never change, so after the first copy only the
+    // prices are taken
+    if (snapshot.resources.size() != m_player.resources.size())
+        snapshot.resources = m_player.resources;
+    auto resource = snapshot.resources.begin();
+    for (const auto &[type, source] : m_player.resources)
+        (resource++)->second.SetBasePrice(source.GetBasePrice());
+    CopyValues(snapshot.buildings, m_player.buildings);
+    CopyValues(snapshot.productions, m_player.productions);
+    for (size_t p = 0; p < PRODUCTION_TYPE_COUNT; ++p)
+    {
+        ProductionType type = static_cast<ProductionType>(p);
+        GameSnapshot::JobSummary &jobs = snapshot.jobs[p];
+        jobs.running = m_player.jobs.GetRunningCount(type);
+        jobs.queued = m_player.jobs.GetQueuedCount(type);
+        const auto *leading = m_player.jobs.GetLeadingJob(type);
+        jobs.progress = (leading && leading->duration > 0) ? std::min(m_player.jobs.GetElapsed(*leading) / leading->duration, 1.0f) : 0.0f;
+    }
+    snapshot.reputation = m_player.reputation;
+    snapshot.totalEarnings = m_player.totalEarnings;
+    snapshot.totalSpent = m_player.totalSpent;
+    snapshot.hasStocksUnlocked = m_player.hasStocksUnlocked;
+    snapshot.productionMultiplier = m_player.CalculateProductionMultiplier();
+
+    snapshot.market = m_market;
+    snapshot.archiveHours = m_archiveHours;
+    if (snapshot.chartVersion != m_chartVersion)
+    {
+        snapshot.priceHistory = m_priceHistory;
+        snapshot.archivePlots = m_archivePlots;
+        snapshot.chartVersion = m_chartVersion;
+    }
+    snapshot.hasState = m_stateWanted.load(std::memory_order_relaxed) && SaveState(snapshot.state);
 
-    it->second.SetAmount(have - amount);
-    if (it->second.GetAmount() <= 0.0f)
-        it->second.SetOwned(false);
+    m_snapshots.Publish();
+}
 
-    ResourceManager::Instance().Consume(type, amount);
-    return true;
+void TycoonGame::RefreshArchivePlots()
+{
+    uint64_t sampleCount = m_marketArchive.GetSampleCount();
+    uint64_t span = std::max<uint64_t>(1, static_cast<uint64_t>(m_archiveHours * 3600.0f));
+    uint64_t first = sampleCount > span ? sampleCount - span : 0;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        if (m_archiveHours > 0.0f)
+            m_marketArchive.Query(static_cast<ResourceType>(r), first, sampleCount, ARCHIVE_PLOT_POINTS, m_archivePlots[r]);
+        else
+            m_archivePlots[r].clear();
+    }
+    ++m_chartVersion;
 }
 
-float TycoonGame::CalculateResourcePrice(ResourceType type) const
+void TycoonGame::SetAutoplay(bool enabled, AutoPlayerStrategy strategy)
 {
-    auto it = m_player.resources.find(type);
-    if (it == m_player.resources.end())
-        return 0.0f;
-    return it->second.GetBasePrice();
+    if (!enabled)
+    {
+        m_autoPlayer.reset();
+        return;
+    }
+    AutoPlayerSettings settings;
+    settings.strategy = strategy;
+    m_autoPlayer = std::make_unique<AutoPlayer>(settings);
+    m_nextAutoplayTime = 0.0f;
+}
+
+void TycoonGame::RunAutoplay()
+{
+    if (!m_autoPlayer || m_isPaused)
+        return;
+    // A new or loaded game may have turned the clock back
+    const float interval = m_autoPlayer->GetSettings().decisionInterval;
+    if (m_gameTime + interval < m_nextAutoplayTime)
+        m_nextAutoplayTime = 0.0f;
+    if (m_gameTime < m_nextAutoplayTime)
+        return;
+
+    std::vector<GameCommand> commands;
+    m_autoPlayer->Decide(m_player, m_market, commands);
+    for (const GameCommand &command : commands)
+        Execute(command);
+    m_nextAutoplayTime = m_gameTime + interval;
 }
 
 // Rendering
@@ -523,6 +769,14 @@ void TycoonGame::Render()
 {
     try
     {
+        // Without the simulation thread, snapshot what this thread just updated
+        if (!m_simulationRunning.load(std::memory_order_acquire))
+            PublishSnapshot();
+        m_view = &m_snapshots.Read();
+        // The simulation takes a GameState only while a forecast is on screen
+        m_stateWanted.store(m_forecastShown, std::memory_order_relaxed);
+        m_forecastShown = false;
+
         RenderMainMenu();
         RenderResourcesWindow();
         RenderProductionWindow();
@@ -552,29 +806,56 @@ void TycoonGame::RenderMainMenu()
             }
             if (ImGui::MenuItem("Save Game"))
             {
-                if (SaveGame("savegame.dat"))
-                {
-                }
+                Post({CommandType::SAVE_GAME});
             }
             if (ImGui::MenuItem("Load Save"))
             {
-                if (LoadGame("savegame.dat"))
-                {
-                }
+                Post({CommandType::LOAD_GAME});
             }
-            if (ImGui::MenuItem(m_isPaused ? "Resume" : "Pause"))
+            if (ImGui::MenuItem("Quick Save"))
             {
-                m_isPaused = !m_isPaused;
+                Post({CommandType::QUICK_SAVE});
+            }
+            if (ImGui::MenuItem("Quick Load", nullptr, false, m_view->hasQuickSave))
+            {
+                Post({CommandType::QUICK_LOAD});
+            }
+            if (ImGui::MenuItem("Record Commands", nullptr, m_view->isRecording))
+            {
+                Post({CommandType::SET_RECORDING, 0, m_view->isRecording ? 0.0f : 1.0f, {}});
+            }
+            if (ImGui::MenuItem("Replay Recording", nullptr, false, !m_view->isRecording))
+            {
+                Post({CommandType::REPLAY_RECORDING, 0, 0.0f, {}});
+            }
+            if (ImGui::MenuItem(m_view->isPaused ? "Resume" : "Pause"))
+            {
+                Post({CommandType::SET_PAUSED, 0, m_view->isPaused ? 0.0f : 1.0f});
             }
             ImGui::Separator();
             if (ImGui::MenuItem("Exit"))
             {
-                SaveGame("savegame.dat");
+                StopSimulationThread();
+                SaveGame(SAVE_FILE);
                 exit(0);
             }
             ImGui::EndMenu();
         }
 
+        if (ImGui::BeginMenu("Autoplay"))
+        {
+            const auto strategy = static_cast<AutoPlayerStrategy>(m_view->autoplayStrategy);
+            const bool greedy = m_view->isAutoplaying && strategy == AutoPlayerStrategy::GREEDY;
+            const bool search = m_view->isAutoplaying && strategy == AutoPlayerStrategy::SEARCH;
+            if (ImGui::MenuItem("Off", nullptr, !m_view->isAutoplaying))
+                Post({CommandType::SET_AUTOPLAY, 0, 0.0f, {}});
+            if (ImGui::MenuItem("Greedy", nullptr, greedy))
+                Post({CommandType::SET_AUTOPLAY, static_cast<int>(AutoPlayerStrategy::GREEDY), 1.0f, {}});
+            if (ImGui::MenuItem("Search", nullptr, search))
+                Post({CommandType::SET_AUTOPLAY, static_cast<int>(AutoPlayerStrategy::SEARCH), 1.0f, {}});
+            ImGui::EndMenu();
+        }
+
         if (ImGui::BeginMenu("Help"))
         {
             if (ImGui::MenuItem("About"))
@@ -593,42 +874,42 @@ void TycoonGame::RenderMainMenu()
             ImGui::Separator();
 
             // Game time
-            ImGui::Text("Time: %.1f seconds", m_gameTime);
+            ImGui::Text("Time: %.1f seconds", m_view->gameTime);
 
             // Reputation with progress bar
             ImGui::Separator();
-            ImGui::Text("Reputation: %d", m_player.reputation);
-            float repProgress = std::min(m_player.reputation / 200.0f, 1.0f);
+            ImGui::Text("Reputation: %d", m_view->reputation);
+            float repProgress = std::min(m_view->reputation / 200.0f, 1.0f);
             ImGui::ProgressBar(repProgress, ImVec2(-1.0f, 0.0f));
             ImGui::Separator();
 
             // Financial stats
-            ImGui::Text("Total Earnings: $%.1f", m_player.totalEarnings);
-            ImGui::Text("Total Spent: $%.1f", m_player.totalSpent);
-            ImGui::Text("Net Profit: $%.1f", m_player.totalEarnings - m_player.totalSpent);
+            ImGui::Text("Total Earnings: $%.1f", m_view->totalEarnings.ToDouble());
+            ImGui::Text("Total Spent: $%.1f", m_view->totalSpent.ToDouble());
+            ImGui::Text("Net Profit: $%.1f", (m_view->totalEarnings - m_view->totalSpent).ToDouble());
             ImGui::Separator();
 
             // Buildings owned
-            int ownedBuildings = static_cast<int>(std::count_if(m_player.buildings.begin(), m_player.buildings.end(),
-                                                                [](const std::unique_ptr<Building> &b)
-                                                                { return b->IsOwned(); }));
+            int ownedBuildings = static_cast<int>(std::count_if(m_view->buildings.begin(), m_view->buildings.end(),
+                                                                [](const Building &b)
+                                                                { return b.IsOwned(); }));
             ImGui::Text("Buildings Owned: %d", ownedBuildings);
 
             // Resources owned
-            int ownedResources = static_cast<int>(std::count_if(m_player.resources.begin(), m_player.resources.end(),
-                                                                [](const auto &pair)
-                                                                { return pair.second.IsOwned(); }));
+            int ownedResources = static_cast<int>(std::count_if(m_view->resources.begin(), m_view->resources.end(),
+                                                                [this](const auto &pair)
+                                                                { return m_view->ledger.Get(pair.first) > 0.0f; }));
             ImGui::Text("Resources Owned: %d", ownedResources);
 
             // Production multiplier
-            ImGui::Text("Production Mult: %.1fx", CalculateProductionMultiplier());
+            ImGui::Text("Production Mult: %.1fx", m_view->productionMultiplier);
 
             ImGui::EndMenu();
         }
 
         // Display FPS in the menu bar
-        ImGui::SameLine(ImGui::GetWindowWidth() - 100);
-        ImGui::Text("FPS: %.1f", m_fps);
+        ImGui::SameLine(ImGui::GetWindowWidth() - 110);
+        ImGui::Text("FPS: %.0f/%.0f", ImGui::GetIO().Framerate, m_view->ticksPerSecond);
 
         ImGui::EndMainMenuBar();
     }
@@ -644,8 +925,7 @@ void TycoonGame::RenderMainMenu()
 
         if (ImGui::Button("Confirm"))
         {
-            std::remove("savegame.dat");
-            Initialize();
+            Post({CommandType::NEW_GAME});
             ImGui::CloseCurrentPopup();
         }
         ImGui::SameLine();
@@ -710,7 +990,7 @@ void TycoonGame::RenderResourcesWindow()
     ImGui::Separator();
 
     ImGui::BeginChild("ResourcesList", ImVec2(-1.0f, -1.0f), true, ImGuiWindowFlags_AlwaysVerticalScrollbar);
-    for (const auto &[type, resource] : m_player.resources)
+    for (const auto &[type, resource] : m_view->resources)
     {
         if (type == ResourceType::MONEY)
             continue;
@@ -758,7 +1038,7 @@ void TycoonGame::RenderResourcesWindow()
         ImGui::PopStyleColor();
 
         float maxAmount = 100.0f;
-        float progress = std::min(resource.GetAmount() / maxAmount, 1.0f);
+        float progress = std::min(m_view->ledger.Get(type) / maxAmount, 1.0f);
         char decimal[32];
         snprintf(decimal, sizeof(decimal), "%.1f%%", progress * 100.0f);
         ImGui::ProgressBar(progress, ImVec2(-1.0f, 0.0f), decimal);
@@ -792,15 +1072,15 @@ void TycoonGame::RenderProductionWindow()
     ImGui::Separator();
 
     // Production display with icons and progress bars
-    for (const auto &production : m_player.productions)
+    for (const auto &production : m_view->productions)
     {
-        if (production->IsOwned())
+        if (production.IsOwned())
             continue;
-        ProductionType type = production->GetType();
+        ProductionType type = production.GetType();
         ImVec4 color = ImVec4(0.0f, 1.0f, 0.0f, 0.75f);
         const char *symbol = "";
 
-        if (m_player.reputation >= production->GetRequiredReputation())
+        if (m_view->reputation >= production.GetRequiredReputation())
         {
             switch (type)
             {
@@ -822,76 +1102,67 @@ void TycoonGame::RenderProductionWindow()
                 break;
             }
             ImGui::PushStyleColor(ImGuiCol_Text, color);
-            ImGui::Text("%s %s:", symbol, production->GetName().c_str());
+            ImGui::Text("%s %s:", symbol, production.GetName().c_str());
             ImGui::PopStyleColor();
             ImGui::SameLine(300.0f);
-            float completionTime = production->GetCompletionTime();
-            float progress = (completionTime > 0) ? std::min(production->GetTime() / completionTime, 1.0f) : 0.0f;
-            ImGui::ProgressBar(progress, ImVec2(120.0f, 0.0f)); // Adjust width as needed
+            // The bar follows the job of this type that started first
+            const GameSnapshot::JobSummary &jobs = m_view->jobs[static_cast<size_t>(type)];
+            ImGui::ProgressBar(jobs.progress, ImVec2(120.0f, 0.0f)); // Adjust width as needed
             ImGui::SameLine();
-            ImGui::Text("$%.2f per unit", production->GetCompletionAmount());
+            ImGui::Text("$%.2f per unit", production.GetCompletionAmount());
             ImGui::SameLine();
-            if (!production->IsInvested())
+            // Lists what one job draws from the stockpile
+            auto recipeTooltip = [&]()
+            {
+                for (const auto &in : production.GetInputs())
+                    ImGui::Text("Uses %.0f %s (have %.1f)", in.quantity, m_view->resources.at(in.type).GetName().c_str(), m_view->ledger.Get(in.type));
+            };
+            if (m_view->GetMoney() >= production.GetCost() && production.HasInputs(m_view->ledger))
             {
-                if (m_player.money >= production->GetCost())
+                if (ImGui::Button(("Invest##" + production.GetName()).c_str()))
                 {
-                    if (ImGui::Button(("Invest##" + production->GetName()).c_str()))
-                    {
-                        BeginProduction(production->GetType());
-                    }
-                    if (ImGui::IsItemHovered())
-                    {
-                        ImGui::BeginTooltip();
-                        ImGui::Text("Click to invest!");
-                        std::ostringstream oss;
-                        oss << "Costs " << std::fixed << std::setprecision(2) << production->GetCost() << "$ to invest here";
-                        std::string temp = oss.str();
-                        ImGui::SeparatorText(temp.c_str());
-                        ImGui::Text("Returns %.2f$ from investment", production->GetCompletionAmount());
-                        ImGui::EndTooltip();
-                    }
+                    Post({CommandType::BEGIN_PRODUCTION, static_cast<int>(production.GetType())});
                 }
-                else
+                if (ImGui::IsItemHovered())
                 {
-                    ImGui::BeginDisabled();
-                    if (ImGui::Button(("Invest##" + production->GetName()).c_str()))
-                    {
-                        // Invest action
-                    }
-                    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
-                    {
-                        ImGui::BeginTooltip();
-                        ImGui::Text("Keep saving!");
-                        std::ostringstream oss;
-                        oss << "Costs " << std::fixed << std::setprecision(2) << production->GetCost() << "$ to invest here";
-                        std::string temp = oss.str();
-                        ImGui::SeparatorText(temp.c_str());
-                        ImGui::Text("Returns %.2f$ from investment", production->GetCompletionAmount());
-                        ImGui::EndTooltip();
-                    }
-                    ImGui::EndDisabled();
+                    ImGui::BeginTooltip();
+                    ImGui::Text("Click to invest!");
+                    std::ostringstream oss;
+                    oss << "Costs " << std::fixed << std::setprecision(2) << production.GetCost() << "$ to invest here";
+                    std::string temp = oss.str();
+                    ImGui::SeparatorText(temp.c_str());
+                    ImGui::Text("Returns %.2f$ from investment", production.GetCompletionAmount());
+                    recipeTooltip();
+                    ImGui::EndTooltip();
                 }
             }
             else
             {
                 ImGui::BeginDisabled();
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.0f, 1.0f, 0.0f, 1.0f)); // Green
-                if (ImGui::Button(("Invested##" + production->GetName()).c_str()))
+                if (ImGui::Button(("Invest##" + production.GetName()).c_str()))
                 {
-                    BeginProduction(production->GetType());
+                    // Invest action
                 }
                 if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
                 {
                     ImGui::BeginTooltip();
-                    ImGui::Text("Currently Invested!");
-                    ImGui::Separator();
-                    ImGui::Text("Returns %.2f$ when complete", production->GetCompletionAmount());
-                    ImGui::Separator();
+                    ImGui::Text("Keep saving!");
+                    std::ostringstream oss;
+                    oss << "Costs " << std::fixed << std::setprecision(2) << production.GetCost() << "$ to invest here";
+                    std::string temp = oss.str();
+                    ImGui::SeparatorText(temp.c_str());
+                    ImGui::Text("Returns %.2f$ from investment", production.GetCompletionAmount());
+                    recipeTooltip();
                     ImGui::EndTooltip();
                 }
-                ImGui::PopStyleColor();
                 ImGui::EndDisabled();
             }
+
+            if (jobs.running + jobs.queued > 0)
+            {
+                ImGui::SameLine();
+                ImGui::Text("%zu running, %zu queued", jobs.running, jobs.queued);
+            }
             ImGui::Separator();
         }
     }
@@ -942,20 +1213,20 @@ void TycoonGame::RenderPurchaseBuildingsWindow()
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 0.8f, 0.0f, 1.0f));
     ImGui::Text("Available Buildings");
     ImGui::PopStyleColor();
-    ImGui::Text("* Reputation: %d", m_player.reputation);
+    ImGui::Text("* Reputation: %d", m_view->reputation);
     ImGui::Separator();
 
     // Building buttons with icons
     int availableBuildingIndex = 0; // Add counter for unique IDs
-    for (const auto &building : m_player.buildings)
+    for (const auto &building : m_view->buildings)
     {
-        if (building->IsOwned())
+        if (building.IsOwned())
             continue;
 
         std::string buttonText = "";
         const char *symbol = "";
 
-        switch (building->GetType())
+        switch (building.GetType())
         {
         case BuildingType::WOODCUTTER:
             symbol = "[WC]";
@@ -978,22 +1249,23 @@ void TycoonGame::RenderPurchaseBuildingsWindow()
         }
 
         // Create unique button text with ID
-        std::string uniqueButtonText = std::string(symbol) + " " + building->GetName() + " ($" +
-                                       std::to_string(static_cast<int>(building->GetCost())) + ")##available_" + std::to_string(availableBuildingIndex);
+        std::string uniqueButtonText = std::string(symbol) + " " + building.GetName() + " ($" +
+                                       std::to_string(static_cast<int>(building.GetCost())) + ")##available_" + std::to_string(availableBuildingIndex);
 
-        if (m_player.reputation >= building->GetRequiredReputation())
+        if (m_view->reputation >= building.GetRequiredReputation())
         {
 
-            if (m_player.money >= building->GetCost())
+            if (m_view->GetMoney() >= building.GetCost())
             {
                 if (ImGui::Button(uniqueButtonText.c_str()))
                 {
-                    BuildStructure(building->GetType());
+                    Post({CommandType::BUILD, static_cast<int>(building.GetType())});
                 }
                 if (ImGui::IsItemHovered())
                 {
                     ImGui::BeginTooltip();
                     ImGui::Text("Click to purchase!");
+                    RenderForecast({CommandType::BUILD, static_cast<int>(building.GetType())});
                     ImGui::EndTooltip();
                 }
             }
@@ -1003,7 +1275,7 @@ void TycoonGame::RenderPurchaseBuildingsWindow()
 
                 if (ImGui::Button(uniqueButtonText.c_str()))
                 {
-                    BuildStructure(building->GetType());
+                    Post({CommandType::BUILD, static_cast<int>(building.GetType())});
                 }
                 if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
                 {
@@ -1021,7 +1293,7 @@ void TycoonGame::RenderPurchaseBuildingsWindow()
             if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
             {
                 ImGui::BeginTooltip();
-                ImGui::Text("Requires %s reputation.", std::to_string(building->GetRequiredReputation()).c_str());
+                ImGui::Text("Requires %s reputation.", std::to_string(building.GetRequiredReputation()).c_str());
                 ImGui::EndTooltip();
             }
             ImGui::EndDisabled();
@@ -1050,14 +1322,14 @@ void TycoonGame::RenderBuildingsWindow()
     std::map<BuildingType, int> ownedBuildingIndices;
 
     // First, find the indices of owned buildings in the original vector
-    for (size_t j = 0; j < m_player.buildings.size(); j++)
+    for (size_t j = 0; j < m_view->buildings.size(); j++)
     {
-        if (m_player.buildings[j]->IsOwned())
+        if (m_view->buildings[j].IsOwned())
         {
             // Only keep the first occurrence of each building type
-            if (ownedBuildingIndices.find(m_player.buildings[j]->GetType()) == ownedBuildingIndices.end())
+            if (ownedBuildingIndices.find(m_view->buildings[j].GetType()) == ownedBuildingIndices.end())
             {
-                ownedBuildingIndices[m_player.buildings[j]->GetType()] = static_cast<int>(j);
+                ownedBuildingIndices[m_view->buildings[j].GetType()] = static_cast<int>(j);
             }
         }
     }
@@ -1066,37 +1338,55 @@ void TycoonGame::RenderBuildingsWindow()
     int buildingIndex = 0;
     for (const auto &pair : ownedBuildingIndices)
     {
-        const auto &building = m_player.buildings[pair.second];
+        const Building &building = m_view->buildings[pair.second];
         int originalIndex = pair.second;
 
         // Use a unique ID for each tree node to prevent duplicates
-        std::string treeNodeId = building->GetName() + "##" + std::to_string(buildingIndex++);
+        std::string treeNodeId = building.GetName() + "##" + std::to_string(buildingIndex++);
 
         if (ImGui::TreeNode(treeNodeId.c_str()))
         {
             // Level and efficiency
-            ImGui::Text("Level: %d", building->GetLevel());
-            ImGui::Text("Efficiency: %.1f%%", building->GetEfficiency() * 100.0f);
-            ImGui::ProgressBar(building->GetEfficiency(), ImVec2(-1.0f, 0.0f));
+            ImGui::Text("Level: %d", building.GetLevel());
+            ImGui::Text("Efficiency: %.1f%%", building.GetEfficiency() * 100.0f);
+            ImGui::ProgressBar(building.GetEfficiency(), ImVec2(-1.0f, 0.0f));
 
             // Production rate
-            ImGui::Text("Production Rate: %.1f/s", building->GetBaseProductionRate() * CalculateProductionMultiplier());
+            ImGui::Text("Production Rate: %.1f/s", building.GetBaseProductionRate() * m_view->productionMultiplier);
 
             // Maintenance cost
-            ImGui::Text("Maintenance: $%.2f/s", building->GetMaintenanceCost());
+            ImGui::Text("Maintenance: $%.2f/s", building.GetMaintenanceCost());
+
+            // Input priority, only meaningful for buildings that burn fuel
+            if (!building.GetInputResources().empty())
+            {
+                int priority = building.GetPriority();
+                std::string priorityId = "Priority##priority" + std::to_string(originalIndex);
+                if (ImGui::SliderInt(priorityId.c_str(), &priority, 0, Building::MAX_PRIORITY))
+                {
+                    Post({CommandType::SET_PRIORITY, originalIndex, static_cast<float>(priority)});
+                }
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::BeginTooltip();
+                    ImGui::Text("Higher priority buildings get scarce inputs first.");
+                    ImGui::EndTooltip();
+                }
+            }
 
-            // Upgrade button - use a unique ID for each button (show if has enough to upgrade & not max level; hardcoded to 5)
-            if (static_cast<int>(building->GetUpgradeCost()) < m_player.money && static_cast<int>(building->GetLevel()) < 5)
+            // Upgrade button - use a unique ID for each button (show if has enough to upgrade & not max level)
+            if (static_cast<int>(building.GetUpgradeCost()) < m_view->GetMoney() && building.GetLevel() < Building::MAX_LEVEL)
             {
-                std::string upgradeButtonId = "Upgrade ($" + std::to_string(static_cast<int>(building->GetUpgradeCost())) + ")##upgrade" + std::to_string(originalIndex);
+                std::string upgradeButtonId = "Upgrade ($" + std::to_string(static_cast<int>(building.GetUpgradeCost())) + ")##upgrade" + std::to_string(originalIndex);
                 if (ImGui::Button(upgradeButtonId.c_str()))
                 {
-                    UpgradeBuilding(originalIndex);
+                    Post({CommandType::UPGRADE_BUILDING, originalIndex});
                 }
                 if (ImGui::IsItemHovered())
                 {
                     ImGui::BeginTooltip();
                     ImGui::Text("Click to upgrade!");
+                    RenderForecast({CommandType::UPGRADE_BUILDING, originalIndex});
                     ImGui::EndTooltip();
                 }
             }
@@ -1105,7 +1395,7 @@ void TycoonGame::RenderBuildingsWindow()
             std::string sellButtonId = "Sell##building" + std::to_string(originalIndex);
             if (ImGui::Button(sellButtonId.c_str()))
             {
-                SellStructure(originalIndex);
+                Post({CommandType::SELL_BUILDING, originalIndex});
             }
 
             ImGui::TreePop();
@@ -1115,6 +1405,62 @@ void TycoonGame::RenderBuildingsWindow()
     ImGui::End();
 }
 
+void TycoonGame::RenderForecast(const GameCommand &action)
+{
+    m_forecastShown = true;
+    if (!m_view->hasState)
+        return;
+    if (!m_forecaster)
+        m_forecaster = std::make_unique<Forecaster>();
+
+    ImGui::Separator();
+    if (!m_forecaster->Request(m_view->state, action, m_forecast))
+    {
+        ImGui::Text("Forecasting...");
+        return;
+    }
+    if (!m_forecast.actionApplied)
+    {
+        ImGui::Text("Not possible right now.");
+        return;
+    }
+
+    const size_t done = m_forecast.GetSampleCount();
+    const float minutes = static_cast<float>(done - 1) * m_forecast.interval / 60.0f;
+    ImGui::Text("Next %.0f minutes%s", minutes, m_forecast.complete ? "" : " ...");
+
+    // Both money curves on one scale, drawn at full width even while the
+    // forecast is still filling in
+    const auto &without = m_forecast.curves[Forecast::WITHOUT_ACTION];
+    const auto &with = m_forecast.curves[Forecast::WITH_ACTION];
+    const size_t money = static_cast<size_t>(ResourceType::MONEY);
+    auto range = std::minmax_element(without[money].begin(), without[money].end());
+    auto rangeWith = std::minmax_element(with[money].begin(), with[money].end());
+    float minVal = std::min(*range.first, *rangeWith.first);
+    float maxVal = std::max(*range.second, *rangeWith.second);
+    if (minVal == maxVal)
+        maxVal += 1.0f;
+
+    const ImVec2 plotSize(220.0f, 50.0f);
+    const int count = static_cast<int>(m_forecast.sampleCount);
+    ImGui::Text("Money without: $%.0f", m_forecast.GetLast(Forecast::WITHOUT_ACTION, ResourceType::MONEY));
+    ImGui::PlotLines("##forecast_without", without[money].data(), static_cast<int>(done), 0, nullptr, minVal, maxVal, plotSize);
+    ImGui::Text("Money with: $%.0f", m_forecast.GetLast(Forecast::WITH_ACTION, ResourceType::MONEY));
+    ImGui::PlotLines("##forecast_with", with[money].data(), static_cast<int>(done), 0, nullptr, minVal, maxVal, plotSize);
+    if (static_cast<int>(done) < count)
+        ImGui::ProgressBar(static_cast<float>(done) / static_cast<float>(count), ImVec2(plotSize.x, 0.0f));
+
+    // Where the holdings end up, as a difference the action makes
+    for (const auto &[type, resource] : m_view->resources)
+    {
+        if (type == ResourceType::MONEY)
+            continue;
+        float change = m_forecast.GetLast(Forecast::WITH_ACTION, type) - m_forecast.GetLast(Forecast::WITHOUT_ACTION, type);
+        if (std::fabs(change) >= 0.1f)
+            ImGui::Text("%s: %+.1f", resource.GetName().c_str(), change);
+    }
+}
+
 void TycoonGame::RenderMarketWindow()
 {
     ImGui::SetNextWindowPos(ImVec2(160, 30), ImGuiCond_FirstUseEver);
@@ -1129,17 +1475,17 @@ void TycoonGame::RenderMarketWindow()
 
     // Money display with icon
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.84f, 0.0f, 1.0f)); // Gold color
-    ImGui::Text("$ Money: %.2f", m_player.money);
+    ImGui::Text("$ Money: %.2f", m_view->GetMoney());
     ImGui::PopStyleColor();
     ImGui::Separator();
 
     // Get all resource types that are produced by owned buildings
     std::vector<ResourceType> producibleResources;
-    for (const auto &building : m_player.buildings)
+    for (const auto &building : m_view->buildings)
     {
-        if (building->IsOwned())
+        if (building.IsOwned())
         {
-            for (const auto &output : building->GetOutputResources())
+            for (const auto &output : building.GetOutputResources())
             {
                 if (std::find(producibleResources.begin(), producibleResources.end(), output.GetType()) == producibleResources.end())
                 {
@@ -1149,8 +1495,31 @@ void TycoonGame::RenderMarketWindow()
         }
     }
 
+    // Bulk orders over everything the buildings produce, each filled as one batch
+    ResourceAmounts produced{};
+    ResourceAmounts holdings = m_view->GetHoldings();
+    for (ResourceType type : producibleResources)
+        produced[static_cast<size_t>(type)] = holdings[static_cast<size_t>(type)];
+
+    auto bulkSellButton = [&](const char *label, const std::vector<MarketOrder> &orders)
+    {
+        bool empty = orders.empty();
+        if (empty)
+            ImGui::BeginDisabled();
+        if (ImGui::Button(label))
+            Post({CommandType::EXECUTE_ORDERS, 0, 0.0f, orders});
+        if (empty)
+            ImGui::EndDisabled();
+        if (!empty && ImGui::IsItemHovered())
+            ImGui::SetTooltip("Sells for $%.2f", m_view->QuoteOrders(orders).proceeds);
+    };
+    bulkSellButton("Sell All Produced", MarketOrders::SellAll(produced));
+    ImGui::SameLine();
+    bulkSellButton("Sell 25% Each", MarketOrders::SellFraction(produced, 0.25f));
+    ImGui::Separator();
+
     // Show only resources that can be produced
-    for (const auto &[type, resource] : m_player.resources)
+    for (const auto &[type, resource] : m_view->resources)
     {
         if (type != ResourceType::MONEY &&
             std::find(producibleResources.begin(), producibleResources.end(), type) != producibleResources.end())
@@ -1196,27 +1565,41 @@ void TycoonGame::RenderMarketWindow()
             ImGui::Text("%s %s", symbol, resource.GetName().c_str());
             ImGui::PopStyleColor();
 
+            float amount = m_view->ledger.Get(type);
             ImGui::Text("$ Current Price: %.2f", resource.GetBasePrice());
-            ImGui::Text("Storage Used: %.1f%%", resource.GetAmount());
+            ImGui::Text("Storage Used: %.1f%%", amount);
 
-            if (resource.GetAmount() > 0)
+            if (amount > 0)
             {
+                // Quotes are closed-form, so previewing slippage costs nothing
+                auto previewSale = [&](float amount)
+                {
+                    if (!ImGui::IsItemHovered() || amount <= 0.0f)
+                        return;
+                    float proceeds = m_view->market.QuoteSell(type, amount);
+                    float slippage = 1.0f - proceeds / (amount * resource.GetBasePrice());
+                    ImGui::SetTooltip("Sell %.1f for $%.2f (%.1f%% slippage)", amount, proceeds, slippage * 100.0f);
+                };
+
                 ImGui::BeginGroup();
                 std::string resourceId = std::to_string(static_cast<int>(type));
                 if (ImGui::Button(("Sell 1%##" + resourceId).c_str()))
                 {
-                    SellResource(type, 1.0f);
+                    Post({CommandType::EXECUTE_ORDERS, 0, 0.0f, {{type, 1.0f, OrderSide::SELL}}});
                 }
+                previewSale(std::min(1.0f, amount));
                 ImGui::SameLine();
                 if (ImGui::Button(("Sell Half##" + resourceId).c_str()))
                 {
-                    SellResource(type, resource.GetAmount() * 0.5f);
+                    Post({CommandType::EXECUTE_ORDERS, 0, 0.0f, {{type, amount * 0.5f, OrderSide::SELL}}});
                 }
+                previewSale(amount * 0.5f);
                 ImGui::SameLine();
                 if (ImGui::Button(("Sell All##" + resourceId).c_str()))
                 {
-                    SellResource(type, resource.GetAmount());
+                    Post({CommandType::EXECUTE_ORDERS, 0, 0.0f, {{type, amount, OrderSide::SELL}}});
                 }
+                previewSale(amount);
                 ImGui::EndGroup();
             }
             else
@@ -1237,18 +1620,13 @@ void TycoonGame::RenderMarketWindow()
     ImGui::End();
 }
 
-constexpr int kHistorySize = 100;
-static std::map<ResourceType, std::vector<float>> resourceHistory;
-static std::map<ResourceType, int> historyOffset;
-static std::map<ResourceType, int> historyCount;
-
 void TycoonGame::RenderStockUnlockButton()
 {
-    if (m_player.hasStocksUnlocked)
+    if (m_view->hasStocksUnlocked)
         return;
 
-    bool canUnlock = m_player.reputation >= 40;
-    bool canAfford = m_player.money >= GameConstants::STOCK_GRAPH_UNLOCK_PRICE;
+    bool canUnlock = m_view->reputation >= 40;
+    bool canAfford = m_view->GetMoney() >= GameConstants::STOCK_GRAPH_UNLOCK_PRICE;
     bool isDisabled = !canUnlock || !canAfford;
 
     if (isDisabled)
@@ -1258,12 +1636,7 @@ void TycoonGame::RenderStockUnlockButton()
 
     if (ImGui::Button("Unlock Stocks!"))
     {
-        if (canUnlock && canAfford)
-        {
-            m_player.money -= GameConstants::STOCK_GRAPH_UNLOCK_PRICE;
-            m_player.totalSpent += GameConstants::STOCK_GRAPH_UNLOCK_PRICE;
-            m_player.hasStocksUnlocked = true;
-        }
+        Post({CommandType::UNLOCK_STOCKS});
     }
 
     if (isDisabled)
@@ -1308,7 +1681,7 @@ void TycoonGame::RenderStockWindow()
     ImGui::PopStyleColor();
     ImGui::Separator();
 
-    if (!m_player.hasStocksUnlocked)
+    if (!m_view->hasStocksUnlocked)
     {
         RenderStockUnlockButton();
     }
@@ -1322,11 +1695,11 @@ void TycoonGame::RenderStockWindow()
 
         // Get all resource types that are produced by owned buildings
         std::vector<ResourceType> producibleResources;
-        for (const auto &building : m_player.buildings)
+        for (const auto &building : m_view->buildings)
         {
-            if (building->IsOwned())
+            if (building.IsOwned())
             {
-                for (const auto &output : building->GetOutputResources())
+                for (const auto &output : building.GetOutputResources())
                 {
                     if (std::find(producibleResources.begin(), producibleResources.end(), output.GetType()) == producibleResources.end())
                     {
@@ -1336,14 +1709,37 @@ void TycoonGame::RenderStockWindow()
             }
         }
 
-        // Define history size for 60 seconds (1 sample per second)
-        const int kHistorySize = 60;
+        // Plot resolution: 60 samples of 1 s, 1 min or 1 h each, or any span
+        // of the archive on disk
+        static int resolution = 0;
+        ImGui::RadioButton("1s", &resolution, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("1m", &resolution, 1);
+        ImGui::SameLine();
+        ImGui::RadioButton("1h", &resolution, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("All", &resolution, 3);
+        auto tier = static_cast<PriceHistory::Resolution>(std::min(resolution, 2));
+        const bool archiveView = resolution == 3;
+
+        static float spanHours = 1.0f;
+        if (archiveView)
+        {
+            ImGui::SliderFloat("Hours", &spanHours, 0.1f, 24.0f * 90.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+        }
 
-        // Static map to track last update time per resource
-        static std::map<ResourceType, float> lastUpdateTime;
+        // The simulation queries the archive whenever a sample arrives, for
+        // the span asked for here; it stops once the view is left
+        static float requestedHours = 0.0f;
+        float wantedHours = archiveView ? spanHours : 0.0f;
+        if (wantedHours != requestedHours)
+        {
+            Post({CommandType::SET_ARCHIVE_SPAN, 0, wantedHours});
+            requestedHours = wantedHours;
+        }
 
         // Show only resources that can be produced
-        for (const auto &[type, resource] : m_player.resources)
+        for (const auto &[type, resource] : m_view->resources)
         {
             if (type != ResourceType::MONEY &&
                 std::find(producibleResources.begin(), producibleResources.end(), type) != producibleResources.end())
@@ -1384,42 +1780,23 @@ void TycoonGame::RenderStockWindow()
                     break;
                 }
 
-                // Initialize plot buffer if needed
-                if (resourceHistory[type].empty())
+                // Plot straight out of the ring buffer; PlotLines wraps at count
+                PriceHistory::Series series = m_view->priceHistory.GetSeries(type, tier);
+                if (archiveView)
                 {
-                    resourceHistory[type].resize(kHistorySize, resource.GetBasePrice());
-                    historyOffset[type] = 0;
-                    historyCount[type] = 1;                  // Start with one valid entry
-                    lastUpdateTime[type] = ImGui::GetTime(); // Initialize with current time
+                    const std::vector<float> &plot = m_view->archivePlots[static_cast<size_t>(type)];
+                    series = {plot.data(), static_cast<int>(plot.size()), 0};
                 }
 
-                // Update history buffer every second
-                float currentTime = ImGui::GetTime();
-                if (currentTime - lastUpdateTime[type] >= 1.0f) // Update every 1 second
-                {
-                    resourceHistory[type][historyOffset[type]] = resource.GetBasePrice();
-                    historyOffset[type] = (historyOffset[type] + 1) % kHistorySize;
-
-                    // Update the count, up to max size
-                    if (historyCount[type] < kHistorySize)
-                        historyCount[type]++;
-
-                    // Update last update time
-                    lastUpdateTime[type] = currentTime;
-                }
-
-                // Reorder data for plotting (oldest to newest)
-                std::vector<float> orderedHistory(historyCount[type]);
-                for (int i = 0; i < historyCount[type]; ++i)
+                // Compute min and max over valid data
+                float minVal = 0.0f, maxVal = 0.0f;
+                if (series.count > 0)
                 {
-                    int index = (historyOffset[type] - historyCount[type] + i + kHistorySize) % kHistorySize;
-                    orderedHistory[i] = resourceHistory[type][index];
+                    auto range = std::minmax_element(series.data, series.data + series.count);
+                    minVal = *range.first;
+                    maxVal = *range.second;
                 }
 
-                // Compute min and max over valid data
-                float minVal = *std::min_element(orderedHistory.begin(), orderedHistory.end());
-                float maxVal = *std::max_element(orderedHistory.begin(), orderedHistory.end());
-
                 // Handle flat line
                 if (minVal == maxVal)
                 {
@@ -1439,8 +1816,8 @@ void TycoonGame::RenderStockWindow()
 
                 // Live plot
                 std::string plotId = "##ResourcePlot_" + std::to_string(static_cast<int>(type));
-                ImGui::PlotLines(plotId.c_str(), orderedHistory.data(), orderedHistory.size(),
-                                 0, nullptr, minVal, maxVal, ImVec2(0, 60));
+                ImGui::PlotLines(plotId.c_str(), series.data, series.count,
+                                 series.offset, nullptr, minVal, maxVal, ImVec2(0, 60));
 
                 ImGui::Separator();
             }
@@ -1449,8 +1826,9 @@ void TycoonGame::RenderStockWindow()
     ImGui::End();
 }
 
-bool TycoonGame::SaveGame(const std::string &filename) const
+bool TycoonGame::SaveGame(const std::string &filename)
 {
+    SettleSteadyProduction();
     try
     {
         std::ofstream file(filename, std::ios::binary);
@@ -1468,10 +1846,15 @@ bool TycoonGame::SaveGame(const std::string &filename) const
         size_t nameLen = m_player.name.size();
         file.write(reinterpret_cast<const char *>(&nameLen), sizeof(nameLen));
         file.write(m_player.name.c_str(), nameLen);
-        file.write(reinterpret_cast<const char *>(&m_player.money), sizeof(m_player.money));
+        float money = m_player.GetMoney();
+        file.write(reinterpret_cast<const char *>(&money), sizeof(money));
         file.write(reinterpret_cast<const char *>(&m_player.reputation), sizeof(m_player.reputation));
-        file.write(reinterpret_cast<const char *>(&m_player.totalEarnings), sizeof(m_player.totalEarnings));
-        file.write(reinterpret_cast<const char *>(&m_player.totalSpent), sizeof(m_player.totalSpent));
+        // Floats here keep older builds able to read the file; the exact
+        // amounts are appended at the end
+        float totalEarnings = m_player.totalEarnings.ToFloat();
+        float totalSpent = m_player.totalSpent.ToFloat();
+        file.write(reinterpret_cast<const char *>(&totalEarnings), sizeof(totalEarnings));
+        file.write(reinterpret_cast<const char *>(&totalSpent), sizeof(totalSpent));
         file.write(reinterpret_cast<const char *>(&m_player.achievements), sizeof(m_player.achievements));
         size_t resCount = m_player.resources.size();
         file.write(reinterpret_cast<const char *>(&resCount), sizeof(resCount));
@@ -1483,9 +1866,9 @@ bool TycoonGame::SaveGame(const std::string &filename) const
             nameLen = r.GetName().size();
             file.write(reinterpret_cast<const char *>(&nameLen), sizeof(nameLen));
             file.write(r.GetName().c_str(), nameLen);
-            float amt = r.GetAmount();
+            float amt = m_player.ledger.Get(pr.first);
             float price = r.GetBasePrice();
-            bool owned = r.IsOwned();
+            bool owned = amt > 0.0f;
             file.write(reinterpret_cast<const char *>(&amt), sizeof(amt));
             file.write(reinterpret_cast<const char *>(&price), sizeof(price));
             file.write(reinterpret_cast<const char *>(&owned), sizeof(owned));
@@ -1525,9 +1908,11 @@ bool TycoonGame::SaveGame(const std::string &filename) const
             nameLen = p->GetName().size();
             file.write(reinterpret_cast<const char *>(&nameLen), sizeof(nameLen));
             file.write(p->GetName().c_str(), nameLen);
+            // Older builds ran one job per type; the full queue is appended below
+            const auto *leading = m_player.jobs.GetLeadingJob(p->GetType());
             bool isOwned = p->IsOwned();
-            float time = p->GetTime();
-            bool isInv = p->IsInvested();
+            float time = leading ? m_player.jobs.GetElapsed(*leading) : 0.0f;
+            bool isInv = leading != nullptr;
             float cost = p->GetCost();
             float reqRep = p->GetRequiredReputation();
             float compTime = p->GetCompletionTime();
@@ -1542,6 +1927,35 @@ bool TycoonGame::SaveGame(const std::string &filename) const
         }
         size_t stocks = m_player.hasStocksUnlocked ? 1u : 0u;
         file.write(reinterpret_cast<const char *>(&stocks), sizeof(stocks));
+        for (auto const &b : m_player.buildings)
+        {
+            int priority = b->GetPriority();
+            file.write(reinterpret_cast<const char *>(&priority), sizeof(priority));
+        }
+        file.write(reinterpret_cast<const char *>(&m_rngSeed), sizeof(m_rngSeed));
+        file.write(reinterpret_cast<const char *>(&m_tick), sizeof(m_tick));
+        m_marketArchive.Flush();
+        uint64_t archivedSamples = m_marketArchive.GetSampleCount();
+        file.write(reinterpret_cast<const char *>(&archivedSamples), sizeof(archivedSamples));
+        uint64_t jobCount = m_player.jobs.GetJobCount();
+        file.write(reinterpret_cast<const char *>(&jobCount), sizeof(jobCount));
+        m_player.jobs.ForEachJob([&file](const ProductionQueue::Job &job, float elapsed)
+        {
+            int type = static_cast<int>(job.type);
+            file.write(reinterpret_cast<const char *>(&type), sizeof(type));
+            file.write(reinterpret_cast<const char *>(&job.duration), sizeof(job.duration));
+            file.write(reinterpret_cast<const char *>(&job.payout), sizeof(job.payout));
+            file.write(reinterpret_cast<const char *>(&elapsed), sizeof(elapsed));
+        });
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            int64_t amount = m_player.ledger.GetExact(static_cast<ResourceType>(r)).GetRaw();
+            file.write(reinterpret_cast<const char *>(&amount), sizeof(amount));
+        }
+        int64_t earnings = m_player.totalEarnings.GetRaw();
+        int64_t spent = m_player.totalSpent.GetRaw();
+        file.write(reinterpret_cast<const char *>(&earnings), sizeof(earnings));
+        file.write(reinterpret_cast<const char *>(&spent), sizeof(spent));
         return true;
     }
     catch (...)
@@ -1550,6 +1964,50 @@ bool TycoonGame::SaveGame(const std::string &filename) const
     }
 }
 
+bool TycoonGame::SaveState(GameState &state) const
+{
+    state.seed = m_rngSeed;
+    state.marketSeed = m_rngSeed;
+    state.tick = m_tick;
+    state.time = m_gameTime;
+    state.economyTimer = m_economyUpdateTimer;
+    state.reputationTimer = m_reputationUpdateTimer;
+    state.maintenanceTimer = m_maintenanceUpdateTimer;
+    state.resourceTimer = m_resourceUpdateTimer;
+    state.paused = m_isPaused;
+    state.market = m_market;
+    state.marketModel = m_marketModel->GetType();
+    state.expectedValue = m_simulationMode == SimulationMode::EXPECTED_VALUE;
+    state.steadyProduction = m_steadyProduction;
+    state.steadyFloor = m_steadyFloor;
+    state.steadySettledTick = m_steadySettledTick;
+    state.steadyPendingTime = m_steadyPendingTime;
+    return m_player.SaveState(state.player);
+}
+
+void TycoonGame::LoadState(const GameState &state)
+{
+    m_rngSeed = state.seed;
+    m_tick = state.tick;
+    m_gameTime = state.time;
+    m_economyUpdateTimer = state.economyTimer;
+    m_reputationUpdateTimer = state.reputationTimer;
+    m_maintenanceUpdateTimer = state.maintenanceTimer;
+    m_resourceUpdateTimer = state.resourceTimer;
+    m_isPaused = state.paused;
+    m_market = state.market;
+    if (m_marketModel->GetType() != state.marketModel)
+        m_marketModel = MarketModel::Create(state.marketModel);
+    m_simulationMode = state.expectedValue ? SimulationMode::EXPECTED_VALUE : SimulationMode::STOCHASTIC;
+
+    // The ledger comes back with its rates, so steady production carries on
+    m_player.LoadState(state.player);
+    m_steadyProduction = state.steadyProduction;
+    m_steadyFloor = state.steadyFloor;
+    m_steadySettledTick = state.steadySettledTick;
+    m_steadyPendingTime = state.steadyPendingTime;
+}
+
 bool TycoonGame::LoadGame(const std::string &filename)
 {
     try
@@ -1570,14 +2028,19 @@ bool TycoonGame::LoadGame(const std::string &filename)
         file.read(reinterpret_cast<char *>(&nameLen), sizeof(nameLen));
         m_player.name.resize(nameLen);
         file.read(&m_player.name[0], nameLen);
-        file.read(reinterpret_cast<char *>(&m_player.money), sizeof(m_player.money));
+        float money;
+        file.read(reinterpret_cast<char *>(&money), sizeof(money));
         file.read(reinterpret_cast<char *>(&m_player.reputation), sizeof(m_player.reputation));
-        file.read(reinterpret_cast<char *>(&m_player.totalEarnings), sizeof(m_player.totalEarnings));
-        file.read(reinterpret_cast<char *>(&m_player.totalSpent), sizeof(m_player.totalSpent));
+        float totalEarnings, totalSpent;
+        file.read(reinterpret_cast<char *>(&totalEarnings), sizeof(totalEarnings));
+        file.read(reinterpret_cast<char *>(&totalSpent), sizeof(totalSpent));
+        m_player.totalEarnings = FixedAmount::FromFloat(totalEarnings);
+        m_player.totalSpent = FixedAmount::FromFloat(totalSpent);
         file.read(reinterpret_cast<char *>(&m_player.achievements), sizeof(m_player.achievements));
         size_t resCount;
         file.read(reinterpret_cast<char *>(&resCount), sizeof(resCount));
         m_player.resources.clear();
+        StopSteadyProduction();
         for (size_t i = 0; i < resCount; ++i)
         {
             int typeInt;
@@ -1587,23 +2050,19 @@ bool TycoonGame::LoadGame(const std::string &filename)
             std::string nm(nameLen, '\0');
             file.read(&nm[0], nameLen);
             float amt, price;
-            bool owned;
+            bool owned; // still in the file; holdings come from the ledger
             file.read(reinterpret_cast<char *>(&amt), sizeof(amt));
             file.read(reinterpret_cast<char *>(&price), sizeof(price));
             file.read(reinterpret_cast<char *>(&owned), sizeof(owned));
-            m_player.resources[type] = Resource(type, nm, amt, price, owned);
-        }
-        ResourceManager &rm = ResourceManager::Instance();
-        for (auto &p : m_player.resources)
-        {
-            float old = rm.Get(p.first);
-            if (old > 0.0f)
-                rm.Consume(p.first, old);
-            rm.Add(p.first, p.second.GetAmount());
+            m_player.resources[type] = Resource(type, nm, price);
+            m_player.ledger.Set(type, amt);
         }
+        // The MONEY slot of older saves was never kept up to date
+        m_player.ledger.Set(ResourceType::MONEY, money);
         size_t bldCount;
         file.read(reinterpret_cast<char *>(&bldCount), sizeof(bldCount));
         m_player.buildings.clear();
+        m_player.productionGraph.Invalidate();
         for (size_t i = 0; i < bldCount; ++i)
         {
             int typeInt;
@@ -1634,7 +2093,9 @@ bool TycoonGame::LoadGame(const std::string &filename)
             bld->SetUpgradeCost(upgrade);
             m_player.buildings.push_back(std::move(bld));
         }
-        InitializeProductionTypes();
+        m_player.InitializeProductionTypes();
+        std::vector<ProductionQueue::Job> legacyJobs;
+        std::vector<float> legacyElapsed;
         size_t prodCount;
         file.read(reinterpret_cast<char *>(&prodCount), sizeof(prodCount));
         for (size_t i = 0; i < prodCount; ++i)
@@ -1659,16 +2120,82 @@ bool TycoonGame::LoadGame(const std::string &filename)
                                    [&](auto const &p)
                                    { return p->GetName() == nm; });
             (*it)->SetOwned(isOwned);
-            (*it)->SetTime(time);
-            (*it)->SetIsInvested(isInv);
             (*it)->SetCost(cost);
             (*it)->SetRequiredReputation(reqRep);
             (*it)->SetCompletionTime(compTime);
             (*it)->SetCompletionAmount(compAmt);
+            if (isInv)
+            {
+                legacyJobs.push_back({(*it)->GetType(), compTime, compAmt, 0.0});
+                legacyElapsed.push_back(time);
+            }
         }
         size_t stocks;
         file.read(reinterpret_cast<char *>(&stocks), sizeof(stocks));
         m_player.hasStocksUnlocked = (stocks == 1);
+        // Input priorities were appended later; older saves simply end here
+        for (auto &b : m_player.buildings)
+        {
+            int priority = 0;
+            if (!file.read(reinterpret_cast<char *>(&priority), sizeof(priority)))
+                break;
+            b->SetPriority(std::clamp(priority, 0, Building::MAX_PRIORITY));
+        }
+        // Same for the bonus roll stream; older saves start a fresh one
+        uint64_t seed, tick;
+        if (file.read(reinterpret_cast<char *>(&seed), sizeof(seed)) &&
+            file.read(reinterpret_cast<char *>(&tick), sizeof(tick)))
+        {
+            m_rngSeed = seed;
+            m_tick = tick;
+        }
+        else
+        {
+            m_rngSeed = MakeRngSeed();
+            m_tick = 0;
+        }
+        // Market history written after this save was made is discarded;
+        // saves from before the archive existed keep whatever is on disk
+        uint64_t archivedSamples;
+        if (!file.read(reinterpret_cast<char *>(&archivedSamples), sizeof(archivedSamples)))
+            archivedSamples = UINT64_MAX;
+        m_market = MarketState::CreateDefault();
+        for (const auto &[type, resource] : m_player.resources)
+            m_market.price[static_cast<size_t>(type)] = resource.GetBasePrice();
+        m_marketArchive.Open(MARKET_ARCHIVE_FILE, archivedSamples);
+        RestorePriceHistory();
+        // Saves without the job queue keep their single invested job per type
+        uint64_t jobCount;
+        if (file.read(reinterpret_cast<char *>(&jobCount), sizeof(jobCount)))
+        {
+            for (uint64_t i = 0; i < jobCount; ++i)
+            {
+                int type;
+                float duration, payout, elapsed;
+                file.read(reinterpret_cast<char *>(&type), sizeof(type));
+                file.read(reinterpret_cast<char *>(&duration), sizeof(duration));
+                file.read(reinterpret_cast<char *>(&payout), sizeof(payout));
+                file.read(reinterpret_cast<char *>(&elapsed), sizeof(elapsed));
+                m_player.jobs.Enqueue(static_cast<ProductionType>(type), duration, payout, elapsed);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < legacyJobs.size(); ++i)
+                m_player.jobs.Enqueue(legacyJobs[i].type, legacyJobs[i].duration, legacyJobs[i].payout, legacyElapsed[i]);
+        }
+        // Exact fixed-point amounts; saves without them keep the floats read above
+        std::array<int64_t, RESOURCE_TYPE_COUNT> amounts;
+        int64_t earnings, spent;
+        if (file.read(reinterpret_cast<char *>(amounts.data()), sizeof(amounts)) &&
+            file.read(reinterpret_cast<char *>(&earnings), sizeof(earnings)) &&
+            file.read(reinterpret_cast<char *>(&spent), sizeof(spent)))
+        {
+            for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                m_player.ledger.SetExact(static_cast<ResourceType>(r), FixedAmount::FromRaw(amounts[r]));
+            m_player.totalEarnings = FixedAmount::FromRaw(earnings);
+            m_player.totalSpent = FixedAmount::FromRaw(spent);
+        }
         return true;
     }
     catch (...)
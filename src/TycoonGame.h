@@ -3,26 +3,36 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include "AutoPlayer.h"
+#include "Forecaster.h"
 #include "Resource.h"
 #include "Production.h"
 #include "Building.h"
 #include "GameConstants.h"
+#include "GameCommand.h"
+#include "GameSnapshot.h"
+#include "GameState.h"
+#include "ProductionGraph.h"
+#include "ProductionQueue.h"
+#include "PriceHistory.h"
+#include "MarketArchive.h"
+#include "MarketModel.h"
+#include "MarketOrders.h"
+#include "Player.h"
+#include "ResourceLedger.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
 
 
-// Player structure
-class Player
+// How per-frame production bonuses are resolved
+enum class SimulationMode
 {
-public:
-    std::string name;
-    std::map<ResourceType, Resource> resources;
-    std::vector<std::unique_ptr<Production>> productions;
-    std::vector<std::unique_ptr<Building>> buildings;
-    float money;
-    int reputation;
-    float totalEarnings;
-    float totalSpent;
-    int achievements;
-    bool hasStocksUnlocked = false;
+    STOCHASTIC,     // roll each building's bonus every frame
+    EXPECTED_VALUE  // apply the average bonus; for sweeps and fast-forward
 };
 
 // Game state class
@@ -39,29 +49,70 @@ public:
     void Update(float deltaTime);
     void Render();
 
+    // Runs Update() at a fixed tick on its own thread. Render() then only
+    // reads published snapshots, and player actions go through Post().
+    void StartSimulationThread();
+    void StopSimulationThread();
+
+    // Queues the command for the start of the next tick; call from the UI
+    // thread only
+    void Post(const GameCommand &command);
+
+    // Records the current GameState, then every applied command with its
+    // tick; call on the simulation thread (or post SET_RECORDING)
+    bool OpenCommandLog(const std::string &filename);
+    void CloseCommandLog();
+
+    // Loads the recorded starting state and plays the log back, applying
+    // each command before the tick it was recorded at, up to the tick the
+    // recording stopped. Ends in the state the recorded game was in.
+    bool ReplayCommandLog(const std::string &filename);
+
     // Game mechanics
     bool BuildStructure(BuildingType type);
     bool BeginProduction(ProductionType type);
     bool SellStructure(int buildingIndex);
-    void UpdateResources(float deltaTime);
     void UpdateEconomy(float deltaTime);
+    void RecordPrices();
+    void RestorePriceHistory();
     bool BuyResource(ResourceType type, float amount);
     bool SellResource(ResourceType type, float amount);
-    void UpdateReputation();
+
+    // Batched trading: validates the whole batch, then fills all of it with
+    // a single money update, or rejects it without touching anything
+    OrderReport QuoteOrders(const std::vector<MarketOrder> &orders) const;
+    OrderReport ExecuteOrders(const std::vector<MarketOrder> &orders);
+    ResourceAmounts GetHoldings() const;
     bool UpgradeBuilding(int buildingIndex);
+    bool UnlockStocks();
 
     // Save/Load functionality
-    bool SaveGame(const std::string& filename = "savegame.json") const;
+    bool SaveGame(const std::string& filename = "savegame.json");
     bool LoadGame(const std::string& filename = "savegame.json");
 
+    // The whole simulation as one flat block, and back; call on the
+    // simulation thread. Copying a GameState forks the game.
+    bool SaveState(GameState &state) const;
+    void LoadState(const GameState &state);
+
     // Getters
     const Player &GetPlayer() const { return m_player; }
     float GetGameTime() const { return m_gameTime; }
     bool IsPaused() const { return m_isPaused; }
     float GetFPS() const { return m_fps; }
+    const PriceHistory &GetPriceHistory() const { return m_priceHistory; }
+    SimulationMode GetSimulationMode() const { return m_simulationMode; }
 
     // Setters
     void SetPaused(bool paused) { m_isPaused = paused; }
+    void SetSimulationMode(SimulationMode mode)
+    {
+        // Rolls still owed are settled in the mode they were made in
+        StopSteadyProduction();
+        m_simulationMode = mode;
+    }
+    MarketModelType GetMarketModel() const { return m_marketModel->GetType(); }
+    void SetMarketModel(MarketModelType type);
 
 private:
     // Game state
@@ -76,13 +127,71 @@ private:
     float m_fps;
     int m_frameCount;
     float m_fpsUpdateTimer;
+    PriceHistory m_priceHistory;
+    MarketArchive m_marketArchive;
+    MarketState m_market = MarketState::CreateDefault();
+    std::unique_ptr<MarketModel> m_marketModel = MarketModel::Create(MarketModelType::RANDOM_WALK);
+
+    // Bonus rolls are a pure function of (seed, tick, building index)
+    uint64_t m_rngSeed;
+    uint64_t m_tick;
+    SimulationMode m_simulationMode = SimulationMode::STOCHASTIC;
+
+    // While production is steady it runs as ledger rates at the average
+    // bonus instead of per-frame writes; it stays steady as long as every
+    // input holds its floor. In stochastic mode the bonus rolls of the ticks
+    // since m_steadySettledTick are owed until something reads the holdings.
+    bool m_steadyProduction = false;
+    std::array<float, RESOURCE_TYPE_COUNT> m_steadyFloor{};
+    uint64_t m_steadySettledTick = 0;
+    float m_steadyPendingTime = 0.0f;
+
+    // Simulation thread. The UI sees the game only through m_view, the
+    // snapshot it last read, and changes it only through m_commands.
+    TripleBuffer<GameSnapshot> m_snapshots;
+    SpscQueue<GameCommand, 256> m_commands;
+    std::thread m_simulationThread;
+    std::atomic<bool> m_simulationRunning{false};
+    const GameSnapshot *m_view = nullptr;
+    std::ofstream m_commandLog;
+    float m_archiveHours = 0.0f;
+    std::array<std::vector<float>, RESOURCE_TYPE_COUNT> m_archivePlots;
+    uint64_t m_chartVersion = 0; // bumped whenever the price history or archive plots change
+    std::unique_ptr<GameState> m_quickSave; // QUICK_SAVE / QUICK_LOAD rollback point
+
+    // Autoplay decides on the simulation thread between the queued commands
+    // and the tick, as the server's bots do, so a search never holds up a
+    // frame; its commands are applied and recorded like the player's. Null
+    // while the player plays.
+    std::unique_ptr<AutoPlayer> m_autoPlayer;
+    float m_nextAutoplayTime = 0.0f;
+
+    // What-if curves for the Build and Upgrade buttons, forked from the
+    // snapshot and run on the forecaster's own thread
+    std::unique_ptr<Forecaster> m_forecaster;
+    Forecast m_forecast;
+
+    // Set by the UI for each frame that drew a forecast; the simulation only
+    // puts a GameState in the snapshot while it is set
+    std::atomic<bool> m_stateWanted{false};
+    bool m_forecastShown = false;
 
     // Helper functions
-    void InitializeResources();
-    void InitializeBuildingTypes();
-    void InitializeProductionTypes();
     float CalculateResourcePrice(ResourceType type) const;
-    float CalculateProductionMultiplier() const;
+    void TryStartSteadyProduction();
+    bool IsSteadyProductionValid() const;
+    void SettleSteadyProduction();
+    void StopSteadyProduction();
+    void RunSimulation();
+    void ApplyCommands();
+    void Execute(const GameCommand &command); // applies and records
+    void Step(float deltaTime); // one tick without draining commands
+    void Apply(const GameCommand &command);
+    void PublishSnapshot();
+    void RefreshArchivePlots();
+    void SetAutoplay(bool enabled, AutoPlayerStrategy strategy = AutoPlayerStrategy::GREEDY);
+    void RunAutoplay();
+    void RenderForecast(const GameCommand &action);
 
     // GUI rendering functions
     void RenderMainMenu();
@@ -0,0 +1,224 @@
+#include "World.h"
+#include <algorithm>
+#include "GameConstants.h"
+#include "JobSystem.h"
+#include "ProductionRng.h"
+
+World::World(uint64_t seed)
+    : m_seed(seed)
+{
+}
+
+size_t World::AddPlayer(const std::string &name)
+{
+    auto seat = std::make_unique<Seat>();
+    const size_t index = m_seats.size();
+
+    Player &player = seat->player;
+    player.name = name;
+    player.reputation = GameConstants::STARTING_REPUTATION;
+    player.achievements = 0;
+    player.InitializeResources();
+    player.InitializeBuildingTypes();
+    player.InitializeProductionTypes();
+    player.SyncPrices(m_market);
+
+    // Building indices repeat across players; their rolls must not
+    seat->seed = (static_cast<uint64_t>(ProductionRng::Generate(m_seed, index, 0)) << 32) |
+                 ProductionRng::Generate(m_seed, index, 1);
+
+    m_seats.push_back(std::move(seat));
+    return index;
+}
+
+void World::Apply(size_t player, const GameCommand &command)
+{
+    if (player >= m_seats.size())
+        return;
+
+    Player &target = m_seats[player]->player;
+    switch (command.type)
+    {
+    case CommandType::BUILD:
+        target.BuildStructure(static_cast<BuildingType>(command.target));
+        break;
+    case CommandType::SELL_BUILDING:
+        target.SellStructure(command.target);
+        break;
+    case CommandType::UPGRADE_BUILDING:
+        target.UpgradeBuilding(command.target);
+        break;
+    case CommandType::SET_PRIORITY:
+        if (command.target >= 0 && command.target < static_cast<int>(target.buildings.size()))
+            target.buildings[command.target]->SetPriority(static_cast<int>(std::clamp(command.value, 0.0f, static_cast<float>(Building::MAX_PRIORITY))));
+        break;
+    case CommandType::BEGIN_PRODUCTION:
+        target.BeginProduction(static_cast<ProductionType>(command.target));
+        break;
+    case CommandType::EXECUTE_ORDERS:
+        SubmitOrders(player, command.orders);
+        break;
+    case CommandType::UNLOCK_STOCKS:
+        target.UnlockStocks();
+        break;
+    default:
+        break;
+    }
+}
+
+void World::SubmitOrders(size_t player, const std::vector<MarketOrder> &orders)
+{
+    if (player >= m_seats.size())
+        return;
+
+    // Batches queued in one tick are filled together, all or nothing
+    Seat &seat = *m_seats[player];
+    seat.orders.insert(seat.orders.end(), orders.begin(), orders.end());
+    seat.hasOrders = true;
+}
+
+void World::SetMarketModel(MarketModelType type)
+{
+    // Order flow only means something to the model that recorded it
+    m_market.supply = {};
+    m_market.demand = {};
+    m_marketModel = MarketModel::Create(type);
+}
+
+bool World::SaveState(size_t player, GameState &state) const
+{
+    if (player >= m_seats.size())
+        return false;
+
+    state.seed = m_seats[player]->seed;
+    state.marketSeed = m_seed;
+    state.tick = m_tick;
+    state.time = m_time;
+    state.economyTimer = m_economyTimer;
+    state.reputationTimer = m_reputationTimer;
+    state.maintenanceTimer = m_maintenanceTimer;
+    state.resourceTimer = m_resourceTimer;
+    state.paused = false;
+    state.market = m_market;
+    state.marketModel = m_marketModel->GetType();
+    state.expectedValue = m_expectedValue;
+    state.steadyProduction = false;
+    state.steadyFloor = {};
+    state.steadySettledTick = 0;
+    state.steadyPendingTime = 0.0f;
+    return m_seats[player]->player.SaveState(state.player);
+}
+
+void World::LoadState(size_t player, const GameState &state)
+{
+    if (player >= m_seats.size())
+        return;
+
+    m_seed = state.marketSeed;
+    m_tick = state.tick;
+    m_time = state.time;
+    m_economyTimer = state.economyTimer;
+    m_reputationTimer = state.reputationTimer;
+    m_maintenanceTimer = state.maintenanceTimer;
+    m_resourceTimer = state.resourceTimer;
+    m_market = state.market;
+    if (m_marketModel->GetType() != state.marketModel)
+        m_marketModel = MarketModel::Create(state.marketModel);
+    m_expectedValue = state.expectedValue;
+
+    Seat &seat = *m_seats[player];
+    seat.seed = state.seed;
+    seat.orders.clear();
+    seat.hasOrders = false;
+    seat.player.LoadState(state.player);
+
+    // A world runs production frame by frame; fold in what the rates
+    // accrued and the rolls still owed, and carry on from there
+    if (state.steadyProduction)
+    {
+        if (!state.expectedValue)
+            seat.player.SettleBonusRolls(state.seed, state.steadySettledTick, state.tick, state.steadyPendingTime);
+        seat.player.ledger.ClearRates();
+    }
+}
+
+void World::Update(float deltaTime)
+{
+    deltaTime = std::min(deltaTime, GameConstants::MAX_DELTA_TIME);
+    m_time += deltaTime;
+    m_tick++;
+
+    // Prices move first, once for everybody
+    m_economyTimer += deltaTime;
+    const bool economyDue = m_economyTimer >= GameConstants::ECONOMY_UPDATE_INTERVAL;
+    if (economyDue)
+    {
+        m_marketModel->Update(m_market, m_seed, m_tick);
+        m_market.RecoverImpact(GameConstants::MARKET_IMPACT_RECOVERY);
+        m_economyTimer = 0.0f;
+    }
+
+    m_reputationTimer += deltaTime;
+    m_reputationDue = m_reputationTimer >= GameConstants::REPUTATION_UPDATE_INTERVAL;
+    if (m_reputationDue)
+        m_reputationTimer = 0.0f;
+
+    m_maintenanceTimer += deltaTime;
+    m_maintenanceDue = m_maintenanceTimer >= GameConstants::MAINTENANCE_UPDATE_INTERVAL;
+    if (m_maintenanceDue)
+        m_maintenanceTimer = 0.0f;
+
+    m_resourceTimer += deltaTime;
+    m_resourceElapsed = 0.0f;
+    if (m_resourceTimer >= GameConstants::RESOURCE_UPDATE_INTERVAL)
+    {
+        m_resourceElapsed = m_resourceTimer;
+        m_resourceTimer = 0.0f;
+    }
+
+    // Players never touch each other, and the market is read-only here
+    JobSystem::GetDefault().ParallelFor(m_seats.size(), GameConstants::PLAYERS_PER_JOB, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (economyDue)
+                m_seats[i]->player.SyncPrices(m_market);
+            UpdatePlayer(m_seats[i]->player, m_seats[i]->seed, deltaTime);
+        }
+    });
+
+    ClearOrders();
+}
+
+void World::UpdatePlayer(Player &player, uint64_t seed, float deltaTime)
+{
+    player.ledger.Advance(deltaTime);
+    if (m_reputationDue)
+        player.UpdateReputation();
+    if (m_maintenanceDue)
+        player.PayMaintenance();
+    player.UpdateBuildings(deltaTime, m_expectedValue, seed, m_tick);
+    if (m_resourceElapsed > 0.0f)
+        player.UpdateResources(m_resourceElapsed);
+    player.AdvanceJobs(deltaTime);
+}
+
+void World::ClearOrders()
+{
+    // Each batch walks the shared liquidity curve in turn, so later ones see
+    // the impact of earlier ones; the first seat rotates with the tick
+    const size_t count = m_seats.size();
+    if (count == 0)
+        return;
+
+    const size_t first = static_cast<size_t>(m_tick % count);
+    for (size_t k = 0; k < count; ++k)
+    {
+        Seat &seat = *m_seats[(first + k) % count];
+        if (!seat.hasOrders)
+            continue;
+        seat.report = seat.player.ExecuteOrders(m_market, seat.orders);
+        seat.orders.clear();
+        seat.hasOrders = false;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GameCommand.h"
+#include "GameState.h"
+#include "MarketModel.h"
+#include "MarketOrders.h"
+#include "Player.h"
+
+// Many players in one economy. Each tick every player advances on its own,
+// in parallel on the job system, reading the market but writing only its
+// own state. The players then meet in the market: queued orders are filled
+// one batch at a time, starting from a different player every tick, so the
+// outcome is deterministic and nobody always trades first.
+class World
+{
+public:
+    explicit World(uint64_t seed);
+
+    // Adds a player in the starting state; returns its index
+    size_t AddPlayer(const std::string &name);
+    size_t GetPlayerCount() const { return m_seats.size(); }
+    Player &GetPlayer(size_t index) { return m_seats[index]->player; }
+    const Player &GetPlayer(size_t index) const { return m_seats[index]->player; }
+
+    // Player actions between ticks. Orders wait for the next market phase;
+    // commands that only make sense for a single local game are ignored.
+    void Apply(size_t player, const GameCommand &command);
+    void SubmitOrders(size_t player, const std::vector<MarketOrder> &orders);
+
+    // Outcome of the player's last filled or rejected batch
+    const OrderReport &GetLastReport(size_t player) const { return m_seats[player]->report; }
+
+    void Update(float deltaTime);
+
+    const MarketState &GetMarket() const { return m_market; }
+    MarketModelType GetMarketModel() const { return m_marketModel->GetType(); }
+    void SetMarketModel(MarketModelType type);
+    uint64_t GetTick() const { return m_tick; }
+    float GetTime() const { return m_time; }
+
+    // Resolve bonus rolls at their average instead of rolling them
+    void SetExpectedValue(bool expectedValue) { m_expectedValue = expectedValue; }
+
+    // One player with the clock and the market. The clock and the market
+    // are shared, so loading is meant for a world of one player: a fork of
+    // a game that carries on from the same tick.
+    bool SaveState(size_t player, GameState &state) const;
+    void LoadState(size_t player, const GameState &state);
+
+private:
+    struct Seat
+    {
+        Player player;
+        uint64_t seed;                    // bonus rolls, distinct per player
+        std::vector<MarketOrder> orders;  // queued for the market phase
+        bool hasOrders = false;
+        OrderReport report;
+    };
+
+    void UpdatePlayer(Player &player, uint64_t seed, float deltaTime);
+    void ClearOrders();
+
+    std::vector<std::unique_ptr<Seat>> m_seats;
+    MarketState m_market = MarketState::CreateDefault();
+    // Prices follow the order flow of all players together
+    std::unique_ptr<MarketModel> m_marketModel = MarketModel::Create(MarketModelType::SUPPLY_DEMAND);
+    uint64_t m_seed;
+    uint64_t m_tick = 0;
+    float m_time = 0.0f;
+    bool m_expectedValue = false;
+
+    // Due flags for the periodic rules, shared by every player
+    float m_economyTimer = 0.0f;
+    float m_reputationTimer = 0.0f;
+    float m_maintenanceTimer = 0.0f;
+    float m_resourceTimer = 0.0f;
+    bool m_reputationDue = false;
+    bool m_maintenanceDue = false;
+    float m_resourceElapsed = 0.0f;
+};
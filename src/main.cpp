@@ -103,21 +103,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         g_game = new TycoonGame();
         g_game->Initialize();
 
+        // The game ticks on its own thread from here on; this loop only draws
+        g_game->StartSimulationThread();
+
         // Main loop
         bool done = false;
-        float deltaTime = 0.0f;
-        LARGE_INTEGER frequency, lastTime;
-        QueryPerformanceFrequency(&frequency);
-        QueryPerformanceCounter(&lastTime);
-
         while (!done)
         {
-            // Calculate delta time
-            LARGE_INTEGER currentTime;
-            QueryPerformanceCounter(&currentTime);
-            deltaTime = (float)(currentTime.QuadPart - lastTime.QuadPart) / frequency.QuadPart;
-            lastTime = currentTime;
-
             // Poll and handle messages (inputs, window resize, etc.)
             MSG msg;
             while (::PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
@@ -144,9 +136,6 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             ImGui_ImplWin32_NewFrame();
             ImGui::NewFrame();
 
-            // Update game state
-            g_game->Update(deltaTime);
-
             // Render game
             g_game->Render();
 
@@ -161,6 +150,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         }
 
         // Cleanup
+        g_game->StopSimulationThread();
         delete g_game;
         ImGui_ImplDX11_Shutdown();
         ImGui_ImplWin32_Shutdown();
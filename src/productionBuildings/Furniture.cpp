@@ -5,9 +5,8 @@ Furniture::Furniture()
     : Production(ProductionType::FURNITURE,                                                                       // type
                "Furniture Hut",                                                                                   // name
                200.0f,                                                                                            // cost
-               {},                                                                                                // no input resources
-               { Resource(ResourceType::MONEY, "Money", 0.0f, 1000, false) },                                     // output resources
-               0.0f,                                                                                              // time
+               { {ResourceType::WOOD, 20.0f} },                                                                   // input resources per job
+               {},                                                                                                // no outputs besides the money payout
                50.0f,                                                                                             // completionTime
                250.0f,                                                                                            // completionAmount
                3)                                                                                                 // required reputation
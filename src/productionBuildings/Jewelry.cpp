@@ -5,9 +5,9 @@ Jewelry::Jewelry()
     : Production(ProductionType::JEWELRY,                                                                         // type
                "Jewelry Manufacturing",                                                                           // name
                1180.0f,                                                                                           // cost
-               {},                                                                                                // no input resources
-               { Resource(ResourceType::MONEY, "Money", 0.0f, 1000, false) },                                     // output resources
-               0.0f,                                                                                              // time
+               { {ResourceType::GOLD, 3.0f},                                                                      // input resources per job
+                 {ResourceType::DIAMOND, 1.0f} },
+               {},                                                                                                // no outputs besides the money payout
                1000.0f,                                                                                           // completionTime
                2000.0f,                                                                                           // completionAmount
                26)                                                                                                // required reputation
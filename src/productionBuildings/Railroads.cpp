@@ -5,9 +5,9 @@ Railroads::Railroads()
     : Production(ProductionType::RAILROADS,                                                                       // type
                "Railroad Station",                                                                                // name
                980.60f,                                                                                           // cost
-               {},                                                                                                // no input resources
-               { Resource(ResourceType::MONEY, "Money", 0.0f, 1000, false) },                                     // output resources
-               0.0f,                                                                                              // time
+               { {ResourceType::STONE, 30.0f},                                                                    // input resources per job
+                 {ResourceType::IRON, 40.0f} },
+               {},                                                                                                // no outputs besides the money payout
                910.0f,                                                                                            // completionTime
                1870.00f,                                                                                          // completionAmount
                17)                                                                                                // required reputation
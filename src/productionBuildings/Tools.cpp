@@ -5,9 +5,9 @@ Tools::Tools()
     : Production(ProductionType::TOOLS,                                                                           // type
                "Tool Yard",                                                                                       // name
                380.0f,                                                                                            // cost
-               {},                                                                                                // no input resources
-               { Resource(ResourceType::MONEY, "Money", 0.0f, 1000, false) },                                     // output resources
-               0.0f,                                                                                              // time
+               { {ResourceType::WOOD, 10.0f},                                                                     // input resources per job
+                 {ResourceType::IRON, 15.0f} },
+               {},                                                                                                // no outputs besides the money payout
                490.0f,                                                                                            // completionTime
                845.50f,                                                                                           // completionAmount
                11)                                                                                                // required reputation
@@ -6,7 +6,4 @@ class DiamondMine : public Building
 public:
     DiamondMine();
     virtual ~DiamondMine() = default;
-
-    virtual void UpdateEfficiency(float deltaTime) override;
-    virtual float CalculateProduction(float deltaTime) const override;
 }; 
\ No newline at end of file
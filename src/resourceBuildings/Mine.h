@@ -5,8 +5,4 @@ class Mine : public Building
 {
 public:
     Mine();
-
-    // Override virtual methods to provide specific behavior
-    void UpdateEfficiency(float deltaTime) override;
-    float CalculateProduction(float deltaTime) const override;
 };
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "ResearchLab.h"
 #include "../GameConstants.h"
-#include "../ResourceManager.h"
 
 ResearchLab::ResearchLab()
     : Building(
@@ -8,29 +7,13 @@ ResearchLab::ResearchLab()
           "Research Lab",
           2000.0f,
           0.1f,
-          {Resource(ResourceType::ENERGY, "Energy", 0.0f, GameConstants::ENERGY_BASE_PRICE, false),
-           Resource(ResourceType::CRYSTAL, "Crystal", 0.0f, GameConstants::CRYSTAL_BASE_PRICE, false)},
+          {Resource(ResourceType::ENERGY, "Energy", GameConstants::ENERGY_BASE_PRICE),
+           Resource(ResourceType::CRYSTAL, "Crystal", GameConstants::CRYSTAL_BASE_PRICE)},
           {}, // no direct outputs
           GameConstants::RESEARCH_LAB_MAINTENANCE,
           1000.0f,
           50)
 {
+    // efficiency penalty while some / all fuel inputs are empty
+    SetStarvationFactors(0.3f, 0.1f);
 }
-
-void ResearchLab::UpdateEfficiency(float deltaTime)
-{
-    Building::UpdateEfficiency(deltaTime);
-
-    auto &rm = ResourceManager::Instance();
-    bool e = rm.Get(ResourceType::ENERGY) > 0.0f;
-    bool c = rm.Get(ResourceType::CRYSTAL) > 0.0f;
-    float factor = (!e && !c)   ? 0.1f
-                   : (!e || !c) ? 0.3f
-                                : 1.0f;
-    SetEfficiency(GetEfficiency() * factor);
-}
-
-float ResearchLab::CalculateProduction(float /*dt*/) const
-{
-    return 0.0f; // no direct resource output
-}
\ No newline at end of file
@@ -5,8 +5,4 @@ class ResearchLab : public Building
 {
 public:
     ResearchLab();
-
-    // Override virtual methods to provide specific behavior
-    void UpdateEfficiency(float deltaTime) override;
-    float CalculateProduction(float deltaTime) const override;
 };
\ No newline at end of file
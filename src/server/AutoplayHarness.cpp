@@ -0,0 +1,150 @@
+#include "AutoplayHarness.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../AutoPlayer.h"
+#include "../GameConstants.h"
+#include "../World.h"
+
+namespace
+{
+    constexpr float REPORT_INTERVAL = 600.0f; // game seconds
+
+    struct Bot
+    {
+        size_t player;
+        AutoPlayer planner;
+        double planningSeconds = 0.0;
+        size_t decisions = 0;
+        size_t forks = 0;
+    };
+
+    float GetNetWorth(const World &world, size_t player)
+    {
+        PlanModel model;
+        PlanState state = model.Observe(world.GetPlayer(player), world.GetMarket());
+        return model.GetNetWorth(state);
+    }
+}
+
+bool RunAutoplayHarness(size_t bots, float minutes, size_t iterations, uint64_t seed)
+{
+    using Clock = std::chrono::steady_clock;
+
+    World world(seed);
+    AutoPlayerSettings settings;
+    settings.iterations = iterations;
+    std::vector<Bot> players;
+    players.reserve(bots);
+    for (size_t i = 0; i < bots; ++i)
+    {
+        settings.strategy = i % 2 == 1 && iterations > 0 ? AutoPlayerStrategy::SEARCH : AutoPlayerStrategy::GREEDY;
+        settings.seed = seed + i;
+        players.push_back({world.AddPlayer("Bot " + std::to_string(i + 1)), AutoPlayer(settings)});
+    }
+    const float startWorth = bots > 0 ? GetNetWorth(world, 0) : 0.0f;
+
+    // Bots take turns deciding so planning spreads over the interval
+    const uint64_t decisionTicks = std::max<uint64_t>(1, std::lround(settings.decisionInterval / GameConstants::SIMULATION_TICK));
+    const uint64_t ticks = static_cast<uint64_t>(std::lround(minutes * 60.0f / GameConstants::SIMULATION_TICK));
+    const uint64_t reportTicks = static_cast<uint64_t>(std::lround(REPORT_INTERVAL / GameConstants::SIMULATION_TICK));
+
+    printf("%zu bots, %.0f game minutes, %zu search playouts per decision\n", bots, minutes, iterations);
+    printf("  %8s %14s %14s %12s\n", "minute", "greedy worth", "search worth", "reputation");
+
+    auto report = [&]()
+    {
+        double worth[2] = {}, reputation = 0.0;
+        size_t count[2] = {};
+        for (const Bot &bot : players)
+        {
+            size_t k = bot.planner.GetSettings().strategy == AutoPlayerStrategy::SEARCH ? 1 : 0;
+            worth[k] += GetNetWorth(world, bot.player);
+            count[k]++;
+            reputation += world.GetPlayer(bot.player).reputation;
+        }
+        printf("  %8.0f %14.0f %14.0f %12.1f\n", world.GetTime() / 60.0f,
+               count[0] ? worth[0] / count[0] : 0.0, count[1] ? worth[1] / count[1] : 0.0,
+               players.empty() ? 0.0 : reputation / players.size());
+    };
+
+    std::vector<GameCommand> commands;
+    const auto start = Clock::now();
+    for (uint64_t tick = 0; tick < ticks; ++tick)
+    {
+        for (size_t i = 0; i < players.size(); ++i)
+        {
+            Bot &bot = players[i];
+            if ((tick + i) % decisionTicks != 0)
+                continue;
+            commands.clear();
+            auto planStart = Clock::now();
+            bot.planner.Decide(world.GetPlayer(bot.player), world.GetMarket(), commands);
+            bot.planningSeconds += std::chrono::duration<double>(Clock::now() - planStart).count();
+            bot.decisions++;
+            bot.forks += bot.planner.GetLastForkCount();
+            for (const GameCommand &command : commands)
+                world.Apply(bot.player, command);
+        }
+        world.Update(GameConstants::SIMULATION_TICK);
+        if ((tick + 1) % reportTicks == 0)
+            report();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (ticks % reportTicks != 0)
+        report();
+
+    // What the bots found worth building, for balancing
+    printf("  owned per bot:");
+    for (size_t type = 0; type < BUILDING_TYPE_COUNT; ++type)
+    {
+        double owned = 0.0, levels = 0.0;
+        std::string name;
+        for (const Bot &bot : players)
+        {
+            for (const auto &building : world.GetPlayer(bot.player).buildings)
+            {
+                if (static_cast<size_t>(building->GetType()) != type)
+                    continue;
+                name = building->GetName();
+                if (building->IsOwned())
+                {
+                    owned += 1.0;
+                    levels += building->GetLevel();
+                }
+            }
+        }
+        if (!players.empty())
+            printf(" %s %.2f (L%.1f)", name.c_str(), owned / players.size(), owned > 0.0 ? levels / owned : 0.0);
+    }
+    printf("\n");
+
+    for (int k = 0; k < 2; ++k)
+    {
+        double planning = 0.0;
+        size_t decisions = 0, forks = 0;
+        for (const Bot &bot : players)
+        {
+            if ((bot.planner.GetSettings().strategy == AutoPlayerStrategy::SEARCH) != (k == 1))
+                continue;
+            planning += bot.planningSeconds;
+            decisions += bot.decisions;
+            forks += bot.forks;
+        }
+        if (decisions == 0)
+            continue;
+        printf("  %-6s %8zu decisions %10.1f us/decision", k == 1 ? "search" : "greedy", decisions, planning / decisions * 1e6);
+        if (forks > 0)
+            printf(" %10.0f forks/s", forks / planning);
+        printf("\n");
+    }
+    printf("  %.1f s wall clock, %.0fx real time\n", seconds, minutes * 60.0 / seconds);
+
+    bool anyGrew = false;
+    for (const Bot &bot : players)
+        anyGrew = anyGrew || GetNetWorth(world, bot.player) > startWorth;
+    return anyGrew;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Balance harness: `bots` autoplayers share one World for `minutes` of game
+// time, run as fast as the machine allows. Even-numbered bots play greedy,
+// odd-numbered ones search with `iterations` playouts per decision (all
+// greedy when 0). Prints the net worth of each strategy every ten game
+// minutes, then what the bots built and what their planning cost; returns
+// false if no bot ends up richer than it started.
+bool RunAutoplayHarness(size_t bots, float minutes, size_t iterations, uint64_t seed);
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bit-granular writer and reader, least significant bit first. Besides
+// fixed-width fields they carry "sized" values: a small length field
+// giving the bit width, then that many bits, so values near zero (like
+// the difference to a baseline) take only a few bits.
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<uint8_t> &out) : m_out(out) {}
+
+    // Writes the low `bits` bits of value (bits <= 64)
+    void Write(uint64_t value, int bits)
+    {
+        if (bits > 32)
+        {
+            Write(value & 0xFFFFFFFFu, 32);
+            Write(value >> 32, bits - 32);
+            return;
+        }
+        if (bits == 0)
+            return;
+        m_bits |= (value & ((uint64_t(1) << bits) - 1)) << m_count;
+        m_count += bits;
+        while (m_count >= 8)
+        {
+            m_out.push_back(static_cast<uint8_t>(m_bits));
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    void WriteBit(bool bit) { Write(bit ? 1 : 0, 1); }
+
+    // Width in `lengthBits` bits, then the value in that width
+    void WriteSized(uint64_t value, int lengthBits)
+    {
+        int width = 0;
+        while (width < 64 && (value >> width) != 0)
+            ++width;
+        Write(static_cast<uint64_t>(width), lengthBits);
+        Write(value, width);
+    }
+
+    void WriteSignedSized(int64_t value, int lengthBits)
+    {
+        WriteSized((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63), lengthBits);
+    }
+
+    // Pads the last byte with zeros; call once everything is written
+    void Flush()
+    {
+        if (m_count > 0)
+            m_out.push_back(static_cast<uint8_t>(m_bits));
+        m_bits = 0;
+        m_count = 0;
+    }
+
+private:
+    std::vector<uint8_t> &m_out;
+    uint64_t m_bits = 0; // not yet written, fewer than 8 between calls
+    int m_count = 0;
+};
+
+// Reads what BitWriter wrote; running off the end sets the failed flag
+// and returns zeros from then on
+class BitReader
+{
+public:
+    BitReader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+    uint64_t Read(int bits)
+    {
+        if (bits > 32)
+        {
+            uint64_t low = Read(32);
+            return low | (Read(bits - 32) << 32);
+        }
+        while (m_count < bits)
+        {
+            if (m_offset == m_size)
+            {
+                m_failed = true;
+                return 0;
+            }
+            m_bits |= static_cast<uint64_t>(m_data[m_offset++]) << m_count;
+            m_count += 8;
+        }
+        uint64_t value = m_bits & ((uint64_t(1) << bits) - 1);
+        m_bits >>= bits;
+        m_count -= bits;
+        return value;
+    }
+
+    bool ReadBit() { return Read(1) != 0; }
+
+    uint64_t ReadSized(int lengthBits)
+    {
+        int width = static_cast<int>(Read(lengthBits));
+        if (width > 64)
+        {
+            m_failed = true;
+            return 0;
+        }
+        return Read(width);
+    }
+
+    int64_t ReadSignedSized(int lengthBits)
+    {
+        uint64_t value = ReadSized(lengthBits);
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    bool Failed() const { return m_failed; }
+    // Only the padding of the last byte is left
+    bool AtEnd() const { return !m_failed && m_offset == m_size && m_count < 8; }
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+    uint64_t m_bits = 0;
+    int m_count = 0;
+    bool m_failed = false;
+};
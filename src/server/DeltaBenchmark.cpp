@@ -0,0 +1,98 @@
+#include "DeltaBenchmark.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "../BuildingFactory.h"
+#include "../GameConstants.h"
+#include "../World.h"
+#include "GameServer.h"
+#include "SnapshotDelta.h"
+
+namespace
+{
+    // Baseline ages measured: none (full snapshot), one tick (acknowledged
+    // at once) and a few ticks (acknowledgements lagging ~100 ms at 60 Hz)
+    constexpr size_t LAGS[] = {0, 1, 6};
+    constexpr size_t LAG_COUNT = sizeof(LAGS) / sizeof(LAGS[0]);
+
+    struct Measurement
+    {
+        double bytes = 0.0;
+        double encodeSeconds = 0.0;
+        double decodeSeconds = 0.0;
+        size_t samples = 0;
+    };
+}
+
+bool RunDeltaBenchmark(size_t buildings, size_t ticks)
+{
+    using Clock = std::chrono::steady_clock;
+
+    World world(1);
+    Player &player = world.GetPlayer(world.AddPlayer("Benchmark"));
+    auto types = BuildingFactory::GetAvailableBuildingTypes();
+    for (size_t i = player.buildings.size(); i < buildings; ++i)
+        player.buildings.push_back(BuildingFactory::CreateBuilding(types[i % types.size()]));
+    for (auto &building : player.buildings)
+        building->SetOwned(true);
+    player.productionGraph.Invalidate();
+
+    // Every snapshot, so any baseline age can be looked up
+    std::vector<PlayerSnapshot> history(ticks + 1);
+    GameServer::Capture(player, world.GetMarket(), world.GetTick(), history[0]);
+
+    Measurement measurements[LAG_COUNT];
+    double changedBuildings = 0.0;
+    std::vector<uint8_t> bytes;
+    PlayerSnapshot rebuilt;
+    bool exact = true;
+
+    for (size_t t = 1; t <= ticks; ++t)
+    {
+        world.Update(GameConstants::SIMULATION_TICK);
+        const PlayerSnapshot &current = history[t];
+        GameServer::Capture(player, world.GetMarket(), world.GetTick(), history[t]);
+        for (size_t b = 0; b < current.buildings.size(); ++b)
+            changedBuildings += current.buildings[b] != history[t - 1].buildings[b] ? 1.0 : 0.0;
+
+        for (size_t k = 0; k < LAG_COUNT; ++k)
+        {
+            if (LAGS[k] > t)
+                continue;
+            const PlayerSnapshot *baseline = LAGS[k] == 0 ? nullptr : &history[t - LAGS[k]];
+
+            bytes.clear();
+            auto start = Clock::now();
+            BitWriter writer(bytes);
+            SnapshotDelta::Encode(baseline, current, writer);
+            writer.Flush();
+            auto encoded = Clock::now();
+            BitReader reader(bytes.data(), bytes.size());
+            bool decoded = SnapshotDelta::Decode(baseline, reader, rebuilt);
+            auto end = Clock::now();
+
+            exact = exact && decoded && reader.AtEnd() && rebuilt.SameState(current);
+            Measurement &m = measurements[k];
+            m.bytes += static_cast<double>(bytes.size());
+            m.encodeSeconds += std::chrono::duration<double>(encoded - start).count();
+            m.decodeSeconds += std::chrono::duration<double>(end - encoded).count();
+            m.samples++;
+        }
+    }
+
+    const double raw = RESOURCE_TYPE_COUNT * (sizeof(float) * 2) + sizeof(int32_t) +
+                       buildings * (3 * sizeof(uint8_t) + sizeof(float));
+    printf("%zu buildings, %zu ticks, %.1f buildings changed per tick, %.0f bytes unpacked\n",
+           player.buildings.size(), ticks, changedBuildings / ticks, raw);
+    for (size_t k = 0; k < LAG_COUNT; ++k)
+    {
+        const Measurement &m = measurements[k];
+        if (m.samples == 0)
+            continue;
+        printf("  %-22s %10.1f bytes/tick %10.2f us encode %10.2f us decode\n",
+               LAGS[k] == 0 ? "full snapshot" : (LAGS[k] == 1 ? "baseline 1 tick old" : "baseline 6 ticks old"),
+               m.bytes / m.samples, m.encodeSeconds / m.samples * 1e6, m.decodeSeconds / m.samples * 1e6);
+    }
+    printf("%s\n", exact ? "Every delta rebuilt its snapshot exactly" : "MISMATCH between rebuilt and original snapshots");
+    return exact;
+}
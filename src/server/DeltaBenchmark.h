@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+// Measures snapshot deltas for one player with `buildings` owned buildings
+// over `ticks` simulated ticks: bytes per tick and encode / decode time per
+// client, for a full snapshot and for deltas against baselines a few ticks
+// old, checking that every delta rebuilds the snapshot exactly. Prints the
+// results; returns false on a mismatch.
+bool RunDeltaBenchmark(size_t buildings, size_t ticks);
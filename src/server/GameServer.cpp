@@ -0,0 +1,464 @@
+#include "GameServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "../GameConstants.h"
+#include "../JobSystem.h"
+
+namespace
+{
+    // Poller key of the listening socket; connection k has key k + 1
+    constexpr size_t LISTENER_KEY = 0;
+
+    constexpr size_t READ_CHUNK = 16 * 1024;
+    // Unparsed input a client may pile up while the command queue is full
+    constexpr size_t MAX_INPUT = 1024 * 1024;
+    // Deltas are skipped for a client with this much still unsent, or
+    // with this many snapshots sent since the one it last acknowledged
+    constexpr size_t MAX_PENDING_OUTPUT = 256 * 1024;
+    constexpr size_t MAX_UNACKED = 60;
+    constexpr int POLL_TIMEOUT_MS = 100;
+    constexpr auto STATS_INTERVAL = std::chrono::seconds(5);
+}
+
+GameServer::GameServer(uint64_t seed, size_t bots)
+    : m_world(seed)
+{
+    AutoPlayerSettings settings;
+    for (size_t i = 0; i < bots; ++i)
+    {
+        settings.seed = seed + i;
+        m_world.AddPlayer("Bot " + std::to_string(i + 1));
+        m_bots.emplace_back(settings);
+    }
+    m_botDecisionTicks = std::max<uint64_t>(1, std::lround(settings.decisionInterval / GameConstants::SIMULATION_TICK));
+    m_playerCount = static_cast<uint32_t>(bots);
+}
+
+GameServer::~GameServer()
+{
+    Stop();
+    if (m_simulationThread.joinable())
+        m_simulationThread.join();
+    for (size_t k = 0; k < m_connections.size(); ++k)
+        if (m_connections[k])
+            Disconnect(k + 1);
+    if (m_listener != Net::INVALID)
+        Net::Close(m_listener);
+}
+
+bool GameServer::Listen(const std::string &endpoint)
+{
+    m_listener = Net::Listen(endpoint);
+    return m_listener != Net::INVALID && m_poller.Add(m_listener, LISTENER_KEY, Net::Poller::READABLE);
+}
+
+void GameServer::Stop()
+{
+    m_running.store(false, std::memory_order_release);
+    m_poller.Wake();
+}
+
+void GameServer::Run()
+{
+    using Clock = std::chrono::steady_clock;
+
+    m_running.store(true, std::memory_order_release);
+    PublishView();
+    m_simulationThread = std::thread(&GameServer::RunSimulation, this);
+
+    auto nextReport = Clock::now() + STATS_INTERVAL;
+    std::vector<Net::Poller::Event> events;
+    while (m_running.load(std::memory_order_acquire))
+    {
+        m_poller.Wait(events, POLL_TIMEOUT_MS);
+        for (const auto &event : events)
+        {
+            if (event.key == LISTENER_KEY)
+            {
+                AcceptConnections();
+                continue;
+            }
+            const size_t key = static_cast<size_t>(event.key);
+            if (!m_connections[key - 1])
+                continue;
+            if (event.events & (Net::Poller::READABLE | Net::Poller::CLOSED))
+                Receive(key);
+            if ((event.events & Net::Poller::WRITABLE) && m_connections[key - 1])
+                Flush(key);
+        }
+
+        // The simulation has drained the queue a bit since the last pass
+        std::vector<size_t> stalled;
+        stalled.swap(m_stalled);
+        for (size_t key : stalled)
+            if (m_connections[key - 1] && !ParseInput(key))
+                Disconnect(key);
+
+        const Protocol::WorldView &view = m_views.Read();
+        if (view.tick != m_lastSentTick)
+        {
+            SendDeltas(view);
+            m_lastSentTick = view.tick;
+        }
+
+        if (Clock::now() >= nextReport)
+        {
+            ReportStats();
+            nextReport += STATS_INTERVAL;
+        }
+    }
+
+    m_simulationThread.join();
+}
+
+void GameServer::RunSimulation()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(GameConstants::SIMULATION_TICK));
+
+    auto next = Clock::now();
+    while (m_running.load(std::memory_order_acquire))
+    {
+        ApplyCommands();
+        RunBots();
+        m_world.Update(GameConstants::SIMULATION_TICK);
+        PublishView();
+        m_poller.Wake();
+
+        // After a long stall, drop the backlog instead of racing through it
+        next += tick;
+        auto now = Clock::now();
+        if (now - next > tick * GameConstants::SIMULATION_MAX_CATCHUP_TICKS)
+            next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void GameServer::RunBots()
+{
+    const uint64_t tick = m_world.GetTick();
+    for (size_t i = 0; i < m_bots.size(); ++i)
+    {
+        if ((tick + i) % m_botDecisionTicks != 0)
+            continue;
+        m_botCommands.clear();
+        m_bots[i].Decide(m_world.GetPlayer(i), m_world.GetMarket(), m_botCommands);
+        for (const GameCommand &command : m_botCommands)
+            m_world.Apply(i, command);
+    }
+}
+
+void GameServer::ApplyCommands()
+{
+    QueuedCommand queued;
+    while (m_commands.TryPop(queued))
+    {
+        if (!queued.join)
+        {
+            m_world.Apply(queued.player, queued.command);
+            continue;
+        }
+        while (m_world.GetPlayerCount() <= queued.player)
+            m_world.AddPlayer("Player " + std::to_string(m_world.GetPlayerCount() + 1));
+    }
+}
+
+void GameServer::Capture(const Player &player, const MarketState &market, uint64_t tick, PlayerSnapshot &snapshot)
+{
+    snapshot.tick = tick;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        auto type = static_cast<ResourceType>(r);
+        snapshot.SetAmount(type, player.ledger.Get(type));
+        snapshot.SetPrice(type, market.GetQuotedPrice(type));
+    }
+    snapshot.reputation = player.reputation;
+
+    snapshot.buildings.resize(player.buildings.size());
+    for (size_t b = 0; b < player.buildings.size(); ++b)
+    {
+        const Building &building = *player.buildings[b];
+        PlayerSnapshot::Building &out = snapshot.buildings[b];
+        out.level = static_cast<uint8_t>(std::clamp(building.GetLevel(), 0, 255));
+        out.flags = static_cast<uint8_t>((building.IsOwned() ? PlayerSnapshot::Building::OWNED : 0) |
+                                         (building.IsOperational() ? PlayerSnapshot::Building::OPERATIONAL : 0));
+        out.priority = static_cast<uint8_t>(std::clamp(building.GetPriority(), 0, 255));
+        out.efficiency = PlayerSnapshot::QuantizeEfficiency(building.GetEfficiency());
+    }
+}
+
+void GameServer::PublishView()
+{
+    Protocol::WorldView &view = m_views.GetWriteBuffer();
+    view.tick = m_world.GetTick();
+    view.players.resize(m_world.GetPlayerCount());
+    JobSystem::GetDefault().ParallelFor(view.players.size(), GameConstants::PLAYERS_PER_JOB, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            Capture(m_world.GetPlayer(i), m_world.GetMarket(), view.tick, view.players[i]);
+    });
+    m_views.Publish();
+}
+
+void GameServer::AcceptConnections()
+{
+    for (;;)
+    {
+        Net::Socket socket = Net::Accept(m_listener);
+        if (socket == Net::INVALID)
+            return;
+
+        size_t index;
+        if (!m_freeKeys.empty())
+        {
+            index = m_freeKeys.back() - 1;
+            m_freeKeys.pop_back();
+        }
+        else
+        {
+            index = m_connections.size();
+            m_connections.emplace_back();
+        }
+
+        auto connection = std::make_unique<Connection>();
+        connection->socket = socket;
+        if (!m_poller.Add(socket, index + 1, Net::Poller::READABLE))
+        {
+            Net::Close(socket);
+            m_freeKeys.push_back(index + 1);
+            continue;
+        }
+        m_connections[index] = std::move(connection);
+        m_connectionCount++;
+    }
+}
+
+void GameServer::Receive(size_t key)
+{
+    Connection &connection = *m_connections[key - 1];
+    for (;;)
+    {
+        size_t used = connection.input.size();
+        if (used >= MAX_INPUT)
+        {
+            Disconnect(key);
+            return;
+        }
+        connection.input.resize(used + READ_CHUNK);
+        long received = Net::Receive(connection.socket, connection.input.data() + used, READ_CHUNK);
+        connection.input.resize(used + static_cast<size_t>(std::max(received, 0L)));
+        if (received < 0)
+        {
+            Disconnect(key);
+            return;
+        }
+        if (received == 0)
+            break;
+    }
+
+    // A stalled connection waits for its turn in the retry pass
+    if (!connection.stalled && !ParseInput(key))
+        Disconnect(key);
+}
+
+bool GameServer::ParseInput(size_t key)
+{
+    Connection &connection = *m_connections[key - 1];
+    connection.stalled = false;
+
+    size_t offset = 0;
+    for (;;)
+    {
+        const uint8_t *data = connection.input.data() + offset;
+        long frame = Protocol::PeekFrame(data, connection.input.size() - offset);
+        if (frame < 0)
+            return false;
+        if (frame == 0)
+            break;
+        auto type = static_cast<Protocol::MessageType>(data[sizeof(uint32_t)]);
+        if (!HandleFrame(connection, type, data + Protocol::HEADER_SIZE, static_cast<size_t>(frame) - Protocol::HEADER_SIZE))
+            return false;
+        if (connection.stalled)
+        {
+            m_stalled.push_back(key);
+            break;
+        }
+        offset += static_cast<size_t>(frame);
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+
+    return connection.output.empty() || Flush(key);
+}
+
+bool GameServer::HandleFrame(Connection &connection, Protocol::MessageType type, const uint8_t *data, size_t size)
+{
+    switch (type)
+    {
+    case Protocol::MessageType::HELLO:
+    {
+        Protocol::Reader reader(data, size);
+        uint32_t requested = reader.U32();
+        uint64_t token = reader.U64();
+        if (reader.Failed() || !reader.AtEnd() || connection.player != Protocol::NEW_PLAYER)
+            return false;
+
+        if (requested == Protocol::NEW_PLAYER)
+        {
+            QueuedCommand join;
+            join.player = m_playerCount;
+            join.join = true;
+            if (!m_commands.TryPush(std::move(join)))
+            {
+                connection.stalled = true;
+                return true;
+            }
+            connection.player = m_playerCount++;
+            m_seats.resize(m_playerCount);
+            Seat &seat = m_seats[connection.player];
+            do
+                seat.token = m_tokens();
+            while (seat.token == 0);
+            seat.taken = true;
+        }
+        else
+        {
+            // Bots have no seat to take, and a seat is taken back only by
+            // the holder of its token once its connection is gone
+            if (requested < m_bots.size() || requested >= m_seats.size())
+                return false;
+            Seat &seat = m_seats[requested];
+            if (seat.taken || seat.token != token)
+                return false;
+            seat.taken = true;
+            connection.player = requested;
+        }
+
+        // Whatever was sent before, the next delta starts from scratch
+        connection.sent.Clear();
+        connection.acked = SnapshotHistory::NONE;
+        Protocol::WriteWelcome(connection.output, connection.player, m_lastSentTick, m_seats[connection.player].token);
+        return true;
+    }
+    case Protocol::MessageType::COMMAND:
+    {
+        QueuedCommand queued;
+        if (connection.player == Protocol::NEW_PLAYER || !Protocol::ReadCommand(data, size, queued.command))
+            return false;
+        queued.player = connection.player;
+        if (!m_commands.TryPush(std::move(queued)))
+        {
+            connection.stalled = true;
+            return true;
+        }
+        m_commandsIn++;
+        return true;
+    }
+    case Protocol::MessageType::ACK:
+    {
+        Protocol::Reader reader(data, size);
+        uint64_t tick = reader.U64();
+        if (reader.Failed() || !reader.AtEnd() || connection.player == Protocol::NEW_PLAYER)
+            return false;
+
+        // Acknowledgements of snapshots already superseded are harmless
+        if (tick != SnapshotHistory::NONE && (connection.acked == SnapshotHistory::NONE || tick > connection.acked) &&
+            connection.sent.Find(tick))
+        {
+            connection.acked = tick;
+            connection.sent.DropBefore(tick);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool GameServer::Flush(size_t key)
+{
+    Connection &connection = *m_connections[key - 1];
+    while (connection.outputSent < connection.output.size())
+    {
+        long sent = Net::Send(connection.socket, connection.output.data() + connection.outputSent,
+                              connection.output.size() - connection.outputSent);
+        if (sent < 0)
+        {
+            Disconnect(key);
+            return false;
+        }
+        if (sent == 0)
+            break;
+        connection.outputSent += static_cast<size_t>(sent);
+        m_bytesOut += static_cast<uint64_t>(sent);
+    }
+
+    const bool drained = connection.outputSent == connection.output.size();
+    if (drained)
+    {
+        connection.output.clear();
+        connection.outputSent = 0;
+    }
+
+    // Only ask for write readiness while something is waiting to go out
+    if (drained == connection.waitingToWrite)
+    {
+        connection.waitingToWrite = !drained;
+        m_poller.Modify(connection.socket, key, Net::Poller::READABLE | (drained ? 0 : Net::Poller::WRITABLE));
+    }
+    return true;
+}
+
+void GameServer::SendDeltas(const Protocol::WorldView &view)
+{
+    for (size_t k = 0; k < m_connections.size(); ++k)
+    {
+        Connection *connection = m_connections[k].get();
+        if (!connection || connection->player >= view.players.size())
+            continue;
+        if (connection->output.size() - connection->outputSent > MAX_PENDING_OUTPUT ||
+            connection->sent.GetCount() >= MAX_UNACKED)
+            continue;
+
+        const PlayerSnapshot &current = view.players[connection->player];
+        const PlayerSnapshot *latest = connection->sent.GetLatest();
+        if (latest && latest->SameState(current))
+            continue;
+
+        const PlayerSnapshot *baseline = nullptr;
+        if (connection->acked != SnapshotHistory::NONE)
+            baseline = connection->sent.Find(connection->acked);
+        Protocol::WriteDelta(connection->output, baseline, current);
+        connection->sent.Push(current);
+        m_deltasOut++;
+        if (!connection->waitingToWrite)
+            Flush(k + 1);
+    }
+}
+
+void GameServer::Disconnect(size_t key)
+{
+    std::unique_ptr<Connection> &connection = m_connections[key - 1];
+    if (!connection)
+        return;
+    if (connection->player < m_seats.size())
+        m_seats[connection->player].taken = false;
+    m_poller.Remove(connection->socket);
+    Net::Close(connection->socket);
+    connection.reset();
+    m_freeKeys.push_back(key);
+    m_connectionCount--;
+}
+
+void GameServer::ReportStats()
+{
+    const double seconds = std::chrono::duration<double>(STATS_INTERVAL).count();
+    printf("tick %llu: %zu connections, %u players, %.0f deltas/s, %.1f KB/s out, %.0f commands/s\n",
+           static_cast<unsigned long long>(m_lastSentTick), m_connectionCount, m_playerCount,
+           m_deltasOut / seconds, m_bytesOut / seconds / 1024.0, m_commandsIn / seconds);
+    fflush(stdout);
+    m_bytesOut = 0;
+    m_deltasOut = 0;
+    m_commandsIn = 0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../AutoPlayer.h"
+#include "../GameCommand.h"
+#include "../SpscQueue.h"
+#include "../TripleBuffer.h"
+#include "../World.h"
+#include "NetSocket.h"
+#include "Protocol.h"
+
+// Authoritative host for a World. The simulation runs on its own thread at
+// a fixed tick and is the only writer of the world. The I/O loop runs on
+// the thread that calls Run(): it accepts connections, parses commands into
+// a queue the simulation drains at the start of every tick, and answers
+// each published WorldView with a delta per connection.
+//
+// Each delta is taken against the last snapshot the client acknowledged,
+// so it carries every change the client may not have yet. A client that
+// falls too far behind on acknowledging simply skips ticks until it
+// catches up.
+//
+// Bots are greedy autoplayers seated as the first players; they decide on
+// the simulation thread, each in its own tick of the decision interval.
+class GameServer
+{
+public:
+    explicit GameServer(uint64_t seed, size_t bots = 0);
+    ~GameServer();
+
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+
+    bool Listen(const std::string &endpoint);
+
+    // Runs until Stop(); returns once both threads are done
+    void Run();
+
+    // From any thread or a signal handler
+    void Stop();
+
+    // What a client of `player` gets to see of it
+    static void Capture(const Player &player, const MarketState &market, uint64_t tick, PlayerSnapshot &snapshot);
+
+private:
+    // Player indices are handed out by the I/O thread in order; the
+    // simulation adds the players as their joins come off the queue
+    struct QueuedCommand
+    {
+        uint32_t player = 0;
+        bool join = false;
+        GameCommand command;
+    };
+
+    // A human player's seat; the token from its WELCOME takes it back
+    // after the connection drops
+    struct Seat
+    {
+        uint64_t token = 0;
+        bool taken = false;
+    };
+
+    struct Connection
+    {
+        Net::Socket socket = Net::INVALID;
+        uint32_t player = Protocol::NEW_PLAYER; // none until HELLO
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent = 0;
+        bool waitingToWrite = false;
+        bool stalled = false;                  // unparsed input behind a full queue
+        SnapshotHistory sent;                  // from the acknowledged one on
+        uint64_t acked = SnapshotHistory::NONE;
+    };
+
+    // Simulation thread
+    void RunSimulation();
+    void RunBots();
+    void ApplyCommands();
+    void PublishView();
+
+    // I/O thread
+    void AcceptConnections();
+    void Receive(size_t key);
+    bool ParseInput(size_t key);
+    bool HandleFrame(Connection &connection, Protocol::MessageType type, const uint8_t *data, size_t size);
+    bool Flush(size_t key);
+    void SendDeltas(const Protocol::WorldView &view);
+    void Disconnect(size_t key);
+    void ReportStats();
+
+    World m_world;
+    std::vector<AutoPlayer> m_bots;      // player index = bot index
+    std::vector<GameCommand> m_botCommands;
+    uint64_t m_botDecisionTicks = 1;
+    SpscQueue<QueuedCommand, 8192> m_commands;
+    TripleBuffer<Protocol::WorldView> m_views;
+    std::thread m_simulationThread;
+    std::atomic<bool> m_running{false};
+
+    Net::Poller m_poller;
+    Net::Socket m_listener = Net::INVALID;
+    std::vector<std::unique_ptr<Connection>> m_connections; // by poller key
+    std::vector<size_t> m_freeKeys;
+    std::vector<size_t> m_stalled;
+    size_t m_connectionCount = 0;
+    uint32_t m_playerCount = 0;
+    std::vector<Seat> m_seats;           // by player index; bots' stay unused
+    std::mt19937_64 m_tokens{std::random_device{}()};
+    uint64_t m_lastSentTick = 0;
+
+    // Traffic since the last report
+    uint64_t m_bytesOut = 0;
+    uint64_t m_deltasOut = 0;
+    uint64_t m_commandsIn = 0;
+};
@@ -0,0 +1,131 @@
+#include "KernelCheck.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "../BuildingKernels.h"
+#include "../ProductionRng.h"
+
+namespace
+{
+    using BuildingKernels::InstructionSet;
+
+    constexpr size_t OFFSETS = 8;    // start 0..7 floats in, so vector loads meet every alignment
+    constexpr size_t GUARD = 16;     // floats after the end that must stay untouched
+    constexpr float SENTINEL = -12345.0f;
+
+    const char *GetName(InstructionSet set)
+    {
+        switch (set)
+        {
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX:
+            return "AVX";
+        default:
+            return "scalar";
+        }
+    }
+
+    // Inputs spanning the cases the kernels meet in play (idle, starved,
+    // decaying, over 1) plus zeros and denormals, the same on every run
+    void Fill(std::vector<float> &values, uint64_t stream, float scale)
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const uint32_t bits = ProductionRng::Generate(stream, 0, static_cast<uint32_t>(i));
+            switch (bits % 8)
+            {
+            case 0:
+                values[i] = 0.0f;
+                break;
+            case 1:
+                values[i] = std::numeric_limits<float>::denorm_min();
+                break;
+            default:
+                values[i] = static_cast<float>(bits >> 8) / static_cast<float>(1u << 24) * scale;
+                break;
+            }
+        }
+    }
+
+    bool Matches(const std::vector<float> &expected, const std::vector<float> &actual, size_t begin, size_t count,
+                 const char *kernel, InstructionSet set)
+    {
+        if (std::memcmp(expected.data() + begin, actual.data() + begin, count * sizeof(float)) != 0)
+        {
+            printf("FAIL %s %s differs from scalar at count %zu, offset %zu\n", GetName(set), kernel, count, begin);
+            return false;
+        }
+        for (size_t i = begin + count; i < begin + count + GUARD; ++i)
+        {
+            if (actual[i] != SENTINEL)
+            {
+                printf("FAIL %s %s writes past the end at count %zu, offset %zu\n", GetName(set), kernel, count, begin);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CheckCount(InstructionSet set, size_t count, size_t offset)
+    {
+        const size_t size = offset + count + GUARD;
+        std::vector<float> raw(size), starvation(size), baseRate(size), efficiency(size);
+        Fill(raw, count * 4 + 0, 1.0f);
+        Fill(starvation, count * 4 + 1, 1.0f);
+        Fill(baseRate, count * 4 + 2, 50.0f);
+        Fill(efficiency, count * 4 + 3, 1.5f);
+        const float decay = 0.05f;
+        const float deltaTime = 1.0f / 60.0f;
+
+        std::vector<float> expected(size, SENTINEL), actual(size, SENTINEL);
+
+        std::copy(efficiency.begin(), efficiency.begin() + offset + count, expected.begin());
+        std::copy(efficiency.begin(), efficiency.begin() + offset + count, actual.begin());
+        BuildingKernels::Scalar::UpdateEfficiency(expected.data() + offset, raw.data() + offset, starvation.data() + offset, decay, count);
+        BuildingKernels::UpdateEfficiency(actual.data() + offset, raw.data() + offset, starvation.data() + offset, decay, count);
+        if (!Matches(expected, actual, offset, count, "UpdateEfficiency", set))
+            return false;
+
+        std::fill(expected.begin(), expected.end(), SENTINEL);
+        std::fill(actual.begin(), actual.end(), SENTINEL);
+        BuildingKernels::Scalar::CalculateProduction(expected.data() + offset, baseRate.data() + offset, efficiency.data() + offset, deltaTime, count);
+        BuildingKernels::CalculateProduction(actual.data() + offset, baseRate.data() + offset, efficiency.data() + offset, deltaTime, count);
+        return Matches(expected, actual, offset, count, "CalculateProduction", set);
+    }
+}
+
+bool RunKernelCheck(size_t maxCount)
+{
+    const InstructionSet previous = BuildingKernels::GetInstructionSet();
+    const InstructionSet best = BuildingKernels::GetBestSupportedInstructionSet();
+    bool ok = true;
+
+    for (InstructionSet set : {InstructionSet::SCALAR, InstructionSet::SSE2, InstructionSet::AVX})
+    {
+        if (set > best)
+        {
+            printf("SKIP %s: not supported by this CPU\n", GetName(set));
+            continue;
+        }
+        BuildingKernels::SetInstructionSet(set);
+        size_t checked = 0;
+        for (size_t count = 0; ok && count <= maxCount; ++count)
+        {
+            for (size_t offset = 0; ok && offset < OFFSETS; ++offset)
+            {
+                ok = CheckCount(set, count, offset);
+                ++checked;
+            }
+        }
+        if (!ok)
+            break;
+        printf("PASS %s: %zu runs of each kernel, counts 0..%zu\n", GetName(set), checked, maxCount);
+    }
+
+    BuildingKernels::SetInstructionSet(previous);
+    return ok;
+}
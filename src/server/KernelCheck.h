@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+// Runs every BuildingKernels path the CPU supports against the scalar
+// reference for every count from 0 to `maxCount`, at aligned and unaligned
+// offsets, and checks the results are bit-identical and nothing past the
+// end is written. Prints a line per instruction set; returns false on the
+// first mismatch.
+bool RunKernelCheck(size_t maxCount);
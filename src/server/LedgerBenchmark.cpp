@@ -0,0 +1,235 @@
+#include "LedgerBenchmark.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "../BuildingFactory.h"
+#include "../GameConstants.h"
+#include "../ResourceLedger.h"
+#include "../World.h"
+
+namespace
+{
+    constexpr size_t MIN_DRIFT_TICKS = 10000000;
+    constexpr float STOCKPILE = 1.0e6f;  // past the point where float stops taking a frame's output
+    constexpr size_t WIDE_COPIES = 256;  // of each building type, for the large player
+
+    using Clock = std::chrono::steady_clock;
+
+    double Seconds(Clock::time_point since)
+    {
+        return std::chrono::duration<double>(Clock::now() - since).count();
+    }
+
+    // Late game: every building owned and fully upgraded, `copies` of each
+    // type, and every stockpile large enough that a float would no longer
+    // take a frame's output
+    void MakeLateGame(Player &player, size_t copies)
+    {
+        const size_t types = player.buildings.size();
+        for (size_t c = 1; c < copies; ++c)
+        {
+            for (size_t i = 0; i < types; ++i)
+                player.buildings.push_back(BuildingFactory::CreateBuilding(player.buildings[i]->GetType()));
+        }
+        for (auto &building : player.buildings)
+        {
+            building->SetOwned(true);
+            while (building->Upgrade())
+                ;
+        }
+        player.productionGraph.Invalidate();
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            player.ledger.Set(static_cast<ResourceType>(r), STOCKPILE);
+    }
+
+    // The ledger calls one frame of Player::UpdateBuildings makes: each
+    // stage reads every holding once for its buildings and once more for
+    // the solver, then draws each input once and deposits each output once
+    struct LedgerCall
+    {
+        enum Kind { READ, DRAW, DEPOSIT } kind;
+        ResourceType type;
+        float amount;
+    };
+
+    std::vector<LedgerCall> TraceFrame(const Player &player)
+    {
+        std::vector<LedgerCall> calls;
+        for (const auto &subgraph : player.productionGraph.GetSubgraphs())
+        {
+            for (const auto &stage : subgraph)
+            {
+                ResourceAmounts drawn{};
+                ResourceAmounts made{};
+                for (size_t index : stage)
+                {
+                    const Building &building = *player.buildings[index];
+                    const float production = building.GetBaseProductionRate() * GameConstants::SIMULATION_TICK;
+                    for (const auto &in : building.GetInputResources())
+                        drawn[static_cast<size_t>(in.GetType())] += production * in.GetProductionRate() * Building::FUEL_CONSUMPTION_FACTOR;
+                    for (const auto &out : building.GetOutputResources())
+                        made[static_cast<size_t>(out.GetType())] += production * out.GetProductionRate();
+                }
+                for (int pass = 0; pass < 2; ++pass)
+                {
+                    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                        calls.push_back({LedgerCall::READ, static_cast<ResourceType>(r), 0.0f});
+                }
+                for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+                {
+                    if (drawn[r] > 0.0f)
+                        calls.push_back({LedgerCall::DRAW, static_cast<ResourceType>(r), drawn[r]});
+                    if (made[r] > 0.0f)
+                        calls.push_back({LedgerCall::DEPOSIT, static_cast<ResourceType>(r), made[r]});
+                }
+            }
+        }
+        return calls;
+    }
+
+    // Replays a frame's calls against the ledger and against plain floats
+    double ReplayLedger(const std::vector<LedgerCall> &calls, size_t ticks, float &checksum)
+    {
+        ResourceLedger ledger;
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            ledger.Set(static_cast<ResourceType>(r), STOCKPILE);
+        const auto start = Clock::now();
+        for (size_t t = 0; t < ticks; ++t)
+        {
+            for (const auto &call : calls)
+            {
+                if (call.kind == LedgerCall::READ)
+                    checksum += ledger.Get(call.type);
+                else if (call.kind == LedgerCall::DRAW)
+                    ledger.ConsumeUpTo(call.type, call.amount);
+                else
+                    ledger.Add(call.type, call.amount);
+            }
+        }
+        return Seconds(start);
+    }
+
+    double ReplayFloats(const std::vector<LedgerCall> &calls, size_t ticks, float &checksum)
+    {
+        std::array<float, RESOURCE_TYPE_COUNT> amounts;
+        amounts.fill(STOCKPILE);
+        const auto start = Clock::now();
+        for (size_t t = 0; t < ticks; ++t)
+        {
+            for (const auto &call : calls)
+            {
+                float &amount = amounts[static_cast<size_t>(call.type)];
+                if (call.kind == LedgerCall::READ)
+                    checksum += amount;
+                else if (call.kind == LedgerCall::DRAW)
+                    amount -= std::min(amount, call.amount);
+                else
+                    amount += call.amount;
+            }
+        }
+        return Seconds(start);
+    }
+
+    // Times whole World ticks for a late-game player, then its ledger calls
+    // on their own as fixed point and as floats
+    void TimeFrame(const char *label, size_t copies, size_t ticks, float &checksum)
+    {
+        World world(1);
+        Player &player = world.GetPlayer(world.AddPlayer(label));
+        MakeLateGame(player, copies);
+        world.Update(GameConstants::SIMULATION_TICK);
+
+        const auto start = Clock::now();
+        for (size_t t = 0; t < ticks; ++t)
+            world.Update(GameConstants::SIMULATION_TICK);
+        const double frame = Seconds(start) * 1e9 / ticks;
+
+        const std::vector<LedgerCall> calls = TraceFrame(player);
+        const double fixed = ReplayLedger(calls, ticks, checksum) * 1e9 / ticks;
+        const double floats = ReplayFloats(calls, ticks, checksum) * 1e9 / ticks;
+        printf("%-6s %6zu buildings: %9.0f ns per tick; its %zu ledger calls %7.0f ns, as floats %7.0f ns (%+.1f%% of the tick)\n",
+               label, player.buildings.size(), frame, calls.size(), fixed, floats, (fixed - floats) * 100.0 / frame);
+    }
+
+    bool Expect(const char *what, FixedAmount actual, FixedAmount expected)
+    {
+        const bool exact = actual == expected;
+        printf("%s %s: %.8f, expected %.8f\n", exact ? "PASS" : "FAIL", what, actual.ToDouble(), expected.ToDouble());
+        return exact;
+    }
+}
+
+bool RunLedgerBenchmark(size_t ticks)
+{
+    float checksum = 0.0f;
+    TimeFrame("Player", 1, ticks, checksum);
+    TimeFrame("Wide", WIDE_COPIES, std::max<size_t>(1, ticks / WIDE_COPIES), checksum);
+
+    // Simulated ticks of the real building update. With every stockpile
+    // full and bonuses at their average, each tick moves every slot by the
+    // same amount, so the total after n ticks is known exactly.
+    const size_t driftTicks = std::max(ticks, MIN_DRIFT_TICKS);
+    World world(1);
+    Player &player = world.GetPlayer(world.AddPlayer("Drift"));
+    MakeLateGame(player, 1);
+    auto tick = [&player](uint64_t t)
+    {
+        player.ledger.Advance(GameConstants::SIMULATION_TICK);
+        player.UpdateBuildings(GameConstants::SIMULATION_TICK, true, 0, t);
+    };
+
+    const ResourceLedger before = player.ledger;
+    tick(0);
+    std::array<int64_t, RESOURCE_TYPE_COUNT> step;
+    std::array<float, RESOURCE_TYPE_COUNT> asFloat;
+    for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+    {
+        const auto type = static_cast<ResourceType>(r);
+        step[r] = player.ledger.GetExact(type).GetRaw() - before.GetExact(type).GetRaw();
+        asFloat[r] = player.ledger.Get(type);
+    }
+    for (uint64_t t = 1; t < driftTicks; ++t)
+    {
+        tick(t);
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            asFloat[r] += static_cast<float>(step[r] / FixedAmount::SCALE);
+    }
+
+    bool passed = true;
+    for (const auto &[type, resource] : player.resources)
+    {
+        const size_t r = static_cast<size_t>(type);
+        if (step[r] == 0)
+            continue;
+        const FixedAmount expected = FixedAmount::FromRaw(before.GetExact(type).GetRaw() + step[r] * static_cast<int64_t>(driftTicks));
+        char what[64];
+        snprintf(what, sizeof(what), "%s after %zu ticks", resource.GetName().c_str(), driftTicks);
+        passed = Expect(what, player.ledger.GetExact(type), expected) && passed;
+        printf("     (as a float: %.2f)\n", asFloat[r]);
+    }
+
+    // A steady rate is one multiply on read, so ticking the clock adds no
+    // error beyond rounding the product once
+    ResourceLedger ledger;
+    const float rate = 0.008f / GameConstants::SIMULATION_TICK;
+    ledger.Set(ResourceType::IRON, STOCKPILE);
+    ledger.SetRate(ResourceType::IRON, rate);
+    for (size_t t = 0; t < driftTicks; ++t)
+        ledger.Advance(GameConstants::SIMULATION_TICK);
+    const double elapsed = static_cast<double>(driftTicks) * GameConstants::SIMULATION_TICK;
+    const double expected = STOCKPILE + rate * elapsed;
+    const double accrued = ledger.GetExact(ResourceType::IRON).ToDouble();
+    // The clock sums a double per tick; allow its rounding and no more
+    const double tolerance = rate * elapsed * 1e-9 + 1.0 / FixedAmount::SCALE;
+    const bool steady = std::fabs(accrued - expected) <= tolerance;
+    printf("%s steady rate: %.8f, expected %.8f +- %.2g\n", steady ? "PASS" : "FAIL", accrued, expected, tolerance);
+    passed = steady && passed;
+
+    if (!std::isfinite(checksum))
+        printf("Ledger diverged\n");
+    return passed;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+
+// Times whole World ticks for a late-game player (every building owned and
+// fully upgraded, every stockpile at 1e6), once as played and once with 256
+// of each building, over `ticks` ticks. The ledger calls such a tick makes
+// are then replayed on their own, as fixed point and as plain floats, to
+// show what fixed point adds to the tick. Finally at least ten million
+// simulated ticks of Player::UpdateBuildings must move every stockpile by
+// exactly ticks times the first tick's change, and a steady rate accrued
+// tick by tick must match rate * time. Prints the results; returns false if
+// any total is off.
+bool RunLedgerBenchmark(size_t ticks);
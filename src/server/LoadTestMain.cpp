@@ -0,0 +1,389 @@
+// tycoon_loadtest: opens many connections to a tycoon_server, each playing
+// a new empire with random commands, and rebuilds every player's state from
+// the deltas it receives
+//
+//   tycoon_loadtest [--endpoint <port | unix:path>] [--connections <n>]
+//                   [--seconds <s>] [--command-rate <commands per second per connection>]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Building.h"
+#include "../Production.h"
+#include "NetSocket.h"
+#include "Protocol.h"
+
+namespace
+{
+    constexpr size_t READ_CHUNK = 16 * 1024;
+    // Connections opened between two passes over the ones already open
+    constexpr size_t CONNECT_BATCH = 256;
+    constexpr int POLL_TIMEOUT_MS = 5;
+    constexpr double REPORT_INTERVAL = 5.0;
+
+    struct Client
+    {
+        Net::Socket socket = Net::INVALID;
+        uint32_t player = Protocol::NEW_PLAYER;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent = 0;
+        bool waitingToWrite = false;
+        double nextCommand = 0.0;
+        SnapshotHistory received;
+    };
+
+    struct Totals
+    {
+        size_t open = 0;
+        size_t failedConnects = 0;
+        size_t dropped = 0;          // closed by the server or the network
+        size_t malformed = 0;
+        uint64_t deltas = 0;
+        uint64_t bytesIn = 0;
+        uint64_t commands = 0;
+    };
+
+    class LoadTest
+    {
+    public:
+        LoadTest(std::string endpoint, double commandRate)
+            : m_endpoint(std::move(endpoint)), m_commandRate(commandRate)
+        {
+        }
+
+        bool Connect(double now)
+        {
+            Client client;
+            client.socket = Net::Connect(m_endpoint);
+            if (client.socket == Net::INVALID || !Net::SetNonBlocking(client.socket))
+            {
+                if (client.socket != Net::INVALID)
+                    Net::Close(client.socket);
+                m_totals.failedConnects++;
+                return false;
+            }
+
+            const size_t key = m_clients.size();
+            if (!m_poller.Add(client.socket, key, Net::Poller::READABLE))
+            {
+                Net::Close(client.socket);
+                m_totals.failedConnects++;
+                return false;
+            }
+            std::uniform_real_distribution<double> phase(0.0, 1.0 / m_commandRate);
+            client.nextCommand = now + phase(m_rng);
+            Protocol::WriteHello(client.output, Protocol::NEW_PLAYER);
+            m_clients.push_back(std::move(client));
+            m_totals.open++;
+            Flush(key);
+            return true;
+        }
+
+        void Pump(double now, int timeoutMs)
+        {
+            m_poller.Wait(m_events, timeoutMs);
+            for (const auto &event : m_events)
+            {
+                const size_t key = static_cast<size_t>(event.key);
+                if (m_clients[key].socket == Net::INVALID)
+                    continue;
+                if (event.events & (Net::Poller::READABLE | Net::Poller::CLOSED))
+                    Receive(key);
+                if ((event.events & Net::Poller::WRITABLE) && m_clients[key].socket != Net::INVALID)
+                    Flush(key);
+            }
+
+            for (size_t key = 0; key < m_clients.size(); ++key)
+            {
+                Client &client = m_clients[key];
+                if (client.socket == Net::INVALID || client.player == Protocol::NEW_PLAYER || now < client.nextCommand)
+                    continue;
+                Protocol::WriteCommand(client.output, RandomCommand(client));
+                client.nextCommand += 1.0 / m_commandRate;
+                m_totals.commands++;
+                if (!client.waitingToWrite)
+                    Flush(key);
+            }
+        }
+
+        void CloseAll()
+        {
+            for (auto &client : m_clients)
+            {
+                if (client.socket == Net::INVALID)
+                    continue;
+                m_poller.Remove(client.socket);
+                Net::Close(client.socket);
+                client.socket = Net::INVALID;
+            }
+        }
+
+        // Players whose state has been rebuilt at least once
+        size_t CountSynced() const
+        {
+            size_t synced = 0;
+            for (const auto &client : m_clients)
+                synced += client.received.GetLatest() ? 1 : 0;
+            return synced;
+        }
+
+        double AverageMoney() const
+        {
+            double total = 0.0;
+            size_t count = 0;
+            for (const auto &client : m_clients)
+            {
+                if (const PlayerSnapshot *latest = client.received.GetLatest())
+                {
+                    total += latest->GetAmount(ResourceType::MONEY);
+                    count++;
+                }
+            }
+            return count ? total / count : 0.0;
+        }
+
+        Totals &GetTotals() { return m_totals; }
+
+    private:
+        GameCommand RandomCommand(const Client &client)
+        {
+            GameCommand command;
+            switch (std::uniform_int_distribution<int>(0, 4)(m_rng))
+            {
+            case 0:
+                command.type = CommandType::BUILD;
+                command.target = std::uniform_int_distribution<int>(0, BUILDING_TYPE_COUNT - 1)(m_rng);
+                break;
+            case 1:
+                command.type = CommandType::UPGRADE_BUILDING;
+                command.target = std::uniform_int_distribution<int>(0, BUILDING_TYPE_COUNT - 1)(m_rng);
+                break;
+            case 2:
+                command.type = CommandType::BEGIN_PRODUCTION;
+                command.target = std::uniform_int_distribution<int>(0, PRODUCTION_TYPE_COUNT - 1)(m_rng);
+                break;
+            case 3:
+            {
+                // Sell part of a stock the client knows it has
+                auto resource = static_cast<ResourceType>(std::uniform_int_distribution<int>(1, RESOURCE_TYPE_COUNT - 1)(m_rng));
+                const PlayerSnapshot *latest = client.received.GetLatest();
+                float held = latest ? latest->GetAmount(resource) : 0.0f;
+                command.type = CommandType::EXECUTE_ORDERS;
+                if (held >= 1.0f)
+                    command.orders.push_back({resource, held * 0.5f, OrderSide::SELL});
+                break;
+            }
+            default:
+                command.type = CommandType::SET_PRIORITY;
+                command.target = std::uniform_int_distribution<int>(0, BUILDING_TYPE_COUNT - 1)(m_rng);
+                command.value = static_cast<float>(std::uniform_int_distribution<int>(0, 3)(m_rng));
+                break;
+            }
+            return command;
+        }
+
+        void Drop(size_t key)
+        {
+            Client &client = m_clients[key];
+            m_poller.Remove(client.socket);
+            Net::Close(client.socket);
+            client.socket = Net::INVALID;
+            m_totals.open--;
+            m_totals.dropped++;
+        }
+
+        void Receive(size_t key)
+        {
+            Client &client = m_clients[key];
+            for (;;)
+            {
+                size_t used = client.input.size();
+                client.input.resize(used + READ_CHUNK);
+                long received = Net::Receive(client.socket, client.input.data() + used, READ_CHUNK);
+                client.input.resize(used + static_cast<size_t>(std::max(received, 0L)));
+                if (received < 0)
+                {
+                    Drop(key);
+                    return;
+                }
+                if (received == 0)
+                    break;
+                m_totals.bytesIn += static_cast<uint64_t>(received);
+            }
+
+            size_t offset = 0;
+            for (;;)
+            {
+                const uint8_t *data = client.input.data() + offset;
+                long frame = Protocol::PeekFrame(data, client.input.size() - offset);
+                if (frame == 0)
+                    break;
+                if (frame < 0 || !HandleFrame(client, data, static_cast<size_t>(frame)))
+                {
+                    m_totals.malformed++;
+                    Drop(key);
+                    return;
+                }
+                offset += static_cast<size_t>(frame);
+            }
+            client.input.erase(client.input.begin(), client.input.begin() + offset);
+            if (!client.output.empty() && !client.waitingToWrite)
+                Flush(key);
+        }
+
+        bool HandleFrame(Client &client, const uint8_t *frame, size_t size)
+        {
+            auto type = static_cast<Protocol::MessageType>(frame[sizeof(uint32_t)]);
+            const uint8_t *payload = frame + Protocol::HEADER_SIZE;
+            const size_t length = size - Protocol::HEADER_SIZE;
+            if (type == Protocol::MessageType::WELCOME)
+            {
+                Protocol::Reader reader(payload, length);
+                client.player = reader.U32();
+                reader.U64();
+                reader.U64();
+                client.received.Clear();
+                return !reader.Failed() && reader.AtEnd();
+            }
+            if (type == Protocol::MessageType::DELTA)
+            {
+                m_totals.deltas++;
+                PlayerSnapshot snapshot;
+                uint64_t baseline = SnapshotHistory::NONE;
+                if (client.player == Protocol::NEW_PLAYER ||
+                    !Protocol::ReadDelta(payload, length, client.received, snapshot, baseline))
+                    return false;
+                if (baseline != SnapshotHistory::NONE)
+                    client.received.DropBefore(baseline);
+                client.received.Push(snapshot);
+                Protocol::WriteAck(client.output, snapshot.tick);
+                return true;
+            }
+            return false;
+        }
+
+        void Flush(size_t key)
+        {
+            Client &client = m_clients[key];
+            while (client.outputSent < client.output.size())
+            {
+                long sent = Net::Send(client.socket, client.output.data() + client.outputSent,
+                                      client.output.size() - client.outputSent);
+                if (sent < 0)
+                {
+                    Drop(key);
+                    return;
+                }
+                if (sent == 0)
+                    break;
+                client.outputSent += static_cast<size_t>(sent);
+            }
+
+            const bool drained = client.outputSent == client.output.size();
+            if (drained)
+            {
+                client.output.clear();
+                client.outputSent = 0;
+            }
+            if (drained == client.waitingToWrite)
+            {
+                client.waitingToWrite = !drained;
+                m_poller.Modify(client.socket, key, Net::Poller::READABLE | (drained ? 0 : Net::Poller::WRITABLE));
+            }
+        }
+
+        std::string m_endpoint;
+        double m_commandRate;
+        std::mt19937 m_rng{12345};
+        Net::Poller m_poller;
+        std::vector<Net::Poller::Event> m_events;
+        std::vector<Client> m_clients;
+        Totals m_totals;
+    };
+
+    void Report(const char *label, LoadTest &test, const Totals &last, double seconds)
+    {
+        const Totals &now = test.GetTotals();
+        const uint64_t deltas = now.deltas - last.deltas;
+        const uint64_t bytes = now.bytesIn - last.bytesIn;
+        printf("%s: %zu open, %zu synced, %zu failed, %zu dropped, %zu malformed | "
+               "%.0f deltas/s, %.1f KB/s in, %.1f bytes/delta, %.0f commands/s, avg money %.0f\n",
+               label, now.open, test.CountSynced(), now.failedConnects, now.dropped, now.malformed,
+               deltas / seconds, bytes / seconds / 1024.0, deltas ? static_cast<double>(bytes) / deltas : 0.0,
+               (now.commands - last.commands) / seconds, test.AverageMoney());
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string endpoint = std::to_string(Protocol::DEFAULT_PORT);
+    size_t connections = 10000;
+    double seconds = 30.0;
+    double commandRate = 0.5;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--endpoint") == 0)
+            endpoint = argv[i + 1];
+        else if (std::strcmp(argv[i], "--connections") == 0)
+            connections = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seconds") == 0)
+            seconds = std::strtod(argv[i + 1], nullptr);
+        else if (std::strcmp(argv[i], "--command-rate") == 0)
+            commandRate = std::strtod(argv[i + 1], nullptr);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (commandRate <= 0.0)
+        commandRate = 1e-9;
+
+    if (!Net::Startup())
+    {
+        fprintf(stderr, "Error starting sockets\n");
+        return 1;
+    }
+    Net::RaiseDescriptorLimit(connections + 64);
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    LoadTest test(endpoint, commandRate);
+    for (size_t i = 0; i < connections; ++i)
+    {
+        test.Connect(elapsed());
+        if ((i + 1) % CONNECT_BATCH == 0)
+            test.Pump(elapsed(), 0);
+    }
+    printf("Connected %zu of %zu in %.2f s\n", test.GetTotals().open, connections, elapsed());
+
+    // Measured from here on, with every connection open
+    const double measureStart = elapsed();
+    Totals first = test.GetTotals();
+    Totals last = first;
+    double nextReport = measureStart + REPORT_INTERVAL;
+    while (elapsed() < measureStart + seconds)
+    {
+        test.Pump(elapsed(), POLL_TIMEOUT_MS);
+        if (elapsed() >= nextReport)
+        {
+            Report("interval", test, last, REPORT_INTERVAL);
+            last = test.GetTotals();
+            nextReport += REPORT_INTERVAL;
+        }
+    }
+    Report("total", test, first, elapsed() - measureStart);
+
+    const Totals &totals = test.GetTotals();
+    const bool healthy = totals.malformed == 0 && totals.dropped == 0 && totals.failedConnects == 0;
+    test.CloseAll();
+    Net::Shutdown();
+    return healthy ? 0 : 1;
+}
@@ -0,0 +1,294 @@
+#include "MarketModelBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include "../MarketModel.h"
+
+namespace
+{
+    constexpr const char *MODEL_NAMES[] = {"random_walk", "mean_reverting", "supply_demand"};
+    constexpr const char *RESOURCE_NAMES[] = {"money", "wood", "stone", "iron", "gold", "crystal", "energy", "diamond"};
+    static_assert(sizeof(RESOURCE_NAMES) / sizeof(RESOURCE_NAMES[0]) == RESOURCE_TYPE_COUNT, "a name per resource type");
+
+    constexpr size_t MIN_SAMPLES = 1000000;
+    constexpr size_t BURN_IN = 1000;       // ticks before a stationary series is sampled
+    constexpr size_t REVERSION_PATHS = 4000;
+    constexpr double REVERSION_START = 0.5; // log-price offset the paths start from
+    constexpr size_t REVERSION_TICKS[] = {10, 35, 100};
+    constexpr double MAX_SIGMAS = 5.0;
+    constexpr uint64_t SEED = 1;
+
+    // Running mean and variance plus the lag-1 autocovariance, in double
+    struct Moments
+    {
+        size_t count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double sum = 0.0;
+        double sumLagged = 0.0;
+        double first = 0.0;
+        double previous = 0.0;
+
+        void Add(double x)
+        {
+            if (count > 0)
+                sumLagged += x * previous;
+            else
+                first = x;
+            previous = x;
+            ++count;
+            const double delta = x - mean;
+            mean += delta / static_cast<double>(count);
+            m2 += delta * (x - mean);
+            sum += x;
+        }
+
+        double GetVariance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+
+        // Correlation of each sample with the one before it
+        double GetAutocorrelation() const
+        {
+            const double n = static_cast<double>(count);
+            const double covariance = sumLagged - mean * ((sum - first) + (sum - previous)) + (n - 1.0) * mean * mean;
+            return covariance / (n - 1.0) / GetVariance();
+        }
+    };
+
+    // Samples of an AR(1) series with lag-1 correlation rho carry about
+    // n (1 - rho) / (1 + rho) samples' worth of information about the mean
+    // and n (1 - rho^2) / (1 + rho^2) about the variance
+    double MeanError(double variance, size_t count, double rho)
+    {
+        return std::sqrt(variance / (static_cast<double>(count) * (1.0 - rho) / (1.0 + rho)));
+    }
+
+    double VarianceError(double variance, size_t count, double rho)
+    {
+        return variance * std::sqrt(2.0 / (static_cast<double>(count) * (1.0 - rho * rho) / (1.0 + rho * rho)));
+    }
+
+    // Bounds out of the way, so the statistics see the model, not the clamp
+    MarketState CreateUnclamped()
+    {
+        MarketState state = MarketState::CreateDefault();
+        for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            state.minPrice[r] = std::numeric_limits<float>::min();
+            state.maxPrice[r] = std::numeric_limits<float>::max();
+        }
+        return state;
+    }
+
+    class Checker
+    {
+    public:
+        explicit Checker(MarketModelType model) : m_model(MODEL_NAMES[static_cast<size_t>(model)]) {}
+
+        void Expect(size_t lane, const char *what, double actual, double expected, double error)
+        {
+            const double sigmas = error > 0.0 ? std::fabs(actual - expected) / error : 0.0;
+            m_worst = std::max(m_worst, sigmas);
+            ++m_checks;
+            if (sigmas > MAX_SIGMAS || !std::isfinite(actual))
+            {
+                printf("FAIL %s %s %s: %.6g, expected %.6g +- %.3g (%.1f sigma)\n",
+                       m_model, RESOURCE_NAMES[lane], what, actual, expected, error, sigmas);
+                m_passed = false;
+            }
+        }
+
+        bool Report() const
+        {
+            printf("%s %s: %zu checks, worst %.2f sigma\n", m_passed ? "PASS" : "FAIL", m_model, m_checks, m_worst);
+            return m_passed;
+        }
+
+    private:
+        const char *m_model;
+        size_t m_checks = 0;
+        double m_worst = 0.0;
+        bool m_passed = true;
+    };
+
+    double TimeUpdates(const MarketModel &model, size_t ticks, float &checksum)
+    {
+        using Clock = std::chrono::steady_clock;
+        MarketState state = MarketState::CreateDefault();
+        const auto start = Clock::now();
+        for (size_t t = 0; t < ticks; ++t)
+            model.Update(state, SEED, t);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (float price : state.price)
+            checksum += price;
+        return seconds;
+    }
+
+    // Relative steps from the same price each tick are independent draws of
+    // a uniform on +-volatility: mean 0, variance v^2 / 3
+    bool CheckRandomWalk(const MarketModel &model, size_t samples)
+    {
+        Checker checker(model.GetType());
+        std::vector<Moments> steps(RESOURCE_TYPE_COUNT);
+        MarketState state = CreateUnclamped();
+        for (size_t t = 0; t < samples; ++t)
+        {
+            state.price = state.referencePrice;
+            model.Update(state, SEED, t);
+            for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+                steps[r].Add(static_cast<double>(state.price[r]) / state.referencePrice[r] - 1.0);
+        }
+
+        for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            const double variance = static_cast<double>(state.volatility[r]) * state.volatility[r] / 3.0;
+            checker.Expect(r, "step mean", steps[r].mean, 0.0, MeanError(variance, samples, 0.0));
+            checker.Expect(r, "step variance", steps[r].GetVariance(), variance, VarianceError(variance, samples, 0.0));
+        }
+        return checker.Report();
+    }
+
+    // The log price is AR(1) around log(reference) with coefficient
+    // exp(-theta) and stationary variance (v^2 / 3) / (2 theta)
+    bool CheckOrnsteinUhlenbeck(const MarketModel &model, size_t samples)
+    {
+        Checker checker(model.GetType());
+        const double theta = OrnsteinUhlenbeckMarketModel::REVERSION_RATE;
+        const double decay = std::exp(-theta);
+
+        std::vector<Moments> logs(RESOURCE_TYPE_COUNT);
+        MarketState state = CreateUnclamped();
+        for (size_t t = 0; t < BURN_IN + samples; ++t)
+        {
+            model.Update(state, SEED, t);
+            if (t < BURN_IN)
+                continue;
+            for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+                logs[r].Add(std::log(static_cast<double>(state.price[r]) / state.referencePrice[r]));
+        }
+
+        for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            const Moments &m = logs[r];
+            const double variance = static_cast<double>(state.volatility[r]) * state.volatility[r] / 3.0 / (2.0 * theta);
+            checker.Expect(r, "log mean", m.mean, 0.0, MeanError(variance, samples, decay));
+            checker.Expect(r, "log variance", m.GetVariance(), variance, VarianceError(variance, samples, decay));
+
+            // Lag-1 autocorrelation is the per-tick reversion factor
+            checker.Expect(r, "reversion per tick", m.GetAutocorrelation(), decay,
+                           std::sqrt((1.0 - decay * decay) / static_cast<double>(m.count)));
+        }
+
+        // Paths started away from the reference close the gap as exp(-theta t)
+        std::vector<std::vector<double>> offsets(std::size(REVERSION_TICKS), std::vector<double>(RESOURCE_TYPE_COUNT, 0.0));
+        for (size_t path = 0; path < REVERSION_PATHS; ++path)
+        {
+            MarketState displaced = CreateUnclamped();
+            for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+                displaced.price[r] = static_cast<float>(displaced.referencePrice[r] * std::exp(REVERSION_START));
+            size_t next = 0;
+            for (size_t t = 1; next < std::size(REVERSION_TICKS); ++t)
+            {
+                model.Update(displaced, SEED + 1 + path, t);
+                if (t != REVERSION_TICKS[next])
+                    continue;
+                for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+                    offsets[next][r] += std::log(static_cast<double>(displaced.price[r]) / displaced.referencePrice[r]);
+                ++next;
+            }
+        }
+
+        for (size_t k = 0; k < std::size(REVERSION_TICKS); ++k)
+        {
+            const double ticks = static_cast<double>(REVERSION_TICKS[k]);
+            for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+            {
+                const double stationary = static_cast<double>(state.volatility[r]) * state.volatility[r] / 3.0 / (2.0 * theta);
+                const double spread = stationary * (1.0 - std::exp(-2.0 * theta * ticks));
+                char what[64];
+                std::snprintf(what, sizeof(what), "offset after %zu ticks", REVERSION_TICKS[k]);
+                checker.Expect(r, what, offsets[k][r] / REVERSION_PATHS, REVERSION_START * std::pow(decay, ticks),
+                               std::sqrt(spread / REVERSION_PATHS));
+            }
+        }
+        return checker.Report();
+    }
+
+    // At rest the price is p' = (p + (ref - p) a)(1 + n) with n uniform on
+    // +-s: mean ref, and with y = p - ref, Var y = ref^2 q / (1 - b^2 - b^2 q)
+    // where b = 1 - a and q = s^2 / 3. Held order flow moves the mean to
+    // ref ((depth + demand) / (depth + supply))^elasticity.
+    bool CheckSupplyDemand(const MarketModel &model, size_t samples)
+    {
+        using Model = SupplyDemandMarketModel;
+        Checker checker(model.GetType());
+        const double b = 1.0 - Model::ADJUSTMENT_RATE;
+
+        // Demand worth three times the market depth doubles the equilibrium
+        constexpr double DEMAND_DEPTHS = 3.0;
+        for (bool flow : {false, true})
+        {
+            std::vector<Moments> prices(RESOURCE_TYPE_COUNT);
+            MarketState state = CreateUnclamped();
+            for (size_t t = 0; t < BURN_IN + samples; ++t)
+            {
+                if (flow)
+                {
+                    for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+                        state.demand[r] = static_cast<float>(DEMAND_DEPTHS * Model::MARKET_DEPTH / state.referencePrice[r]);
+                }
+                model.Update(state, SEED, t);
+                if (t < BURN_IN)
+                    continue;
+                for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+                    prices[r].Add(state.price[r] / state.referencePrice[r]);
+            }
+
+            const double level = flow ? std::pow(1.0 + DEMAND_DEPTHS, static_cast<double>(Model::ELASTICITY)) : 1.0;
+            for (size_t r = 1; r < RESOURCE_TYPE_COUNT; ++r)
+            {
+                const double s = static_cast<double>(state.volatility[r]) * Model::NOISE_SCALE;
+                const double q = s * s / 3.0;
+                const double variance = level * level * q / (1.0 - b * b - b * b * q);
+                checker.Expect(r, flow ? "mean under demand" : "mean at rest", prices[r].mean, level, MeanError(variance, samples, b));
+                checker.Expect(r, flow ? "variance under demand" : "variance at rest", prices[r].GetVariance(), variance,
+                               VarianceError(variance, samples, b));
+            }
+        }
+        return checker.Report();
+    }
+}
+
+bool RunMarketModelBenchmark(size_t ticks)
+{
+    const size_t samples = std::max(ticks, MIN_SAMPLES);
+    bool passed = true;
+    float checksum = 0.0f;
+    for (MarketModelType type : {MarketModelType::RANDOM_WALK, MarketModelType::MEAN_REVERTING, MarketModelType::SUPPLY_DEMAND})
+    {
+        auto model = MarketModel::Create(type);
+        const double seconds = TimeUpdates(*model, ticks, checksum);
+        printf("%s: %.1f ns per Update (%.2f ns per resource) over %zu ticks\n", MODEL_NAMES[static_cast<size_t>(type)],
+               seconds * 1e9 / static_cast<double>(ticks), seconds * 1e9 / static_cast<double>(ticks * RESOURCE_TYPE_COUNT), ticks);
+
+        switch (type)
+        {
+        case MarketModelType::RANDOM_WALK:
+            passed = CheckRandomWalk(*model, samples) && passed;
+            break;
+        case MarketModelType::MEAN_REVERTING:
+            passed = CheckOrnsteinUhlenbeck(*model, samples) && passed;
+            break;
+        case MarketModelType::SUPPLY_DEMAND:
+            passed = CheckSupplyDemand(*model, samples) && passed;
+            break;
+        }
+    }
+    // Keeps the timed loops from being optimised away
+    if (!std::isfinite(checksum))
+        printf("Prices diverged\n");
+    return passed;
+}
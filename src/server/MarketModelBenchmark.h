@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+// Times MarketModel::Update for each model over `ticks` ticks, then checks
+// each model's price statistics against its parameters: the random walk's
+// step mean and variance, the Ornstein-Uhlenbeck stationary mean, variance
+// and reversion towards the reference price, and the supply/demand model's
+// mean and variance at rest and its equilibrium under steady order flow.
+// Statistics use at least a million draws per lane and must fall within
+// five standard errors. Prints the results; returns false if any is out.
+bool RunMarketModelBenchmark(size_t ticks);
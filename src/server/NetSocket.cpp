@@ -0,0 +1,477 @@
+#include "NetSocket.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char UNIX_PREFIX[] = "unix:";
+
+    bool IsUnixEndpoint(const std::string &endpoint)
+    {
+        return endpoint.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX) == 0;
+    }
+
+    bool LocalAddress(const std::string &endpoint, sockaddr_in &address)
+    {
+        char *end = nullptr;
+        unsigned long port = std::strtoul(endpoint.c_str(), &end, 10);
+        if (endpoint.empty() || *end != '\0' || port == 0 || port > 65535)
+            return false;
+        address = sockaddr_in{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return true;
+    }
+
+    // Small frames go out as soon as they are written
+    void DisableNagle(Net::Socket socket)
+    {
+        int on = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&on), sizeof(on));
+    }
+}
+
+#if defined(_WIN32)
+
+namespace Net
+{
+    const Socket INVALID = static_cast<Socket>(INVALID_SOCKET);
+
+    bool Startup()
+    {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+
+    void Shutdown()
+    {
+        WSACleanup();
+    }
+
+    void RaiseDescriptorLimit(size_t)
+    {
+    }
+
+    Socket Listen(const std::string &endpoint)
+    {
+        sockaddr_in address;
+        if (IsUnixEndpoint(endpoint) || !LocalAddress(endpoint, address))
+            return INVALID;
+
+        SOCKET listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listener == INVALID_SOCKET)
+            return INVALID;
+        if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listener, SOMAXCONN) != 0 || !SetNonBlocking(listener))
+        {
+            closesocket(listener);
+            return INVALID;
+        }
+        return listener;
+    }
+
+    Socket Connect(const std::string &endpoint)
+    {
+        sockaddr_in address;
+        if (IsUnixEndpoint(endpoint) || !LocalAddress(endpoint, address))
+            return INVALID;
+
+        SOCKET connection = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (connection == INVALID_SOCKET)
+            return INVALID;
+        if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+        {
+            closesocket(connection);
+            return INVALID;
+        }
+        DisableNagle(connection);
+        return connection;
+    }
+
+    Socket Accept(Socket listener)
+    {
+        SOCKET connection = accept(listener, nullptr, nullptr);
+        if (connection == INVALID_SOCKET)
+            return INVALID;
+        if (!SetNonBlocking(connection))
+        {
+            closesocket(connection);
+            return INVALID;
+        }
+        DisableNagle(connection);
+        return connection;
+    }
+
+    void Close(Socket socket)
+    {
+        closesocket(socket);
+    }
+
+    bool SetNonBlocking(Socket socket)
+    {
+        u_long on = 1;
+        return ioctlsocket(socket, FIONBIO, &on) == 0;
+    }
+
+    long Send(Socket socket, const uint8_t *data, size_t size)
+    {
+        int sent = send(socket, reinterpret_cast<const char *>(data), static_cast<int>(std::min<size_t>(size, INT_MAX)), 0);
+        if (sent >= 0)
+            return sent;
+        return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+    }
+
+    long Receive(Socket socket, uint8_t *data, size_t size)
+    {
+        int received = recv(socket, reinterpret_cast<char *>(data), static_cast<int>(std::min<size_t>(size, INT_MAX)), 0);
+        if (received > 0)
+            return received;
+        if (received == 0)
+            return -1;
+        return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+    }
+
+    Poller::Poller() = default;
+    Poller::~Poller() = default;
+
+    bool Poller::Add(Socket socket, uint64_t key, uint32_t interest)
+    {
+        m_entries.push_back({socket, key, interest});
+        return true;
+    }
+
+    bool Poller::Modify(Socket socket, uint64_t key, uint32_t interest)
+    {
+        for (auto &entry : m_entries)
+        {
+            if (entry.socket == socket)
+            {
+                entry.key = key;
+                entry.interest = interest;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Poller::Remove(Socket socket)
+    {
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                       [&](const Entry &entry) { return entry.socket == socket; }),
+                        m_entries.end());
+    }
+
+    void Poller::Wait(std::vector<Event> &events, int timeoutMs)
+    {
+        constexpr int SLICE_MS = 1;
+
+        events.clear();
+        m_scratch.resize(m_entries.size() * sizeof(WSAPOLLFD));
+        WSAPOLLFD *fds = reinterpret_cast<WSAPOLLFD *>(m_scratch.data());
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            fds[i].fd = m_entries[i].socket;
+            fds[i].events = static_cast<SHORT>(((m_entries[i].interest & READABLE) ? POLLRDNORM : 0) |
+                                               ((m_entries[i].interest & WRITABLE) ? POLLWRNORM : 0));
+            fds[i].revents = 0;
+        }
+
+        for (int waited = 0; waited < timeoutMs || timeoutMs < 0; waited += SLICE_MS)
+        {
+            if (m_woken.exchange(false))
+                return;
+            if (m_entries.empty())
+            {
+                Sleep(SLICE_MS);
+                continue;
+            }
+            int ready = WSAPoll(fds, static_cast<ULONG>(m_entries.size()), SLICE_MS);
+            if (ready <= 0)
+                continue;
+
+            for (size_t i = 0; i < m_entries.size(); ++i)
+            {
+                uint32_t what = 0;
+                if (fds[i].revents & POLLRDNORM)
+                    what |= READABLE;
+                if (fds[i].revents & POLLWRNORM)
+                    what |= WRITABLE;
+                if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+                    what |= CLOSED;
+                if (what)
+                    events.push_back({m_entries[i].key, what});
+            }
+            return;
+        }
+    }
+
+    void Poller::Wake()
+    {
+        m_woken.store(true);
+    }
+}
+
+#else
+
+namespace Net
+{
+    const Socket INVALID = -1;
+
+    bool Startup()
+    {
+        return true;
+    }
+
+    void Shutdown()
+    {
+    }
+
+    void RaiseDescriptorLimit(size_t count)
+    {
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur >= count)
+            return;
+        limit.rlim_cur = std::min<rlim_t>(count, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    Socket Listen(const std::string &endpoint)
+    {
+        Socket listener = -1;
+        if (IsUnixEndpoint(endpoint))
+        {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::string path = endpoint.substr(sizeof(UNIX_PREFIX) - 1);
+            if (path.empty() || path.size() >= sizeof(address.sun_path))
+                return INVALID;
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+            // A socket file left over from an earlier run would block bind()
+            unlink(path.c_str());
+            listener = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listener < 0)
+                return INVALID;
+            if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            {
+                close(listener);
+                return INVALID;
+            }
+        }
+        else
+        {
+            sockaddr_in address;
+            if (!LocalAddress(endpoint, address))
+                return INVALID;
+            listener = socket(AF_INET, SOCK_STREAM, 0);
+            if (listener < 0)
+                return INVALID;
+            int on = 1;
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            {
+                close(listener);
+                return INVALID;
+            }
+        }
+
+        if (listen(listener, SOMAXCONN) != 0 || !SetNonBlocking(listener))
+        {
+            close(listener);
+            return INVALID;
+        }
+        return listener;
+    }
+
+    Socket Connect(const std::string &endpoint)
+    {
+        Socket connection = -1;
+        if (IsUnixEndpoint(endpoint))
+        {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::string path = endpoint.substr(sizeof(UNIX_PREFIX) - 1);
+            if (path.empty() || path.size() >= sizeof(address.sun_path))
+                return INVALID;
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+            connection = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (connection < 0)
+                return INVALID;
+            if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            {
+                close(connection);
+                return INVALID;
+            }
+        }
+        else
+        {
+            sockaddr_in address;
+            if (!LocalAddress(endpoint, address))
+                return INVALID;
+            connection = socket(AF_INET, SOCK_STREAM, 0);
+            if (connection < 0)
+                return INVALID;
+            if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            {
+                close(connection);
+                return INVALID;
+            }
+            DisableNagle(connection);
+        }
+        return connection;
+    }
+
+    Socket Accept(Socket listener)
+    {
+        Socket connection = accept(listener, nullptr, nullptr);
+        if (connection < 0)
+            return INVALID;
+        if (!SetNonBlocking(connection))
+        {
+            close(connection);
+            return INVALID;
+        }
+        DisableNagle(connection); // fails harmlessly on Unix domain sockets
+        return connection;
+    }
+
+    void Close(Socket socket)
+    {
+        close(socket);
+    }
+
+    bool SetNonBlocking(Socket socket)
+    {
+        int flags = fcntl(socket, F_GETFL, 0);
+        return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    long Send(Socket socket, const uint8_t *data, size_t size)
+    {
+        ssize_t sent = send(socket, data, size, MSG_NOSIGNAL);
+        if (sent >= 0)
+            return static_cast<long>(sent);
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+
+    long Receive(Socket socket, uint8_t *data, size_t size)
+    {
+        ssize_t received = recv(socket, data, size, 0);
+        if (received > 0)
+            return static_cast<long>(received);
+        if (received == 0)
+            return -1;
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+
+    namespace
+    {
+        // The wake eventfd is registered under a key no socket gets
+        constexpr uint64_t WAKE_KEY = ~uint64_t(0);
+
+        uint32_t ToEpoll(uint32_t interest)
+        {
+            return ((interest & Poller::READABLE) ? EPOLLIN : 0u) |
+                   ((interest & Poller::WRITABLE) ? EPOLLOUT : 0u) | EPOLLRDHUP;
+        }
+    }
+
+    Poller::Poller()
+    {
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = WAKE_KEY;
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event);
+    }
+
+    Poller::~Poller()
+    {
+        close(m_wake);
+        close(m_epoll);
+    }
+
+    bool Poller::Add(Socket socket, uint64_t key, uint32_t interest)
+    {
+        epoll_event event{};
+        event.events = ToEpoll(interest);
+        event.data.u64 = key;
+        return epoll_ctl(m_epoll, EPOLL_CTL_ADD, socket, &event) == 0;
+    }
+
+    bool Poller::Modify(Socket socket, uint64_t key, uint32_t interest)
+    {
+        epoll_event event{};
+        event.events = ToEpoll(interest);
+        event.data.u64 = key;
+        return epoll_ctl(m_epoll, EPOLL_CTL_MOD, socket, &event) == 0;
+    }
+
+    void Poller::Remove(Socket socket)
+    {
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, socket, nullptr);
+    }
+
+    void Poller::Wait(std::vector<Event> &events, int timeoutMs)
+    {
+        constexpr size_t MAX_EVENTS = 1024;
+
+        events.clear();
+        m_scratch.resize(MAX_EVENTS * sizeof(epoll_event));
+        epoll_event *ready = reinterpret_cast<epoll_event *>(m_scratch.data());
+        int count = epoll_wait(m_epoll, ready, static_cast<int>(MAX_EVENTS), timeoutMs);
+        for (int i = 0; i < count; ++i)
+        {
+            if (ready[i].data.u64 == WAKE_KEY)
+            {
+                uint64_t wakes = 0;
+                ssize_t drained = read(m_wake, &wakes, sizeof(wakes));
+                (void)drained;
+                continue;
+            }
+            uint32_t what = 0;
+            if (ready[i].events & EPOLLIN)
+                what |= READABLE;
+            if (ready[i].events & EPOLLOUT)
+                what |= WRITABLE;
+            if (ready[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+                what |= CLOSED;
+            events.push_back({ready[i].data.u64, what});
+        }
+    }
+
+    void Poller::Wake()
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wake, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Thin layer over the platform's sockets: Winsock with WSAPoll on Windows,
+// BSD sockets with epoll elsewhere (Linux). All sockets handed out are
+// non-blocking except the ones Connect() returns before SetNonBlocking().
+namespace Net
+{
+#if defined(_WIN32)
+    using Socket = uintptr_t;
+#else
+    using Socket = int;
+#endif
+    extern const Socket INVALID;
+
+    // Winsock setup and teardown; no-ops elsewhere
+    bool Startup();
+    void Shutdown();
+
+    // Lifts the per-process descriptor limit to at least `count` where the
+    // platform has one, so thousands of connections fit
+    void RaiseDescriptorLimit(size_t count);
+
+    // Endpoints are "unix:<path>" for a Unix domain socket (not on Windows)
+    // or a TCP port on 127.0.0.1, e.g. "27960"
+    Socket Listen(const std::string &endpoint);
+    Socket Connect(const std::string &endpoint);
+    // INVALID when nobody is waiting
+    Socket Accept(Socket listener);
+    void Close(Socket socket);
+    bool SetNonBlocking(Socket socket);
+
+    // Bytes moved, 0 when the call would block, -1 when the peer is gone
+    long Send(Socket socket, const uint8_t *data, size_t size);
+    long Receive(Socket socket, uint8_t *data, size_t size);
+
+    // Readiness notification for many sockets, level-triggered
+    class Poller
+    {
+    public:
+        static constexpr uint32_t READABLE = 1;
+        static constexpr uint32_t WRITABLE = 2;
+        static constexpr uint32_t CLOSED = 4;
+
+        struct Event
+        {
+            uint64_t key;
+            uint32_t events;
+        };
+
+        Poller();
+        ~Poller();
+
+        Poller(const Poller &) = delete;
+        Poller &operator=(const Poller &) = delete;
+
+        bool Add(Socket socket, uint64_t key, uint32_t interest);
+        bool Modify(Socket socket, uint64_t key, uint32_t interest);
+        void Remove(Socket socket);
+
+        // Waits until a socket is ready, Wake() is called or the timeout
+        // passes; replaces `events` with what is ready
+        void Wait(std::vector<Event> &events, int timeoutMs);
+
+        // Ends a Wait() in progress on another thread; safe to call from
+        // a signal handler
+        void Wake();
+
+    private:
+#if defined(_WIN32)
+        struct Entry
+        {
+            Socket socket;
+            uint64_t key;
+            uint32_t interest;
+        };
+        std::vector<Entry> m_entries;
+        std::vector<uint8_t> m_scratch; // WSAPOLLFD array
+        // WSAPoll can't be interrupted, so Wait() polls in short slices
+        // and checks this in between
+        std::atomic<bool> m_woken{false};
+#else
+        int m_epoll = -1;
+        int m_wake = -1; // eventfd
+        std::vector<uint8_t> m_scratch; // epoll_event array
+#endif
+    };
+}
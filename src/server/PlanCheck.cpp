@@ -0,0 +1,96 @@
+#include "PlanCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "../AutoPlayer.h"
+#include "../GameConstants.h"
+#include "../GameState.h"
+#include "../World.h"
+
+namespace
+{
+    constexpr float CHECK_INTERVAL = 300.0f; // game seconds between forks
+    // A plan may be this far off the World, as a fraction of its net worth
+    // and of its money
+    constexpr float TOLERANCE = 0.01f;
+    // Below this a miss is measured against the floor instead
+    constexpr float TOLERANCE_FLOOR = 1000.0f;
+
+    float Miss(float predicted, float actual)
+    {
+        return (predicted - actual) / std::max(std::fabs(actual), TOLERANCE_FLOOR);
+    }
+
+    bool Within(float predicted, float actual)
+    {
+        return std::fabs(Miss(predicted, actual)) <= TOLERANCE;
+    }
+}
+
+bool RunPlanCheck(float minutes, uint64_t seed)
+{
+    World world(seed);
+    world.SetExpectedValue(true); // the plan rolls every bonus at its average
+    const size_t player = world.AddPlayer("Bot");
+    AutoPlayer bot;
+    PlanModel model;
+
+    const float horizon = bot.GetSettings().horizon;
+    const uint64_t decisionTicks = std::max<uint64_t>(1, std::lround(bot.GetSettings().decisionInterval / GameConstants::SIMULATION_TICK));
+    const uint64_t checkTicks = std::max<uint64_t>(1, std::lround(CHECK_INTERVAL / GameConstants::SIMULATION_TICK));
+    const uint64_t horizonTicks = static_cast<uint64_t>(std::lround(horizon / GameConstants::SIMULATION_TICK));
+    const uint64_t ticks = static_cast<uint64_t>(std::lround(minutes * 60.0f / GameConstants::SIMULATION_TICK));
+
+    printf("PlanModel against World, %.0f game minutes, %.0f s ahead every %.0f s\n", minutes, horizon, CHECK_INTERVAL);
+    printf("  %8s %14s %14s %8s %14s %14s %8s\n", "minute", "plan worth", "world worth", "miss", "plan money", "world money", "miss");
+
+    auto state = std::make_unique<GameState>();
+    std::vector<GameCommand> commands;
+    bool passed = true;
+    size_t checks = 0;
+    for (uint64_t tick = 0; tick < ticks; ++tick)
+    {
+        // Fork before the bot acts, once the last decision's trades are filled
+        if (tick % checkTicks == 0 && world.SaveState(player, *state))
+        {
+            PlanState plan = model.Observe(world.GetPlayer(player), world.GetMarket());
+            model.Advance(plan, horizon);
+
+            World fork(seed);
+            fork.AddPlayer("Fork");
+            fork.LoadState(0, *state);
+            for (uint64_t t = 0; t < horizonTicks; ++t)
+                fork.Update(GameConstants::SIMULATION_TICK);
+            const PlanState actual = model.Observe(fork.GetPlayer(0), fork.GetMarket());
+            // The plan holds prices on purpose; value both at where the
+            // World's market ended so only the game rules are compared
+            plan.market = actual.market;
+
+            const float planWorth = model.GetNetWorth(plan);
+            const float worldWorth = model.GetNetWorth(actual);
+            const float planMoney = plan.amounts[static_cast<size_t>(ResourceType::MONEY)];
+            const float worldMoney = actual.amounts[static_cast<size_t>(ResourceType::MONEY)];
+            const bool ok = Within(planWorth, worldWorth) && Within(planMoney, worldMoney);
+            printf("  %8.0f %14.0f %14.0f %7.1f%% %14.0f %14.0f %7.1f%%%s\n", world.GetTime() / 60.0f,
+                   planWorth, worldWorth, 100.0f * Miss(planWorth, worldWorth),
+                   planMoney, worldMoney, 100.0f * Miss(planMoney, worldMoney),
+                   ok ? "" : "  FAIL");
+            passed = ok && passed;
+            checks++;
+        }
+
+        if (tick % decisionTicks == 0)
+        {
+            commands.clear();
+            bot.Decide(world.GetPlayer(player), world.GetMarket(), commands);
+            for (const GameCommand &command : commands)
+                world.Apply(player, command);
+        }
+        world.Update(GameConstants::SIMULATION_TICK);
+    }
+
+    printf("%s: %zu forks, net worth and money within %.0f%%\n", passed ? "PASS" : "FAIL", checks, TOLERANCE * 100.0f);
+    return passed;
+}
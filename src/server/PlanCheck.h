@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Checks the autoplayer's PlanModel against the game it stands in for. A
+// greedy bot plays a one-player World for `minutes`; every few game
+// minutes the World is forked and run a full planning horizon ahead with
+// no further actions, while the PlanModel advances its own observation of
+// the same moment by the same time. Both are valued at the prices the
+// World ended on, since the plan holds prices by design. Prints the
+// predicted and actual net worth and money of every fork; returns false if
+// any prediction misses by more than 1%.
+bool RunPlanCheck(float minutes, uint64_t seed);
@@ -0,0 +1,152 @@
+#include "Protocol.h"
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+namespace
+{
+    // Lets GameCommand::Read and Write work on frame bytes in place
+    class ByteStreamBuffer : public std::streambuf
+    {
+    public:
+        ByteStreamBuffer(const uint8_t *data, size_t size)
+        {
+            char *begin = const_cast<char *>(reinterpret_cast<const char *>(data));
+            setg(begin, begin, begin + size);
+        }
+
+        size_t GetRemaining() const { return static_cast<size_t>(egptr() - gptr()); }
+    };
+
+    class VectorStreamBuffer : public std::streambuf
+    {
+    public:
+        explicit VectorStreamBuffer(std::vector<uint8_t> &out) : m_out(out) {}
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (c != traits_type::eof())
+                m_out.push_back(static_cast<uint8_t>(c));
+            return c;
+        }
+
+        std::streamsize xsputn(const char *data, std::streamsize size) override
+        {
+            m_out.insert(m_out.end(), data, data + size);
+            return size;
+        }
+
+    private:
+        std::vector<uint8_t> &m_out;
+    };
+}
+
+namespace Protocol
+{
+    size_t Writer::BeginFrame(MessageType type)
+    {
+        size_t frame = m_out.size();
+        U32(0);
+        U8(static_cast<uint8_t>(type));
+        return frame;
+    }
+
+    void Writer::EndFrame(size_t frame)
+    {
+        uint32_t length = static_cast<uint32_t>(m_out.size() - frame - sizeof(uint32_t));
+        std::memcpy(m_out.data() + frame, &length, sizeof(length));
+    }
+
+    long PeekFrame(const uint8_t *data, size_t size)
+    {
+        if (size < HEADER_SIZE)
+            return 0;
+        uint32_t length = 0;
+        std::memcpy(&length, data, sizeof(length));
+        if (length < 1 || length > MAX_FRAME)
+            return -1;
+        size_t total = sizeof(uint32_t) + length;
+        return size < total ? 0 : static_cast<long>(total);
+    }
+
+    void WriteHello(std::vector<uint8_t> &out, uint32_t player, uint64_t token)
+    {
+        Writer writer(out);
+        size_t frame = writer.BeginFrame(MessageType::HELLO);
+        writer.U32(player);
+        writer.U64(token);
+        writer.EndFrame(frame);
+    }
+
+    void WriteCommand(std::vector<uint8_t> &out, const GameCommand &command)
+    {
+        Writer writer(out);
+        size_t frame = writer.BeginFrame(MessageType::COMMAND);
+        VectorStreamBuffer buffer(out);
+        std::ostream stream(&buffer);
+        command.Write(stream);
+        writer.EndFrame(frame);
+    }
+
+    void WriteAck(std::vector<uint8_t> &out, uint64_t tick)
+    {
+        Writer writer(out);
+        size_t frame = writer.BeginFrame(MessageType::ACK);
+        writer.U64(tick);
+        writer.EndFrame(frame);
+    }
+
+    void WriteWelcome(std::vector<uint8_t> &out, uint32_t player, uint64_t tick, uint64_t token)
+    {
+        Writer writer(out);
+        size_t frame = writer.BeginFrame(MessageType::WELCOME);
+        writer.U32(player);
+        writer.U64(tick);
+        writer.U64(token);
+        writer.EndFrame(frame);
+    }
+
+    void WriteDelta(std::vector<uint8_t> &out, const PlayerSnapshot *baseline, const PlayerSnapshot &current)
+    {
+        Writer writer(out);
+        size_t frame = writer.BeginFrame(MessageType::DELTA);
+        writer.U64(current.tick);
+        writer.U64(baseline ? baseline->tick : SnapshotHistory::NONE);
+        BitWriter bits(out);
+        SnapshotDelta::Encode(baseline, current, bits);
+        bits.Flush();
+        writer.EndFrame(frame);
+    }
+
+    bool ReadCommand(const uint8_t *data, size_t size, GameCommand &command)
+    {
+        ByteStreamBuffer buffer(data, size);
+        std::istream stream(&buffer);
+        return command.Read(stream) && buffer.GetRemaining() == 0;
+    }
+
+    bool ReadDelta(const uint8_t *data, size_t size, const SnapshotHistory &history,
+                   PlayerSnapshot &snapshot, uint64_t &baselineTick)
+    {
+        constexpr size_t HEADER = 2 * sizeof(uint64_t);
+
+        Reader reader(data, size);
+        uint64_t tick = reader.U64();
+        baselineTick = reader.U64();
+        if (reader.Failed())
+            return false;
+
+        const PlayerSnapshot *baseline = nullptr;
+        if (baselineTick != SnapshotHistory::NONE)
+        {
+            baseline = history.Find(baselineTick);
+            if (!baseline)
+                return false;
+        }
+
+        BitReader bits(data + HEADER, size - HEADER);
+        snapshot.tick = tick;
+        return SnapshotDelta::Decode(baseline, bits, snapshot) && bits.AtEnd();
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "../GameCommand.h"
+#include "SnapshotDelta.h"
+
+// Wire format between tycoon_server and its clients. Every message is a
+// frame: u32 length of what follows, u8 message type, then the payload.
+// Numbers are little-endian, floats IEEE 754.
+//
+// Client to server:
+//   HELLO    u32 player to take back, or NEW_PLAYER for a new one, then
+//            u64 the reconnect token its WELCOME carried (0 for a new one)
+//   COMMAND  one GameCommand record (GameCommand::Write)
+//   ACK      u64 tick of the newest snapshot the client has rebuilt
+// Server to client:
+//   WELCOME  u32 player, u64 tick, u64 reconnect token
+//   DELTA    u64 tick, u64 baseline tick (SnapshotHistory::NONE for a full
+//            snapshot), then the bit-packed SnapshotDelta
+//
+// A seat belongs to one connection at a time: HELLO for a bot's seat, for
+// a seat another connection holds or with the wrong token is refused by
+// closing the connection.
+//
+// Deltas are taken against the last snapshot the client acknowledged, so
+// the client keeps every snapshot newer than that one around. Ticks where
+// nothing changed since the last delta send nothing.
+namespace Protocol
+{
+    constexpr uint16_t DEFAULT_PORT = 27960;
+    constexpr uint32_t NEW_PLAYER = 0xFFFFFFFFu;
+    constexpr size_t HEADER_SIZE = 5;
+    constexpr uint32_t MAX_FRAME = 1024 * 1024;
+
+    enum class MessageType : uint8_t
+    {
+        HELLO = 1,
+        COMMAND = 2,
+        WELCOME = 3,
+        DELTA = 4,
+        ACK = 5
+    };
+
+    // Published by the simulation after every tick
+    struct WorldView
+    {
+        uint64_t tick = 0;
+        std::vector<PlayerSnapshot> players;
+    };
+
+    // Appends to a byte buffer
+    class Writer
+    {
+    public:
+        explicit Writer(std::vector<uint8_t> &out) : m_out(out) {}
+
+        void U8(uint8_t value) { m_out.push_back(value); }
+        void U16(uint16_t value) { Raw(&value, sizeof(value)); }
+        void U32(uint32_t value) { Raw(&value, sizeof(value)); }
+        void U64(uint64_t value) { Raw(&value, sizeof(value)); }
+        void I32(int32_t value) { Raw(&value, sizeof(value)); }
+        void F32(float value) { Raw(&value, sizeof(value)); }
+
+        // Opens a frame; EndFrame() fills in its length
+        size_t BeginFrame(MessageType type);
+        void EndFrame(size_t frame);
+
+        size_t GetSize() const { return m_out.size(); }
+        void Truncate(size_t size) { m_out.resize(size); }
+
+    private:
+        void Raw(const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            m_out.insert(m_out.end(), bytes, bytes + size);
+        }
+
+        std::vector<uint8_t> &m_out;
+    };
+
+    // Reads a byte range; any read past the end sets the failed flag and
+    // returns zero, so a message is parsed first and checked once
+    class Reader
+    {
+    public:
+        Reader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+        uint8_t U8() { uint8_t value = 0; Raw(&value, sizeof(value)); return value; }
+        uint16_t U16() { uint16_t value = 0; Raw(&value, sizeof(value)); return value; }
+        uint32_t U32() { uint32_t value = 0; Raw(&value, sizeof(value)); return value; }
+        uint64_t U64() { uint64_t value = 0; Raw(&value, sizeof(value)); return value; }
+        int32_t I32() { int32_t value = 0; Raw(&value, sizeof(value)); return value; }
+        float F32() { float value = 0.0f; Raw(&value, sizeof(value)); return value; }
+
+        bool Failed() const { return m_failed; }
+        bool AtEnd() const { return m_offset == m_size; }
+
+    private:
+        void Raw(void *data, size_t size)
+        {
+            if (m_failed || m_size - m_offset < size)
+            {
+                m_failed = true;
+                return;
+            }
+            std::memcpy(data, m_data + m_offset, size);
+            m_offset += size;
+        }
+
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_offset = 0;
+        bool m_failed = false;
+    };
+
+    // Length of the first complete frame in [data, data + size), 0 when it
+    // hasn't fully arrived yet, or -1 when the header is invalid
+    long PeekFrame(const uint8_t *data, size_t size);
+
+    void WriteHello(std::vector<uint8_t> &out, uint32_t player, uint64_t token = 0);
+    void WriteCommand(std::vector<uint8_t> &out, const GameCommand &command);
+    void WriteAck(std::vector<uint8_t> &out, uint64_t tick);
+    void WriteWelcome(std::vector<uint8_t> &out, uint32_t player, uint64_t tick, uint64_t token);
+    // Takes the client from `baseline` (nullptr: from nothing) to `current`
+    void WriteDelta(std::vector<uint8_t> &out, const PlayerSnapshot *baseline, const PlayerSnapshot &current);
+
+    // Payload parsers (the frame header already stripped); false on a
+    // malformed message, leaving the output in an unspecified state
+    bool ReadCommand(const uint8_t *data, size_t size, GameCommand &command);
+    // Rebuilds the snapshot from its baseline in `history`; also false when
+    // that baseline is not there. Snapshots older than the baseline will
+    // not be referred to again.
+    bool ReadDelta(const uint8_t *data, size_t size, const SnapshotHistory &history,
+                   PlayerSnapshot &snapshot, uint64_t &baselineTick);
+}
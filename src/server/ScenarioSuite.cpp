@@ -0,0 +1,31 @@
+#include "ScenarioSuite.h"
+#include <cstdio>
+#include "../Scenario.h"
+#include "../World.h"
+
+bool RunScenarios(const std::vector<std::string> &files)
+{
+    size_t passed = 0;
+    for (const auto &file : files)
+    {
+        Scenario scenario;
+        if (!scenario.Load(file))
+        {
+            printf("FAIL %s (not loaded)\n", file.c_str());
+            continue;
+        }
+
+        auto world = scenario.CreateWorld();
+        ScenarioResult result = scenario.Run(*world);
+        const double speed = result.seconds > 0.0 ? scenario.GetDuration() / result.seconds : 0.0;
+        printf("%s %s: %zu checks, %llu ticks in %.2f s (%.0fx real time)\n",
+               result.passed ? "PASS" : "FAIL", file.c_str(), result.checks,
+               static_cast<unsigned long long>(result.ticks), result.seconds, speed);
+        for (const auto &failure : result.failures)
+            printf("  %s\n", failure.c_str());
+        passed += result.passed ? 1 : 0;
+    }
+
+    printf("%zu of %zu scenarios passed\n", passed, files.size());
+    return passed == files.size();
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Regression suite: plays every scenario file at full speed and prints a
+// line per scenario with its checks and speed, plus each failed
+// expectation. Returns false if any file fails to parse or any check fails.
+bool RunScenarios(const std::vector<std::string> &files);
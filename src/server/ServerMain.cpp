@@ -0,0 +1,153 @@
+// tycoon_server: hosts a World and serves it over the local socket protocol
+//
+//   tycoon_server [--endpoint <port | unix:path>] [--seed <n>] [--bots <n>]
+//   tycoon_server --bench-deltas <buildings> [--ticks <n>]
+//   tycoon_server --bench-state <forks> [--ticks <n>] [--seed <n>] [--scenario <file>]
+//   tycoon_server --scenario <file> [--scenario <file> ...]
+//   tycoon_server --check-kernels <max count>
+//   tycoon_server --bench-markets <ticks>
+//   tycoon_server --bench-ledger <ticks>
+//   tycoon_server --autoplay <minutes> [--bots <n>] [--iterations <n>] [--seed <n>]
+//   tycoon_server --check-plan <minutes> [--seed <n>]
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "AutoplayHarness.h"
+#include "DeltaBenchmark.h"
+#include "GameServer.h"
+#include "KernelCheck.h"
+#include "LedgerBenchmark.h"
+#include "MarketModelBenchmark.h"
+#include "PlanCheck.h"
+#include "ScenarioSuite.h"
+#include "StateBenchmark.h"
+#include "../Scenario.h"
+
+namespace
+{
+    // Most connections a single server expects; the descriptor limit is
+    // raised to fit them
+    constexpr size_t MAX_CONNECTIONS = 16384;
+
+    // Bots in the autoplay harness unless --bots says otherwise
+    constexpr size_t DEFAULT_HARNESS_BOTS = 8;
+
+    GameServer *g_server = nullptr;
+
+    void HandleSignal(int)
+    {
+        if (g_server)
+            g_server->Stop();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string endpoint = std::to_string(Protocol::DEFAULT_PORT);
+    uint64_t seed = 1;
+    size_t benchBuildings = 0;
+    size_t benchTicks = 600;
+    size_t benchForks = 0;
+    size_t kernelCount = 0;
+    size_t marketTicks = 0;
+    size_t ledgerTicks = 0;
+    size_t bots = 0;
+    bool botsGiven = false;
+    float autoplayMinutes = 0.0f;
+    float planMinutes = 0.0f;
+    size_t iterations = AutoPlayerSettings().iterations;
+    std::vector<std::string> scenarios;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--endpoint") == 0)
+            endpoint = argv[i + 1];
+        else if (std::strcmp(argv[i], "--seed") == 0)
+            seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--bench-deltas") == 0)
+            benchBuildings = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--bench-state") == 0)
+            benchForks = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--check-kernels") == 0)
+            kernelCount = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--bench-markets") == 0)
+            marketTicks = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--bench-ledger") == 0)
+            ledgerTicks = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--ticks") == 0)
+            benchTicks = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--bots") == 0)
+        {
+            bots = std::strtoul(argv[i + 1], nullptr, 10);
+            botsGiven = true;
+        }
+        else if (std::strcmp(argv[i], "--autoplay") == 0)
+            autoplayMinutes = std::strtof(argv[i + 1], nullptr);
+        else if (std::strcmp(argv[i], "--check-plan") == 0)
+            planMinutes = std::strtof(argv[i + 1], nullptr);
+        else if (std::strcmp(argv[i], "--iterations") == 0)
+            iterations = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--scenario") == 0)
+            scenarios.push_back(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (benchBuildings > 0)
+        return RunDeltaBenchmark(benchBuildings, benchTicks) ? 0 : 1;
+    if (kernelCount > 0)
+        return RunKernelCheck(kernelCount) ? 0 : 1;
+    if (marketTicks > 0)
+        return RunMarketModelBenchmark(marketTicks) ? 0 : 1;
+    if (ledgerTicks > 0)
+        return RunLedgerBenchmark(ledgerTicks) ? 0 : 1;
+    if (benchForks > 0)
+    {
+        // The first scenario, if any, sets up the game that gets forked
+        Scenario warmup;
+        if (!scenarios.empty() && !warmup.Load(scenarios.front()))
+            return 1;
+        return RunStateBenchmark(benchForks, benchTicks, seed, scenarios.empty() ? nullptr : &warmup) ? 0 : 1;
+    }
+    if (!scenarios.empty())
+        return RunScenarios(scenarios) ? 0 : 1;
+    if (autoplayMinutes > 0.0f)
+        return RunAutoplayHarness(botsGiven ? bots : DEFAULT_HARNESS_BOTS, autoplayMinutes, iterations, seed) ? 0 : 1;
+    if (planMinutes > 0.0f)
+        return RunPlanCheck(planMinutes, seed) ? 0 : 1;
+
+    if (!Net::Startup())
+    {
+        fprintf(stderr, "Error starting sockets\n");
+        return 1;
+    }
+    Net::RaiseDescriptorLimit(MAX_CONNECTIONS + 64);
+
+    int result = 0;
+    {
+        GameServer server(seed, bots);
+        if (server.Listen(endpoint))
+        {
+            g_server = &server;
+            std::signal(SIGINT, HandleSignal);
+            std::signal(SIGTERM, HandleSignal);
+            printf("Serving on %s\n", endpoint.c_str());
+            fflush(stdout);
+            server.Run();
+            g_server = nullptr;
+        }
+        else
+        {
+            fprintf(stderr, "Error listening on %s\n", endpoint.c_str());
+            result = 1;
+        }
+    }
+
+    Net::Shutdown();
+    return result;
+}
@@ -0,0 +1,202 @@
+#include "SnapshotDelta.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Widths of the length fields in front of sized values
+    constexpr int AMOUNT_LENGTH_BITS = 6;     // XOR of 32 float bits
+    constexpr int PRICE_LENGTH_BITS = 6;      // zigzagged int32 differences
+    constexpr int REPUTATION_LENGTH_BITS = 6;
+    constexpr int COUNT_LENGTH_BITS = 5;      // building counts and gaps, up to 16 bits
+    constexpr int LEVEL_LENGTH_BITS = 4;      // zigzagged uint8 differences
+    constexpr int EFFICIENCY_LENGTH_BITS = 5; // zigzagged uint16 differences
+
+    constexpr int BUILDING_COUNT_BITS = 16;
+    constexpr int FLAG_BITS = 2;
+    constexpr int PRIORITY_BITS = 8;
+
+    // Which fields of a listed building follow
+    constexpr uint32_t FIELD_LEVEL = 1;
+    constexpr uint32_t FIELD_FLAGS = 2;
+    constexpr uint32_t FIELD_PRIORITY = 4;
+    constexpr uint32_t FIELD_EFFICIENCY = 8;
+    constexpr int FIELD_BITS = 4;
+
+    const PlayerSnapshot EMPTY_SNAPSHOT;
+}
+
+void PlayerSnapshot::SetAmount(ResourceType type, float amount)
+{
+    std::memcpy(&amounts[static_cast<size_t>(type)], &amount, sizeof(amount));
+}
+
+float PlayerSnapshot::GetAmount(ResourceType type) const
+{
+    float amount;
+    std::memcpy(&amount, &amounts[static_cast<size_t>(type)], sizeof(amount));
+    return amount;
+}
+
+void PlayerSnapshot::SetPrice(ResourceType type, float price)
+{
+    prices[static_cast<size_t>(type)] = static_cast<int32_t>(std::lround(price / PRICE_STEP));
+}
+
+uint16_t PlayerSnapshot::QuantizeEfficiency(float efficiency)
+{
+    long steps = std::lround(efficiency * EFFICIENCY_STEPS);
+    return static_cast<uint16_t>(std::clamp(steps, 0L, 65535L));
+}
+
+bool PlayerSnapshot::SameState(const PlayerSnapshot &other) const
+{
+    return amounts == other.amounts && prices == other.prices &&
+           reputation == other.reputation && buildings == other.buildings;
+}
+
+namespace SnapshotDelta
+{
+    void Encode(const PlayerSnapshot *baseline, const PlayerSnapshot &current, BitWriter &out)
+    {
+        const PlayerSnapshot &base = baseline ? *baseline : EMPTY_SNAPSHOT;
+
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            uint32_t difference = current.amounts[r] ^ base.amounts[r];
+            out.WriteBit(difference != 0);
+            if (difference != 0)
+                out.WriteSized(difference, AMOUNT_LENGTH_BITS);
+        }
+
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+        {
+            int64_t difference = static_cast<int64_t>(current.prices[r]) - base.prices[r];
+            out.WriteBit(difference != 0);
+            if (difference != 0)
+                out.WriteSignedSized(difference, PRICE_LENGTH_BITS);
+        }
+
+        int64_t reputationChange = static_cast<int64_t>(current.reputation) - base.reputation;
+        out.WriteBit(reputationChange != 0);
+        if (reputationChange != 0)
+            out.WriteSignedSized(reputationChange, REPUTATION_LENGTH_BITS);
+
+        // Buildings past the end of the baseline are coded against zeros
+        const size_t count = std::min<size_t>(current.buildings.size(), UINT16_MAX);
+        const bool resized = count != base.buildings.size();
+        out.WriteBit(resized);
+        if (resized)
+            out.Write(count, BUILDING_COUNT_BITS);
+
+        static const PlayerSnapshot::Building NONE;
+        auto baseBuilding = [&](size_t i) -> const PlayerSnapshot::Building &
+        {
+            return i < base.buildings.size() ? base.buildings[i] : NONE;
+        };
+
+        size_t changed = 0;
+        for (size_t i = 0; i < count; ++i)
+            changed += current.buildings[i] != baseBuilding(i) ? 1 : 0;
+        out.WriteSized(changed, COUNT_LENGTH_BITS);
+
+        size_t next = 0; // first index the next gap counts from
+        for (size_t i = 0; i < count && changed > 0; ++i)
+        {
+            const PlayerSnapshot::Building &now = current.buildings[i];
+            const PlayerSnapshot::Building &was = baseBuilding(i);
+            if (now == was)
+                continue;
+
+            out.WriteSized(i - next, COUNT_LENGTH_BITS);
+            next = i + 1;
+            --changed;
+
+            uint32_t fields = (now.level != was.level ? FIELD_LEVEL : 0) |
+                              (now.flags != was.flags ? FIELD_FLAGS : 0) |
+                              (now.priority != was.priority ? FIELD_PRIORITY : 0) |
+                              (now.efficiency != was.efficiency ? FIELD_EFFICIENCY : 0);
+            out.Write(fields, FIELD_BITS);
+            if (fields & FIELD_LEVEL)
+                out.WriteSignedSized(static_cast<int64_t>(now.level) - was.level, LEVEL_LENGTH_BITS);
+            if (fields & FIELD_FLAGS)
+                out.Write(now.flags, FLAG_BITS);
+            if (fields & FIELD_PRIORITY)
+                out.Write(now.priority, PRIORITY_BITS);
+            if (fields & FIELD_EFFICIENCY)
+                out.WriteSignedSized(static_cast<int64_t>(now.efficiency) - was.efficiency, EFFICIENCY_LENGTH_BITS);
+        }
+    }
+
+    bool Decode(const PlayerSnapshot *baseline, BitReader &in, PlayerSnapshot &current)
+    {
+        const PlayerSnapshot &base = baseline ? *baseline : EMPTY_SNAPSHOT;
+        if (&current != &base)
+        {
+            current.amounts = base.amounts;
+            current.prices = base.prices;
+            current.reputation = base.reputation;
+            current.buildings = base.buildings;
+        }
+
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            if (in.ReadBit())
+                current.amounts[r] ^= static_cast<uint32_t>(in.ReadSized(AMOUNT_LENGTH_BITS));
+
+        for (size_t r = 0; r < RESOURCE_TYPE_COUNT; ++r)
+            if (in.ReadBit())
+                current.prices[r] = static_cast<int32_t>(current.prices[r] + in.ReadSignedSized(PRICE_LENGTH_BITS));
+
+        if (in.ReadBit())
+            current.reputation = static_cast<int32_t>(current.reputation + in.ReadSignedSized(REPUTATION_LENGTH_BITS));
+
+        if (in.ReadBit())
+            current.buildings.resize(static_cast<size_t>(in.Read(BUILDING_COUNT_BITS)));
+
+        size_t changed = static_cast<size_t>(in.ReadSized(COUNT_LENGTH_BITS));
+        size_t next = 0;
+        for (size_t k = 0; k < changed && !in.Failed(); ++k)
+        {
+            size_t i = next + static_cast<size_t>(in.ReadSized(COUNT_LENGTH_BITS));
+            if (i >= current.buildings.size())
+                return false;
+            next = i + 1;
+
+            PlayerSnapshot::Building &building = current.buildings[i];
+            uint32_t fields = static_cast<uint32_t>(in.Read(FIELD_BITS));
+            if (fields & FIELD_LEVEL)
+                building.level = static_cast<uint8_t>(building.level + in.ReadSignedSized(LEVEL_LENGTH_BITS));
+            if (fields & FIELD_FLAGS)
+                building.flags = static_cast<uint8_t>(in.Read(FLAG_BITS));
+            if (fields & FIELD_PRIORITY)
+                building.priority = static_cast<uint8_t>(in.Read(PRIORITY_BITS));
+            if (fields & FIELD_EFFICIENCY)
+                building.efficiency = static_cast<uint16_t>(building.efficiency + in.ReadSignedSized(EFFICIENCY_LENGTH_BITS));
+        }
+        return !in.Failed();
+    }
+}
+
+const PlayerSnapshot *SnapshotHistory::Find(uint64_t tick) const
+{
+    for (auto it = m_snapshots.rbegin(); it != m_snapshots.rend(); ++it)
+    {
+        if (it->tick == tick)
+            return &*it;
+        if (it->tick < tick)
+            break;
+    }
+    return nullptr;
+}
+
+void SnapshotHistory::Push(const PlayerSnapshot &snapshot)
+{
+    m_snapshots.push_back(snapshot);
+}
+
+void SnapshotHistory::DropBefore(uint64_t tick)
+{
+    while (!m_snapshots.empty() && m_snapshots.front().tick < tick)
+        m_snapshots.pop_front();
+}
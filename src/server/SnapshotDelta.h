@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "../Resource.h"
+#include "BitStream.h"
+
+// One player as a client sees it, already quantised: resource amounts keep
+// their exact float bits, prices are whole PRICE_STEPs and efficiencies
+// whole EFFICIENCY_STEPs. Changes smaller than a step are not news.
+struct PlayerSnapshot
+{
+    static constexpr float PRICE_STEP = 0.01f;
+    static constexpr int EFFICIENCY_STEPS = 1024; // per 1.0
+
+    struct Building
+    {
+        // Flag bits
+        static constexpr uint8_t OWNED = 1;
+        static constexpr uint8_t OPERATIONAL = 2;
+
+        uint8_t level = 0;
+        uint8_t flags = 0;
+        uint8_t priority = 0;
+        uint16_t efficiency = 0;
+
+        bool operator==(const Building &other) const
+        {
+            return level == other.level && flags == other.flags &&
+                   priority == other.priority && efficiency == other.efficiency;
+        }
+        bool operator!=(const Building &other) const { return !(*this == other); }
+    };
+
+    uint64_t tick = 0;
+    std::array<uint32_t, RESOURCE_TYPE_COUNT> amounts{};
+    std::array<int32_t, RESOURCE_TYPE_COUNT> prices{};
+    int32_t reputation = 0;
+    std::vector<Building> buildings;
+
+    void SetAmount(ResourceType type, float amount);
+    float GetAmount(ResourceType type) const;
+    void SetPrice(ResourceType type, float price);
+    float GetPrice(ResourceType type) const { return prices[static_cast<size_t>(type)] * PRICE_STEP; }
+    static uint16_t QuantizeEfficiency(float efficiency);
+    float GetEfficiency(size_t building) const { return static_cast<float>(buildings[building].efficiency) / EFFICIENCY_STEPS; }
+
+    // Equal state, whatever the ticks
+    bool SameState(const PlayerSnapshot &other) const;
+};
+
+// Bit-packed difference between two snapshots of one player. Every field
+// is coded against the same field of the baseline the client already has:
+// a change bit, then amounts as the XOR of the float bits (nearby values
+// share their high bits), the rest as sized, zigzagged differences. Only
+// changed buildings are listed, by the gap to the previous one.
+namespace SnapshotDelta
+{
+    // Appends the delta from `baseline` (nullptr: from an empty snapshot,
+    // i.e. everything) to `current`; the caller flushes the writer
+    void Encode(const PlayerSnapshot *baseline, const PlayerSnapshot &current, BitWriter &out);
+
+    // Rebuilds `current` from the same baseline plus the delta; false on a
+    // malformed delta
+    bool Decode(const PlayerSnapshot *baseline, BitReader &in, PlayerSnapshot &current);
+}
+
+// Recent snapshots of one player, oldest first. The server keeps the ones
+// it has sent but not yet seen acknowledged; a client keeps the ones it
+// has received, as any of them may come back as a baseline.
+class SnapshotHistory
+{
+public:
+    static constexpr uint64_t NONE = ~uint64_t(0);
+
+    const PlayerSnapshot *Find(uint64_t tick) const;
+    const PlayerSnapshot *GetLatest() const { return m_snapshots.empty() ? nullptr : &m_snapshots.back(); }
+    size_t GetCount() const { return m_snapshots.size(); }
+
+    // Ticks must increase
+    void Push(const PlayerSnapshot &snapshot);
+
+    // Forgets everything older than `tick`
+    void DropBefore(uint64_t tick);
+    void Clear() { m_snapshots.clear(); }
+
+private:
+    std::deque<PlayerSnapshot> m_snapshots;
+};
@@ -0,0 +1,99 @@
+#include "StateBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "../AutoPlayer.h"
+#include "../GameConstants.h"
+#include "../Scenario.h"
+#include "../World.h"
+
+namespace
+{
+    constexpr float WARMUP_SECONDS = 1200.0f; // greedy play before the fork
+    constexpr size_t COPIES = 8;              // forks kept alive at once
+
+    // Zeroed first so padding compares equal too
+    std::unique_ptr<GameState> Save(const World &world)
+    {
+        auto state = std::make_unique<GameState>();
+        std::memset(static_cast<void *>(state.get()), 0, sizeof(GameState));
+        return world.SaveState(0, *state) ? std::move(state) : nullptr;
+    }
+}
+
+bool RunStateBenchmark(size_t forks, size_t ticks, uint64_t seed, const Scenario *scenario)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_ptr<World> played = scenario ? scenario->CreateWorld() : std::make_unique<World>(seed);
+    World &world = *played;
+    if (scenario)
+    {
+        scenario->Run(world);
+    }
+    else
+    {
+        world.AddPlayer("Benchmark");
+        AutoPlayer planner;
+        std::vector<GameCommand> commands;
+        const uint64_t decisionTicks = std::max<uint64_t>(1, std::lround(planner.GetSettings().decisionInterval / GameConstants::SIMULATION_TICK));
+        const uint64_t warmupTicks = static_cast<uint64_t>(std::lround(WARMUP_SECONDS / GameConstants::SIMULATION_TICK));
+        for (uint64_t t = 0; t < warmupTicks; ++t)
+        {
+            if (t % decisionTicks == 0)
+            {
+                commands.clear();
+                planner.Decide(world.GetPlayer(0), world.GetMarket(), commands);
+                for (const auto &command : commands)
+                    world.Apply(0, command);
+            }
+            world.Update(GameConstants::SIMULATION_TICK);
+        }
+    }
+
+    std::unique_ptr<GameState> original = Save(world);
+    if (!original)
+    {
+        fprintf(stderr, "Player does not fit a GameState\n");
+        return false;
+    }
+    const Player &player = world.GetPlayer(0);
+    printf("%zu bytes per GameState, %zu buildings, %zu jobs after %.0f game minutes\n",
+           sizeof(GameState), player.buildings.size(), player.jobs.GetJobCount(), world.GetTime() / 60.0f);
+
+    auto state = std::make_unique<GameState>();
+    std::vector<GameState> copies(COPIES);
+    World fork(original->marketSeed);
+    fork.AddPlayer("Fork");
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < forks; ++i)
+        world.SaveState(0, *state);
+    auto saved = Clock::now();
+    for (size_t i = 0; i < forks; ++i)
+        copies[i % COPIES] = *state;
+    auto copied = Clock::now();
+    for (size_t i = 0; i < forks; ++i)
+        fork.LoadState(0, copies[i % COPIES]);
+    auto loaded = Clock::now();
+
+    auto perFork = [forks](Clock::duration elapsed) { return std::chrono::duration<double>(elapsed).count() / forks * 1e6; };
+    printf("  %-6s %10.2f us\n", "save", perFork(saved - start));
+    printf("  %-6s %10.2f us\n", "copy", perFork(copied - saved));
+    printf("  %-6s %10.2f us\n", "load", perFork(loaded - copied));
+
+    for (size_t t = 0; t < ticks; ++t)
+    {
+        world.Update(GameConstants::SIMULATION_TICK);
+        fork.Update(GameConstants::SIMULATION_TICK);
+    }
+    std::unique_ptr<GameState> ran = Save(world);
+    std::unique_ptr<GameState> forked = Save(fork);
+    const bool exact = ran && forked && std::memcmp(ran.get(), forked.get(), sizeof(GameState)) == 0;
+    printf("%s after %zu ticks\n", exact ? "Fork and original agree exactly" : "MISMATCH between fork and original", ticks);
+    return exact;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class Scenario;
+
+// Plays one greedy player for a while, or the scenario when given, then
+// measures how fast its GameState is saved, copied and loaded, `forks`
+// times each. A World loaded from the copy and the original then run
+// `ticks` more ticks side by side and must end in the same state. Prints
+// the results; returns false on a mismatch.
+bool RunStateBenchmark(size_t forks, size_t ticks, uint64_t seed, const Scenario *scenario = nullptr);